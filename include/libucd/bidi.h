@@ -0,0 +1,132 @@
+/*
+ * libucd - Unicode database library
+ *
+ * Copyright (c) 2015 Alastair Houghton
+ *
+ */
+
+#ifndef LIBUCD_BIDI_H_
+#define LIBUCD_BIDI_H_
+
+#include <cstddef>
+#include <cinttypes>
+#include <vector>
+
+#include "types.h"
+#include "text.h"
+
+namespace ucd {
+
+  class database;
+
+  /* Runs the Unicode Bidirectional Algorithm (UAX #9) over a paragraph of
+     text.  resolve() works out the embedding level of each code point
+     (rules P2 to I2); reorder() then applies rules L1 and L2 to a line,
+     giving the order in which the code points should be displayed.
+     Mirroring (L4) is left to the caller; see bidi_mirroring_glyph().
+
+     Splitting text into paragraphs (P1) is also up to you.  Everything is
+     indexed by code point; offset() maps a code point index back to an
+     offset in the text, in code units.
+
+     The workspace keeps its buffers between calls, so once it has seen a
+     paragraph as long as the one you give it, it won't allocate. */
+  class bidi_workspace {
+  public:
+    static const size_t npos = size_t(-1);
+
+    enum class direction {
+      ltr,
+      rtl,
+      automatic         // From the first strong character, else ltr
+    };
+
+    // The deepest embedding level allowed (BD2)
+    static const unsigned max_depth = 125;
+
+  private:
+    struct status {
+      uint8_t level;
+      uint8_t override_class;
+      bool    isolate;
+    };
+
+    struct bracket {
+      codepoint closing;
+      size_t    pos;
+    };
+
+    struct bracket_pair {
+      size_t open, close;
+
+      bool operator<(const bracket_pair &other) const {
+        return open < other.open;
+      }
+    };
+
+    struct level_run {
+      size_t first, last;
+    };
+
+    const database           &_db;
+    unsigned                  _paragraph_level;
+
+    std::vector<codepoint>    _cps;
+    std::vector<size_t>       _offsets;
+    std::vector<uint8_t>      _classes;
+    std::vector<uint8_t>      _types;
+    std::vector<uint8_t>      _levels;
+    std::vector<size_t>       _matching;
+    std::vector<size_t>       _kept;
+    std::vector<level_run>    _runs;
+    std::vector<size_t>       _sequence;
+    std::vector<bracket>      _openers;
+    std::vector<bracket_pair> _pairs;
+    std::vector<size_t>       _order;
+    std::vector<uint8_t>      _line_levels;
+
+    status                    _stack[max_depth + 2];
+
+    template <class Codec> void decode(const text &txt, bool classify);
+    void match_isolates();
+    int first_strong(size_t begin, size_t end) const;
+    void resolve_explicit();
+    void resolve_sequences();
+    void resolve_weak(unsigned sos);
+    void resolve_brackets(unsigned sos, unsigned level);
+    void resolve_neutral(unsigned sos, unsigned eos, unsigned level);
+    void resolve_implicit();
+
+  public:
+    explicit bidi_workspace(const database &db);
+
+    void resolve(const text &txt, direction dir = direction::automatic);
+
+    // The number of code points in the paragraph
+    size_t size() const { return _cps.size(); }
+
+    // The offset of code point n (or the length of the text, for size())
+    size_t offset(size_t n) const { return _offsets[n]; }
+
+    unsigned paragraph_level() const { return _paragraph_level; }
+
+    // The resolved embedding level of each code point
+    const uint8_t *levels() const { return _levels.data(); }
+
+    /* Reorders the line made up of code points first to last - 1, returning
+       the index of the code point to display at each position, from left
+       to right.  line_levels() gives the levels of the line after L1. */
+    const size_t *reorder(size_t first = 0, size_t last = npos);
+    const uint8_t *line_levels() const { return _line_levels.data(); }
+  };
+
+}
+
+#endif /* LIBUCD_BIDI_H_ */
+
+/*
+ * Local Variables:
+ * mode: c++
+ * End:
+ *
+ */
@@ -14,6 +14,11 @@
 #include "numeric.h"
 #include "alias.h"
 #include "stroke_count.h"
+#include "text.h"
+#include "scripts.h"
+#include "emoji.h"
+#include "security.h"
+#include "identifier.h"
 
 #include <vector>
 #include <string>
@@ -102,6 +107,24 @@ namespace ucd {
     nt numeric_type(codepoint cp) const;
     numeric numeric_value(codepoint cp) const;
 
+    /* The value of a decimal digit (Numeric_Type=Decimal) in any script, or
+       -1 if cp isn't one.  The second form also gives you the zero digit
+       from the same set, so you can tell whether two digits match. */
+    int digit_value(codepoint cp) const;
+    int digit_value(codepoint cp, codepoint &zero) const;
+
+    /* The numeric value of cp as a double (NaN if it has none) and as a
+       fraction in lowest terms (0/0 if it has none).  Unlike converting
+       the result of numeric_value(), these are a single table lookup. */
+    double numeric_value_double(codepoint cp) const;
+    rational numeric_value_rational(codepoint cp) const;
+
+    /* Parses an integer written in decimal digits, with an optional ASCII
+       '+' or '-' in front.  The digits can be from any script, but must
+       all be from the same one; returns false if they aren't, if there's
+       anything else in txt, or if the value won't fit. */
+    bool parse_decimal(const text &txt, long long &value) const;
+
     const class block *block(codepoint cp) const;
     const class block *block_from_name(const std::string &name) const;
     const std::vector<class block> &blocks() const;
@@ -122,11 +145,112 @@ namespace ucd {
     cpvector lowercase_mapping(codepoint cp) const;
     cpvector titlecase_mapping(codepoint cp) const;
 
+    /* Full case conversion of strings, as described in section 3.13 of the
+       Unicode Standard; unlike the mappings above, these also apply the
+       context sensitive rules from SpecialCasing.txt (e.g. Final_Sigma).
+       Pass a language code ("lt", "tr" or "az") to enable the language
+       specific rules as well.  Titlecasing titlecases the first cased
+       character of each word and lowercases the rest.
+
+       The buffer versions return the length of the result in code units,
+       but write no more than out_len code units, so you can find out how
+       much space you need by passing nullptr and 0. */
+    size_t to_uppercase(const char *utf8, size_t len,
+                        char *out, size_t out_len,
+                        const char *language = nullptr) const;
+    size_t to_uppercase(const char16_t *utf16, size_t len,
+                        char16_t *out, size_t out_len,
+                        const char *language = nullptr) const;
+    size_t to_uppercase(const char32_t *utf32, size_t len,
+                        char32_t *out, size_t out_len,
+                        const char *language = nullptr) const;
+    size_t to_lowercase(const char *utf8, size_t len,
+                        char *out, size_t out_len,
+                        const char *language = nullptr) const;
+    size_t to_lowercase(const char16_t *utf16, size_t len,
+                        char16_t *out, size_t out_len,
+                        const char *language = nullptr) const;
+    size_t to_lowercase(const char32_t *utf32, size_t len,
+                        char32_t *out, size_t out_len,
+                        const char *language = nullptr) const;
+    size_t to_titlecase(const char *utf8, size_t len,
+                        char *out, size_t out_len,
+                        const char *language = nullptr) const;
+    size_t to_titlecase(const char16_t *utf16, size_t len,
+                        char16_t *out, size_t out_len,
+                        const char *language = nullptr) const;
+    size_t to_titlecase(const char32_t *utf32, size_t len,
+                        char32_t *out, size_t out_len,
+                        const char *language = nullptr) const;
+
+    std::string to_uppercase(const std::string &utf8,
+                             const char *language = nullptr) const;
+    std::u16string to_uppercase(const std::u16string &utf16,
+                                const char *language = nullptr) const;
+    std::u32string to_uppercase(const std::u32string &utf32,
+                                const char *language = nullptr) const;
+    std::string to_lowercase(const std::string &utf8,
+                             const char *language = nullptr) const;
+    std::u16string to_lowercase(const std::u16string &utf16,
+                                const char *language = nullptr) const;
+    std::u32string to_lowercase(const std::u32string &utf32,
+                                const char *language = nullptr) const;
+    std::string to_titlecase(const std::string &utf8,
+                             const char *language = nullptr) const;
+    std::u16string to_titlecase(const std::u16string &utf16,
+                                const char *language = nullptr) const;
+    std::u32string to_titlecase(const std::u32string &utf32,
+                                const char *language = nullptr) const;
+
     codepoint simple_case_folding(codepoint cp) const;
     size_t case_folding(codepoint from_cp,
                         codepoint *out, size_t out_len) const;
     cpvector case_folding(codepoint cp) const;
 
+    /* Apply full case folding to a string.  casefold_compare() and
+       casefold_hash() behave as if they were applied to the results of
+       fold_case(), but don't need to build the folded strings, so they're
+       suitable for implementing case insensitive containers. */
+    size_t fold_case(const char *utf8, size_t len,
+                     char *out, size_t out_len) const;
+    size_t fold_case(const char16_t *utf16, size_t len,
+                     char16_t *out, size_t out_len) const;
+    size_t fold_case(const char32_t *utf32, size_t len,
+                     char32_t *out, size_t out_len) const;
+    std::string fold_case(const std::string &utf8) const;
+    std::u16string fold_case(const std::u16string &utf16) const;
+    std::u32string fold_case(const std::u32string &utf32) const;
+
+    int casefold_compare(const char *a, size_t a_len,
+                         const char *b, size_t b_len) const;
+    int casefold_compare(const char16_t *a, size_t a_len,
+                         const char16_t *b, size_t b_len) const;
+    int casefold_compare(const char32_t *a, size_t a_len,
+                         const char32_t *b, size_t b_len) const;
+    int casefold_compare(const std::string &a, const std::string &b) const;
+    int casefold_compare(const std::u16string &a,
+                         const std::u16string &b) const;
+    int casefold_compare(const std::u32string &a,
+                         const std::u32string &b) const;
+
+    size_t casefold_hash(const char *utf8, size_t len) const;
+    size_t casefold_hash(const char16_t *utf16, size_t len) const;
+    size_t casefold_hash(const char32_t *utf32, size_t len) const;
+    size_t casefold_hash(const std::string &utf8) const;
+    size_t casefold_hash(const std::u16string &utf16) const;
+    size_t casefold_hash(const std::u32string &utf32) const;
+
+    /* Find the code points with the same simple case folding as cp (which
+       includes cp itself), in ascending order.  The cpranges version adds
+       the case closure of every code point in the set to the set; it takes
+       time proportional to the number of cased characters in the set,
+       rather than the size of the ranges.  Files without the case closure
+       table still work, but every call has to scan the case folding
+       table, which is a good deal slower. */
+    size_t case_closure(codepoint cp, codepoint *out, size_t out_len) const;
+    cpvector case_closure(codepoint cp) const;
+    void case_closure(cpranges &ranges) const;
+
     bc bidi_class(codepoint cp) const;
     bool bidi_mirrored(codepoint cp) const;
     codepoint bidi_mirroring_glyph(codepoint cp) const;
@@ -135,6 +259,13 @@ namespace ucd {
     bpt bidi_paired_bracket_type(codepoint cp) const;
     codepoint bidi_paired_bracket(codepoint cp, bpt &type) const;
 
+    /* True if txt contains a strong right-to-left character (R or AL), an
+       Arabic number (AN) or an explicit embedding, override or isolate
+       control.  If it doesn't, the Bidi algorithm will put all of it at
+       level 0 (unless you force the paragraph to be right-to-left), so
+       you needn't run it at all. */
+    bool needs_bidi(const text &txt) const;
+
     dt decomposition_type(codepoint cp) const;
     size_t decomposition_mapping(codepoint cp,
                                  codepoint *out, size_t out_len) const;
@@ -147,12 +278,100 @@ namespace ucd {
     codepoint primary_composite(codepoint starter, codepoint composing) const;
 
     version age(codepoint cp) const;
+
+    /* The newest Age of any assigned code point in txt (version::nil if
+       there are none), and the position of the first code point in txt
+       that wasn't assigned as of Unicode v (txt.length() if there isn't
+       one), so you can reject text that is too new for systems that only
+       support v.  Unassigned code points count as newer than anything.
+       Both make a single pass over the text. */
+    version max_age(const text &txt) const;
+    size_t first_newer_than(const text &txt, const version &v) const;
     sc script(codepoint cp) const;
     std::vector<sc> script_extensions(codepoint cp) const;
 
+    /* As above, but without allocating; points scripts at the list in the
+       database and returns its length (zero if cp has no extensions). */
+    size_t script_extensions(codepoint cp, const sc *&scripts) const;
+
+    /* The Script_Extensions of cp as a script_set; unlike the functions
+       above, if cp has no extensions this gives a set holding its
+       Script. */
+    script_set script_extension_set(codepoint cp) const;
+
+    /* The UTS #39 restriction level of txt, worked out in a single pass
+       from the Script_Extensions of its characters, with Han, Hiragana,
+       Katakana, Hangul and Bopomofo augmented as UTS #39 describes so that
+       Japanese and Korean count as single scripts.  This doesn't check
+       that the characters are in the identifier profile, or that scripts
+       are Recommended, so it never reports Unrestricted; check identifier
+       syntax (e.g. with xid_start() and xid_continue()) separately. */
+    ucd::restriction_level restriction_level(const text &txt) const;
+
+    // The Hidden_Property flags for cp
+    unsigned hidden_properties(codepoint cp) const;
+
+    /* Finds the first code point in txt, at or after pos, that has any of
+       the Hidden_Property flags in mask, returning txt.length() if there
+       isn't one.  Use this to catch bidi controls being used to disguise
+       source code, or invisible characters in user names.  None of ASCII
+       is hidden, so it's skipped a block at a time; anything else takes
+       one lookup. */
+    size_t find_hidden(const text &txt, size_t pos = 0,
+                       unsigned mask = Hidden_Property::all) const;
+
+    /* Copies a string, leaving out any code points that have any of the
+       Hidden_Property flags in mask.  As with nfkc_casefold(), the buffer
+       versions return the full length even if it didn't fit; they also
+       work in place, if out is the same as in. */
+    size_t strip_hidden(const char *utf8, size_t len,
+                        char *out, size_t out_len,
+                        unsigned mask = Hidden_Property::all) const;
+    size_t strip_hidden(const char16_t *utf16, size_t len,
+                        char16_t *out, size_t out_len,
+                        unsigned mask = Hidden_Property::all) const;
+    size_t strip_hidden(const char32_t *utf32, size_t len,
+                        char32_t *out, size_t out_len,
+                        unsigned mask = Hidden_Property::all) const;
+    std::string strip_hidden(const std::string &utf8,
+                             unsigned mask = Hidden_Property::all) const;
+    std::u16string strip_hidden(const std::u16string &utf16,
+                                unsigned mask = Hidden_Property::all) const;
+    std::u32string strip_hidden(const std::u32string &utf32,
+                                unsigned mask = Hidden_Property::all) const;
+
     ea east_asian_width(codepoint cp) const;
+
+    /* The number of terminal columns cp occupies (0, 1 or 2), for use in
+       place of wcwidth().  Ambiguous characters are wide if east_asian is
+       set.  Control characters are zero width, rather than -1. */
+    unsigned display_width(codepoint cp, bool east_asian = false) const;
+
+    /* The display width of a string, for use in place of wcswidth().  This
+       is the sum of the widths of its grapheme clusters; a cluster is as
+       wide as its widest code point, except that a variation selector can
+       make an emoji wide (U+FE0F) or narrow (U+FE0E). */
+    size_t display_width(const text &txt, bool east_asian = false) const;
     stroke_count unicode_radical_stroke(codepoint cp) const;
 
+    /* The reverse of the above: the code points with a given radical and
+       number of residual strokes (e.g. everything with radical 85 and three
+       more strokes), in code point order.  The second form points cps at
+       the list in the database and returns its length, or zero if there
+       are none or the database file is too old to have the index. */
+    std::vector<codepoint>
+    characters_with_radical_stroke(const stroke_count &rs) const;
+    size_t characters_with_radical_stroke(const stroke_count &rs,
+                                          const codepoint *&cps) const;
+
+    /* A key for sorting Han characters in radical-stroke order, as used by
+       CJK dictionaries: by radical, then traditional before simplified
+       radical, then residual strokes, then code point.  Characters without
+       a Unicode_Radical_Stroke value sort after all of those that have
+       one, in code point order.  Compute the keys once, then sort on them
+       rather than looking each character up for every comparison. */
+    uint64_t radical_stroke_sort_key(codepoint cp) const;
+
     InPC indic_positional_category(codepoint cp) const;
     InSC indic_syllabic_category(codepoint cp) const;
 
@@ -174,6 +393,43 @@ namespace ucd {
                          codepoint *out, size_t out_len) const;
     cpvector nfkc_casefold(codepoint cp) const;
 
+    /* toNFKC_Casefold() for strings, which maps each character through
+       NFKC_Casefold and then normalises the result to NFC.  If you don't
+       want to pay for a copy when nothing changes, check the string with
+       is_nfkc_casefolded() first; the std::string versions do this for
+       you.  is_nfkc_casefolded() may return false for some strings that
+       are, in fact, unchanged. */
+    size_t nfkc_casefold(const char *utf8, size_t len,
+                         char *out, size_t out_len) const;
+    size_t nfkc_casefold(const char16_t *utf16, size_t len,
+                         char16_t *out, size_t out_len) const;
+    size_t nfkc_casefold(const char32_t *utf32, size_t len,
+                         char32_t *out, size_t out_len) const;
+    std::string nfkc_casefold(const std::string &utf8) const;
+    std::u16string nfkc_casefold(const std::u16string &utf16) const;
+    std::u32string nfkc_casefold(const std::u32string &utf32) const;
+
+    bool is_nfkc_casefolded(const char *utf8, size_t len) const;
+    bool is_nfkc_casefolded(const char16_t *utf16, size_t len) const;
+    bool is_nfkc_casefolded(const char32_t *utf32, size_t len) const;
+
+    /* The UTS #39 skeleton of a string, which is its NFD with each
+       character replaced by its prototype from confusables.txt, put into
+       NFD again.  Two strings are confusable if their skeletons match.
+       Skeletons are only meant for comparison, not for display.  As with
+       nfkc_casefold(), the buffer versions don't allocate and return the
+       full length even if it didn't fit.  Without confusables data in the
+       database, the skeleton is just the NFD. */
+    size_t skeleton(const char *utf8, size_t len,
+                    char *out, size_t out_len) const;
+    size_t skeleton(const char16_t *utf16, size_t len,
+                    char16_t *out, size_t out_len) const;
+    size_t skeleton(const char32_t *utf32, size_t len,
+                    char32_t *out, size_t out_len) const;
+    std::string skeleton(const std::string &utf8) const;
+    std::u16string skeleton(const std::u16string &utf16) const;
+    std::u32string skeleton(const std::u32string &utf32) const;
+
     size_t fc_nfkc_closure(codepoint cp,
                            codepoint *out, size_t out_len) const;
     cpvector fc_nfkc_closure(codepoint cp) const;
@@ -250,11 +506,39 @@ namespace ucd {
     bool xid_start(codepoint cp) const;
     bool xid_continue(codepoint cp) const;
 
+    /* The length, in code units, of the identifier at the start of the
+       buffer, or zero if it doesn't start with one.  This is the default
+       identifier syntax from UAX #31, except that, as in most programming
+       languages, '_' may also start an identifier.  Runs of ASCII are
+       handled a block at a time, and everything else needs one lookup per
+       code point. */
+    size_t scan_identifier(const char *utf8, size_t len,
+                           identifier_syntax syntax
+                             = identifier_syntax::xid) const;
+    size_t scan_identifier(const char16_t *utf16, size_t len,
+                           identifier_syntax syntax
+                             = identifier_syntax::xid) const;
+    size_t scan_identifier(const char32_t *utf32, size_t len,
+                           identifier_syntax syntax
+                             = identifier_syntax::xid) const;
+
+    // The length of the run of Pattern_White_Space at the start
+    size_t scan_pattern_white_space(const char *utf8, size_t len) const;
+    size_t scan_pattern_white_space(const char16_t *utf16, size_t len) const;
+    size_t scan_pattern_white_space(const char32_t *utf32, size_t len) const;
+
     // Emoji properties
     bool emoji(codepoint cp) const;
     bool emoji_presentation(codepoint cp) const;
     bool emoji_modifier(codepoint cp) const;
     bool emoji_modifier_base(codepoint cp) const;
+
+    /* Finds the first emoji or emoji sequence (ZWJ sequences, skin tone
+       modifiers, flags, keycaps and tag sequences) in txt at or after pos,
+       returning false if there isn't one.  Sequences listed in the emoji
+       data files are matched with an automaton built by ucdc; other well
+       formed sequences are recognised using the grammar in UTS #51. */
+    bool find_emoji(const text &txt, size_t pos, emoji_match &match) const;
   };
 
 }
@@ -0,0 +1,86 @@
+/*
+ * libucd - Unicode database library
+ *
+ * Copyright (c) 2015 Alastair Houghton
+ *
+ */
+
+#ifndef LIBUCD_EMOJI_H_
+#define LIBUCD_EMOJI_H_
+
+#include <cstddef>
+#include <cinttypes>
+
+#include "types.h"
+#include "text.h"
+
+namespace ucd {
+
+  class database;
+
+  // The kinds of emoji sequence described in UTS #51
+  enum class emoji_sequence : uint8_t {
+    none,
+    basic,      // A single emoji character, perhaps with U+FE0F
+    keycap,     // [0-9#*] U+FE0F U+20E3
+    modifier,   // An Emoji_Modifier_Base with a skin tone modifier
+    flag,       // A pair of regional indicators
+    zwj,        // Emoji joined with U+200D ZERO WIDTH JOINER
+    tag         // An emoji followed by tag characters, e.g. subdivision flags
+  };
+
+  // An emoji found by database::find_emoji()
+  struct emoji_match {
+    size_t         start;
+    size_t         end;
+    emoji_sequence type;
+
+    /* Set if the sequence is one of those listed in the emoji data files
+       (or is a single emoji character), rather than one that is merely
+       well formed. */
+    bool           rgi;
+
+    emoji_match() : start(0), end(0), type(emoji_sequence::none), rgi(false) {}
+  };
+
+  /* Finds the emoji in some text, for counting them or for treating each
+     one as a unit.  next() returns the end of the next emoji, or npos once
+     there are no more; start(), type() and rgi() tell you more about it.
+     Emoji characters that default to text presentation (like U+263A) are
+     only counted if they are followed by U+FE0F or are part of a longer
+     sequence. */
+  class emoji_iterator {
+  public:
+    static const size_t npos = size_t(-1);
+
+  private:
+    const database &_db;
+    text            _text;
+    emoji_match     _match;
+
+  public:
+    emoji_iterator(const database &db, const text &txt)
+      : _db(db), _text(txt) {}
+
+    size_t next();
+
+    // The emoji last returned by next()
+    size_t start() const { return _match.start; }
+    size_t end() const { return _match.end; }
+    emoji_sequence type() const { return _match.type; }
+    bool rgi() const { return _match.rgi; }
+
+    // Start looking from pos
+    void reset(size_t pos = 0) { _match = emoji_match(); _match.end = pos; }
+  };
+
+}
+
+#endif /* LIBUCD_EMOJI_H_ */
+
+/*
+ * Local Variables:
+ * mode: c++
+ * End:
+ *
+ */
@@ -0,0 +1,36 @@
+/*
+ * libucd - Unicode database library
+ *
+ * Copyright (c) 2015 Alastair Houghton
+ *
+ */
+
+#ifndef LIBUCD_IDENTIFIER_H_
+#define LIBUCD_IDENTIFIER_H_
+
+#include <cstddef>
+#include <cinttypes>
+
+#include "types.h"
+
+namespace ucd {
+
+  /* Which properties database::scan_identifier() uses.  XID_Start and
+     XID_Continue are ID_Start and ID_Continue adjusted so that they are
+     closed under NFKC, i.e. normalising an identifier always gives you
+     another identifier, which is what UAX #31 recommends. */
+  enum class identifier_syntax : uint8_t {
+    xid,        // XID_Start XID_Continue*
+    id          // ID_Start ID_Continue*
+  };
+
+}
+
+#endif /* LIBUCD_IDENTIFIER_H_ */
+
+/*
+ * Local Variables:
+ * mode: c++
+ * End:
+ *
+ */
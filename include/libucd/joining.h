@@ -0,0 +1,46 @@
+/*
+ * libucd - Unicode database library
+ *
+ * Copyright (c) 2015 Alastair Houghton
+ *
+ */
+
+#ifndef LIBUCD_JOINING_H_
+#define LIBUCD_JOINING_H_
+
+#include <cstddef>
+#include <cinttypes>
+
+#include "types.h"
+
+namespace ucd {
+
+  class database;
+
+  // The cursive joining forms used by Arabic, Syriac, N'Ko, Mongolian &c.
+  enum class joining_form : uint8_t {
+    none,       // Not cursive (Non_Joining, Transparent or Join_Causing)
+    isolated,
+    initial,    // Joined to the following character only
+    medial,     // Joined on both sides
+    final       // Joined to the preceding character only
+  };
+
+  /* Works out the joining form of each of the count code points in cps (a
+     run of text in logical order), following the rules in section 9.2 of
+     the Unicode Standard, and writes them to forms.  Transparent characters
+     are skipped over when deciding whether their neighbours join; ZWJ
+     joins the characters either side of it and ZWNJ stops them joining. */
+  void joining_forms(const database &db, const codepoint *cps, size_t count,
+                     joining_form *forms);
+
+}
+
+#endif /* LIBUCD_JOINING_H_ */
+
+/*
+ * Local Variables:
+ * mode: c++
+ * End:
+ *
+ */
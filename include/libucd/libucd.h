@@ -11,6 +11,17 @@
 #include "exceptions.h"
 #include "database.h"
 #include "version.h"
+#include "utf.h"
+#include "text.h"
+#include "segmentation.h"
+#include "linebreak.h"
+#include "wrap.h"
+#include "bidi.h"
+#include "scripts.h"
+#include "joining.h"
+#include "emoji.h"
+#include "security.h"
+#include "identifier.h"
 
 #endif /* LIBUCD_H_ */
 
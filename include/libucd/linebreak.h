@@ -0,0 +1,79 @@
+/*
+ * libucd - Unicode database library
+ *
+ * Copyright (c) 2015 Alastair Houghton
+ *
+ */
+
+#ifndef LIBUCD_LINEBREAK_H_
+#define LIBUCD_LINEBREAK_H_
+
+#include <cstddef>
+#include <cinttypes>
+
+#include "types.h"
+#include "text.h"
+
+namespace ucd {
+
+  class database;
+
+  /* Finds the line break opportunities in some text, using the algorithm
+     from UAX #14.  next() returns the offset of the next place where a
+     line may (or must) be broken; the end of the text is always returned
+     last.  is_mandatory() then tells you whether the line must be broken
+     there (i.e. it follows a hard line break).
+
+     Characters with the Ambiguous (AI) class are treated as Alphabetic,
+     unless east_asian is set, in which case they are Ideographic.  Complex
+     context (SA) characters are treated as Alphabetic (or as combining
+     marks, if they are marks), because we don't have the dictionaries
+     needed to break Thai and so on properly. */
+  class line_break_iterator {
+  public:
+    static const size_t npos = size_t(-1);
+
+  private:
+    const database &_db;
+    text            _text;
+    size_t          _pos;
+    size_t          _break;
+    bool            _east_asian;
+    bool            _mandatory;
+    bool            _done;
+
+    // The state of the algorithm
+    uint8_t         _prev;
+    uint8_t         _last;
+    bool            _spaces;
+    bool            _zwj;
+    bool            _ri_odd;
+    bool            _hl_hyphen;
+
+    template <class Codec> size_t scan();
+    bool step(unsigned cls);
+    void restart();
+
+  public:
+    line_break_iterator(const database &db, const text &txt,
+                        bool east_asian = false);
+
+    size_t next();
+
+    // The last break returned by next(), or zero
+    size_t position() const { return _break; }
+
+    // True if the last break returned by next() is mandatory
+    bool is_mandatory() const { return _mandatory; }
+  };
+
+}
+
+#endif /* LIBUCD_LINEBREAK_H_ */
+
+/*
+ * Local Variables:
+ * mode: c++
+ * End:
+ *
+ */
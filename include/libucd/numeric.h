@@ -25,17 +25,42 @@ namespace ucd {
       return r;
     }
 
-  inline long long llpow(int b, int e) {
+  inline long long llpow(long long b, int e) {
       long long r = 1;
       while (e) {
         if (e & 1)
           r *= b;
         e >>= 1;
-        b *= b;
+        if (e)
+          b *= b;
       }
       return r;
     }
 
+  // A fraction in lowest terms with a positive denominator, or 0/0 for NaN
+  struct rational {
+    long long numerator;
+    long long denominator;
+
+    constexpr rational() : numerator(0), denominator(0) {}
+    constexpr rational(long long n, long long d = 1)
+      : numerator(n), denominator(d) {}
+
+    bool isnan() const { return !denominator; }
+
+    bool operator==(const rational &other) const {
+      return numerator == other.numerator && denominator == other.denominator;
+    }
+
+    bool operator!=(const rational &other) const {
+      return !(*this == other);
+    }
+
+    explicit operator double() const {
+      return double(numerator) / double(denominator);
+    }
+  };
+
   class numeric {
   private:
     int _multiplier;
@@ -82,7 +107,9 @@ namespace ucd {
     explicit operator double() const {
       if (!_exponent)
         return _multiplier;
-      return _multiplier * std::pow(_base, _exponent);
+      if (_exponent < 0)
+        return _multiplier / double(llpow(_base, -_exponent));
+      return _multiplier * double(llpow(_base, _exponent));
     }
 
     explicit operator int() const {
@@ -102,6 +129,7 @@ namespace ucd {
     }
 
     std::string to_string() const;
+    rational to_rational() const;
 
     // This exists so you can write -infinity
     numeric operator-() const {
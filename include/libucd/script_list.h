@@ -0,0 +1,157 @@
+/*
+ * libucd - Unicode database library
+ *
+ * Copyright (c) 2015 Alastair Houghton
+ *
+ */
+
+/* Every script, by its four-character code, in alphabetical order.  The
+   Script enum in types.h and the indices in a script_set are both made
+   from this list, so to add a script, add it here.  Define UCD_SCRIPT
+   before including this file; it is undefined again at the end. */
+
+#ifndef UCD_SCRIPT
+#define UCD_SCRIPT(code)
+#endif
+
+UCD_SCRIPT(Adlm)
+UCD_SCRIPT(Aghb)
+UCD_SCRIPT(Ahom)
+UCD_SCRIPT(Arab)
+UCD_SCRIPT(Armi)
+UCD_SCRIPT(Armn)
+UCD_SCRIPT(Avst)
+UCD_SCRIPT(Bali)
+UCD_SCRIPT(Bamu)
+UCD_SCRIPT(Bass)
+UCD_SCRIPT(Batk)
+UCD_SCRIPT(Beng)
+UCD_SCRIPT(Bhks)
+UCD_SCRIPT(Bopo)
+UCD_SCRIPT(Brah)
+UCD_SCRIPT(Brai)
+UCD_SCRIPT(Bugi)
+UCD_SCRIPT(Buhd)
+UCD_SCRIPT(Cakm)
+UCD_SCRIPT(Cans)
+UCD_SCRIPT(Cari)
+UCD_SCRIPT(Cham)
+UCD_SCRIPT(Cher)
+UCD_SCRIPT(Copt)
+UCD_SCRIPT(Cprt)
+UCD_SCRIPT(Cyrl)
+UCD_SCRIPT(Deva)
+UCD_SCRIPT(Dsrt)
+UCD_SCRIPT(Dupl)
+UCD_SCRIPT(Egyp)
+UCD_SCRIPT(Elba)
+UCD_SCRIPT(Ethi)
+UCD_SCRIPT(Geor)
+UCD_SCRIPT(Glag)
+UCD_SCRIPT(Goth)
+UCD_SCRIPT(Gran)
+UCD_SCRIPT(Grek)
+UCD_SCRIPT(Gujr)
+UCD_SCRIPT(Guru)
+UCD_SCRIPT(Hang)
+UCD_SCRIPT(Hani)
+UCD_SCRIPT(Hano)
+UCD_SCRIPT(Hatr)
+UCD_SCRIPT(Hebr)
+UCD_SCRIPT(Hira)
+UCD_SCRIPT(Hluw)
+UCD_SCRIPT(Hmng)
+UCD_SCRIPT(Hrkt)
+UCD_SCRIPT(Hung)
+UCD_SCRIPT(Ital)
+UCD_SCRIPT(Java)
+UCD_SCRIPT(Kali)
+UCD_SCRIPT(Kana)
+UCD_SCRIPT(Khar)
+UCD_SCRIPT(Khmr)
+UCD_SCRIPT(Khoj)
+UCD_SCRIPT(Knda)
+UCD_SCRIPT(Kthi)
+UCD_SCRIPT(Lana)
+UCD_SCRIPT(Laoo)
+UCD_SCRIPT(Latn)
+UCD_SCRIPT(Lepc)
+UCD_SCRIPT(Limb)
+UCD_SCRIPT(Lina)
+UCD_SCRIPT(Linb)
+UCD_SCRIPT(Lisu)
+UCD_SCRIPT(Lyci)
+UCD_SCRIPT(Lydi)
+UCD_SCRIPT(Mahj)
+UCD_SCRIPT(Mand)
+UCD_SCRIPT(Mani)
+UCD_SCRIPT(Marc)
+UCD_SCRIPT(Mend)
+UCD_SCRIPT(Merc)
+UCD_SCRIPT(Mero)
+UCD_SCRIPT(Mlym)
+UCD_SCRIPT(Modi)
+UCD_SCRIPT(Mong)
+UCD_SCRIPT(Mroo)
+UCD_SCRIPT(Mtei)
+UCD_SCRIPT(Mult)
+UCD_SCRIPT(Mymr)
+UCD_SCRIPT(Narb)
+UCD_SCRIPT(Nbat)
+UCD_SCRIPT(Newa)
+UCD_SCRIPT(Nkoo)
+UCD_SCRIPT(Ogam)
+UCD_SCRIPT(Olck)
+UCD_SCRIPT(Orkh)
+UCD_SCRIPT(Orya)
+UCD_SCRIPT(Osge)
+UCD_SCRIPT(Osma)
+UCD_SCRIPT(Palm)
+UCD_SCRIPT(Pauc)
+UCD_SCRIPT(Perm)
+UCD_SCRIPT(Phag)
+UCD_SCRIPT(Phli)
+UCD_SCRIPT(Phlp)
+UCD_SCRIPT(Phnx)
+UCD_SCRIPT(Plrd)
+UCD_SCRIPT(Prti)
+UCD_SCRIPT(Rjng)
+UCD_SCRIPT(Runr)
+UCD_SCRIPT(Samr)
+UCD_SCRIPT(Sarb)
+UCD_SCRIPT(Saur)
+UCD_SCRIPT(Sgnw)
+UCD_SCRIPT(Shaw)
+UCD_SCRIPT(Shrd)
+UCD_SCRIPT(Sidd)
+UCD_SCRIPT(Sind)
+UCD_SCRIPT(Sinh)
+UCD_SCRIPT(Sora)
+UCD_SCRIPT(Sund)
+UCD_SCRIPT(Sylo)
+UCD_SCRIPT(Syrc)
+UCD_SCRIPT(Tagb)
+UCD_SCRIPT(Takr)
+UCD_SCRIPT(Tale)
+UCD_SCRIPT(Talu)
+UCD_SCRIPT(Taml)
+UCD_SCRIPT(Tang)
+UCD_SCRIPT(Tavt)
+UCD_SCRIPT(Telu)
+UCD_SCRIPT(Tfng)
+UCD_SCRIPT(Tglg)
+UCD_SCRIPT(Thaa)
+UCD_SCRIPT(Thai)
+UCD_SCRIPT(Tibt)
+UCD_SCRIPT(Tirh)
+UCD_SCRIPT(Ugar)
+UCD_SCRIPT(Vaii)
+UCD_SCRIPT(Wara)
+UCD_SCRIPT(Xpeo)
+UCD_SCRIPT(Xsux)
+UCD_SCRIPT(Yiii)
+UCD_SCRIPT(Zinh)
+UCD_SCRIPT(Zyyy)
+UCD_SCRIPT(Zzzz)
+
+#undef UCD_SCRIPT
@@ -0,0 +1,193 @@
+/*
+ * libucd - Unicode database library
+ *
+ * Copyright (c) 2015 Alastair Houghton
+ *
+ */
+
+#ifndef LIBUCD_SCRIPTS_H_
+#define LIBUCD_SCRIPTS_H_
+
+#include <cstddef>
+#include <cinttypes>
+
+#include "types.h"
+#include "text.h"
+
+namespace ucd {
+
+  class database;
+
+  /* Each script's index in a script_set, which is its position in
+     script_list.h; use these to test for a particular script without
+     having to look it up. */
+  namespace Script_Index {
+    enum : unsigned {
+#define UCD_SCRIPT(code) code,
+#include "script_list.h"
+
+      count
+    };
+  }
+
+  /* A set of scripts, held as a bitmap indexed by each script's position in
+     script_list.h, so that testing for a script is a single lookup and
+     intersecting two sets is an AND per word.  Scripts this version of the
+     library doesn't know about can't be stored in a script_set; insert()
+     returns false for them, and the database gives them as Unknown. */
+  class script_set {
+  public:
+    static const unsigned npos = unsigned(-1);
+    static const unsigned max_scripts = 256;
+
+  private:
+    static const unsigned num_words = max_scripts / 64;
+
+    uint64_t _bits[num_words];
+
+  public:
+    script_set() : _bits() {}
+    explicit script_set(sc script) : _bits() { insert(script); }
+
+    // Maps a script to its index and back (npos or bad_script if unknown)
+    static unsigned index(sc script);
+    static sc script(unsigned ndx);
+
+    bool test(unsigned ndx) const {
+      return ndx < max_scripts && ((_bits[ndx >> 6] >> (ndx & 63)) & 1);
+    }
+    void set(unsigned ndx) {
+      if (ndx < max_scripts)
+        _bits[ndx >> 6] |= uint64_t(1) << (ndx & 63);
+    }
+    void reset(unsigned ndx) {
+      if (ndx < max_scripts)
+        _bits[ndx >> 6] &= ~(uint64_t(1) << (ndx & 63));
+    }
+
+    bool contains(sc script) const { return test(index(script)); }
+    bool insert(sc script) {
+      unsigned ndx = index(script);
+      set(ndx);
+      return ndx != npos;
+    }
+    void erase(sc script) { reset(index(script)); }
+
+    void clear() {
+      for (unsigned n = 0; n < num_words; ++n)
+        _bits[n] = 0;
+    }
+
+    bool empty() const {
+      for (unsigned n = 0; n < num_words; ++n) {
+        if (_bits[n])
+          return false;
+      }
+      return true;
+    }
+
+    size_t size() const;
+
+    // The script with the lowest index, or bad_script if the set is empty
+    sc first() const;
+
+    script_set &operator&=(const script_set &other) {
+      for (unsigned n = 0; n < num_words; ++n)
+        _bits[n] &= other._bits[n];
+      return *this;
+    }
+    script_set &operator|=(const script_set &other) {
+      for (unsigned n = 0; n < num_words; ++n)
+        _bits[n] |= other._bits[n];
+      return *this;
+    }
+
+    friend script_set operator&(script_set a, const script_set &b) {
+      return a &= b;
+    }
+    friend script_set operator|(script_set a, const script_set &b) {
+      return a |= b;
+    }
+
+    bool operator==(const script_set &other) const {
+      for (unsigned n = 0; n < num_words; ++n) {
+        if (_bits[n] != other._bits[n])
+          return false;
+      }
+      return true;
+    }
+    bool operator!=(const script_set &other) const {
+      return !(*this == other);
+    }
+  };
+
+  /* Splits some text into runs of a single script, for shaping and font
+     fallback.  Common and Inherited characters join the run they're in; a
+     character with Script_Extensions joins the run if it shares a script
+     with it, narrowing down the scripts the run could be.  As in ICU and
+     HarfBuzz, a closing bracket takes the script of the opening bracket it
+     matches, so the brackets stay with the run around them even when the
+     text inside is in another script; Latin "(abc)" in Greek text splits
+     as Greek "... (", Latin "abc", then Greek ") ...".
+
+     next() returns the end of the next run, or npos once there are no
+     more; script() gives the script of that run (Common if it has nothing
+     but Common and Inherited characters). */
+  class script_iterator {
+  public:
+    static const size_t npos = size_t(-1);
+
+    // How many unclosed brackets we remember
+    static const unsigned max_brackets = 32;
+
+  private:
+    struct bracket {
+      codepoint closing;
+      sc        script;
+    };
+
+    const database &_db;
+    text            _text;
+    size_t          _start;
+    size_t          _end;
+    sc              _script;
+
+    /* The scripts the current run could be.  These point into the database
+       unless there's just the one, and possible has a bit set for each
+       one that is still in the running. */
+    const sc       *_candidates;
+    sc              _candidate;
+    unsigned        _num_candidates;
+    uint64_t        _possible;
+
+    bracket         _brackets[max_brackets];
+    unsigned        _depth;
+    unsigned        _unresolved;
+
+    template <class Codec> size_t scan();
+    bool add(const sc *scripts, size_t count);
+
+  public:
+    script_iterator(const database &db, const text &txt)
+      : _db(db), _text(txt), _start(0), _end(0), _script(Script::Common),
+        _candidates(nullptr), _candidate(Script::Common), _num_candidates(0),
+        _possible(0), _depth(0), _unresolved(0) {}
+
+    size_t next();
+
+    // The run last returned by next()
+    size_t start() const { return _start; }
+    size_t end() const { return _end; }
+    sc script() const { return _script; }
+  };
+
+}
+
+#endif /* LIBUCD_SCRIPTS_H_ */
+
+/*
+ * Local Variables:
+ * mode: c++
+ * End:
+ *
+ */
@@ -0,0 +1,58 @@
+/*
+ * libucd - Unicode database library
+ *
+ * Copyright (c) 2015 Alastair Houghton
+ *
+ */
+
+#ifndef LIBUCD_SECURITY_H_
+#define LIBUCD_SECURITY_H_
+
+#include <cstddef>
+#include <cinttypes>
+
+#include "types.h"
+
+namespace ucd {
+
+  /* The restriction levels from UTS #39, from most to least restrictive,
+     so that you can compare them with < and >.  Unrestricted is missing
+     because database::restriction_level() doesn't check the identifier
+     profile; see there for details. */
+  enum class restriction_level : uint8_t {
+    ascii_only,
+    single_script,
+    highly_restrictive,     // Latin with Han and Kana, Bopomofo or Hangul
+    moderately_restrictive, // Latin with one other script (not Cyrl or Grek)
+    minimally_restrictive   // Any mixture of scripts
+  };
+
+  /* Properties of code points that you may not want in source code or
+     user names, because they are invisible, change the way the text
+     around them is displayed, or aren't meant for interchange at all; see
+     database::find_hidden(). */
+  namespace Hidden_Property {
+    typedef enum {
+      none               = 0x00,
+
+      bidi_control       = 0x01,
+      default_ignorable  = 0x02,  // Default_Ignorable_Code_Point
+      join_control       = 0x04,
+      variation_selector = 0x08,
+      noncharacter       = 0x10,
+      unassigned         = 0x20,
+
+      all                = 0x3f
+    } Enum;
+  }
+
+}
+
+#endif /* LIBUCD_SECURITY_H_ */
+
+/*
+ * Local Variables:
+ * mode: c++
+ * End:
+ *
+ */
@@ -0,0 +1,216 @@
+/*
+ * libucd - Unicode database library
+ *
+ * Copyright (c) 2015 Alastair Houghton
+ *
+ */
+
+#ifndef LIBUCD_SEGMENTATION_H_
+#define LIBUCD_SEGMENTATION_H_
+
+#include <cstddef>
+#include <cinttypes>
+
+#include "types.h"
+#include "text.h"
+
+namespace ucd {
+
+  class database;
+
+  /* Finds the extended grapheme cluster boundaries in some text, as
+     described in UAX #29.  next() returns the offset of the end of the next
+     cluster (so the last boundary it returns is the length of the text),
+     or npos once there are no more. */
+  class grapheme_iterator {
+  public:
+    static const size_t npos = size_t(-1);
+
+  private:
+    const database &_db;
+    text            _text;
+    size_t          _pos;
+
+  public:
+    grapheme_iterator(const database &db, const text &txt)
+      : _db(db), _text(txt), _pos(0) {}
+
+    size_t next();
+
+    // The last boundary returned by next(), or zero
+    size_t position() const { return _pos; }
+
+    // Carry on from a known boundary
+    void reset(size_t pos = 0) { _pos = pos; }
+  };
+
+  /* Finds the orthographic syllables in Brahmic-script text (Devanagari,
+     Bengali, Tamil, Myanmar, Khmer and so on), using the
+     Indic_Syllabic_Category property and a simplified form of the cluster
+     grammar from Microsoft's Universal Shaping Engine.  A syllable is an
+     optional repha, a base, any number of halant-joined bases, then
+     medials, vowel signs and vowel modifiers.  As in the USE, a mark that
+     can't attach to what comes before it starts a syllable of its own.
+
+     Text in other scripts comes out one grapheme cluster at a time.  As
+     for grapheme_iterator, next() returns the end of the next syllable,
+     or npos once there are no more. */
+  class syllable_iterator {
+  public:
+    static const size_t npos = size_t(-1);
+
+  private:
+    const database &_db;
+    text            _text;
+    size_t          _pos;
+
+  public:
+    syllable_iterator(const database &db, const text &txt)
+      : _db(db), _text(txt), _pos(0) {}
+
+    size_t next();
+
+    // The last boundary returned by next(), or zero
+    size_t position() const { return _pos; }
+
+    // Carry on from a known boundary
+    void reset(size_t pos = 0) { _pos = pos; }
+  };
+
+  /* Text that is being supplied a chunk at a time, as used by the
+     streaming iterators below.  Chunks may split code points; the start
+     of a split code point is kept in carry until the next chunk arrives.
+     Offsets are always from the start of the first chunk. */
+  class chunked_text {
+  public:
+    text     chunk;
+    size_t   base;
+    size_t   pos;
+    bool     final;
+    uint32_t carry[3];
+    unsigned carry_len;
+
+    chunked_text() : base(0), pos(0), final(false), carry_len(0) {}
+
+    void feed(const text &txt, bool last) {
+      base += chunk.length();
+      chunk = txt;
+      pos = 0;
+      final = last;
+    }
+
+    bool has_input() const {
+      return pos < chunk.length() || (final && carry_len);
+    }
+
+    size_t end() const { return base + chunk.length(); }
+  };
+
+  /* Finds the word boundaries in some text, as described in UAX #29.  The
+     text can be supplied all at once, or a chunk at a time using feed().
+     next() returns the end of the next segment, or npos if it can't find
+     one without more text (or there's nothing left).
+
+     In words_only mode, segments that don't contain letters, digits or
+     ideographs (i.e. spaces and punctuation) are skipped.  There is no
+     dictionary support, so Thai, Lao and so on are split per character. */
+  class word_iterator {
+  public:
+    static const size_t npos = size_t(-1);
+
+    enum class mode {
+      all,
+      words_only
+    };
+
+  private:
+    struct segment {
+      size_t start, end;
+      bool   word;
+    };
+
+    const database &_db;
+    mode            _mode;
+    chunked_text    _input;
+    unsigned        _state;
+    size_t          _start;
+    size_t          _accept;
+    bool            _word;
+    segment         _pending[2];
+    unsigned        _pending_len;
+    segment         _current;
+
+    template <class Codec> void scan();
+    void push(codepoint cp, unsigned cls, size_t begin, size_t end);
+    void emit(size_t end);
+    void finish();
+
+  public:
+    word_iterator(const database &db, mode m = mode::all);
+    word_iterator(const database &db, const text &txt, mode m = mode::all);
+
+    // Supply the next chunk of text; final must be set on the last one
+    void feed(const text &chunk, bool final = false) {
+      _input.feed(chunk, final);
+    }
+
+    size_t next();
+
+    // The start and end of the last segment returned by next()
+    size_t start() const { return _current.start; }
+    size_t position() const { return _current.end; }
+
+    // True if the last segment contained a letter, digit or ideograph
+    bool is_word() const { return _current.word; }
+  };
+
+  /* Finds the sentence boundaries in some text, as described in UAX #29.
+     Like word_iterator, it can be fed a chunk at a time.  Rule SB8 can
+     need to look arbitrarily far ahead, but the iterator only ever
+     remembers the position of the last possible boundary, so it uses
+     the same amount of memory however long the input is. */
+  class sentence_iterator {
+  public:
+    static const size_t npos = size_t(-1);
+
+  private:
+    const database &_db;
+    chunked_text    _input;
+    unsigned        _state;
+    size_t          _accept;
+    size_t          _pending[2];
+    unsigned        _pending_len;
+    size_t          _current_start;
+    size_t          _current;
+
+    template <class Codec> void scan();
+    void push(unsigned cls, size_t begin, size_t end);
+    void emit(size_t end);
+    void finish();
+
+  public:
+    sentence_iterator(const database &db);
+    sentence_iterator(const database &db, const text &txt);
+
+    // Supply the next chunk of text; final must be set on the last one
+    void feed(const text &chunk, bool final = false) {
+      _input.feed(chunk, final);
+    }
+
+    size_t next();
+
+    // The start and end of the last sentence returned by next()
+    size_t start() const { return _current_start; }
+    size_t position() const { return _current; }
+  };
+
+}
+
+#endif /* LIBUCD_SEGMENTATION_H_ */
+
+/*
+ * Local Variables:
+ * mode: c++
+ * End:
+ *
+ */
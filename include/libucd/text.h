@@ -0,0 +1,62 @@
+/*
+ * libucd - Unicode database library
+ *
+ * Copyright (c) 2015 Alastair Houghton
+ *
+ */
+
+#ifndef LIBUCD_TEXT_H_
+#define LIBUCD_TEXT_H_
+
+#include <cstddef>
+#include <string>
+
+namespace ucd {
+
+  /* A reference to a buffer of UTF-8, UTF-16 or UTF-32 text, so that the
+     segmentation APIs can accept any of the three.  The text isn't copied,
+     so it must outlive anything that refers to it.  Offsets and lengths are
+     always in code units. */
+  class text {
+  public:
+    enum class encoding_form {
+      utf8,
+      utf16,
+      utf32
+    };
+
+  private:
+    const void    *_data;
+    size_t         _length;
+    encoding_form  _encoding;
+
+  public:
+    text() : _data(nullptr), _length(0), _encoding(encoding_form::utf8) {}
+    text(const char *utf8, size_t len)
+      : _data(utf8), _length(len), _encoding(encoding_form::utf8) {}
+    text(const char16_t *utf16, size_t len)
+      : _data(utf16), _length(len), _encoding(encoding_form::utf16) {}
+    text(const char32_t *utf32, size_t len)
+      : _data(utf32), _length(len), _encoding(encoding_form::utf32) {}
+    text(const std::string &utf8)
+      : text(utf8.data(), utf8.size()) {}
+    text(const std::u16string &utf16)
+      : text(utf16.data(), utf16.size()) {}
+    text(const std::u32string &utf32)
+      : text(utf32.data(), utf32.size()) {}
+
+    const void *data() const { return _data; }
+    size_t length() const { return _length; }
+    encoding_form encoding() const { return _encoding; }
+  };
+
+}
+
+#endif /* LIBUCD_TEXT_H_ */
+
+/*
+ * Local Variables:
+ * mode: c++
+ * End:
+ *
+ */
@@ -19,6 +19,13 @@ namespace ucd {
 
   typedef std::vector<codepoint> cpvector;
 
+  // An inclusive range of code points
+  struct cprange {
+    codepoint first, last;
+  };
+
+  typedef std::vector<cprange> cpranges;
+
   // Bad code point value
   enum {
     bad_codepoint = 0xffffffff
@@ -541,145 +548,11 @@ namespace ucd {
     enum {
       bad_script = 0,
 
-      Adlm = 'Adlm',
-      Aghb = 'Aghb',
-      Ahom = 'Ahom',
-      Arab = 'Arab',
-      Armi = 'Armi',
-      Armn = 'Armn',
-      Avst = 'Avst',
-      Bali = 'Bali',
-      Bamu = 'Bamu',
-      Bass = 'Bass',
-      Batk = 'Batk',
-      Beng = 'Beng',
-      Bhks = 'Bhks',
-      Bopo = 'Bopo',
-      Brah = 'Brah',
-      Brai = 'Brai',
-      Bugi = 'Bugi',
-      Buhd = 'Buhd',
-      Cakm = 'Cakm',
-      Cans = 'Cans',
-      Cari = 'Cari',
-      Cham = 'Cham',
-      Cher = 'Cher',
-      Copt = 'Copt',
-      Cprt = 'Cprt',
-      Cyrl = 'Cyrl',
-      Deva = 'Deva',
-      Dsrt = 'Dsrt',
-      Dupl = 'Dupl',
-      Egyp = 'Egyp',
-      Elba = 'Elba',
-      Ethi = 'Ethi',
-      Geor = 'Geor',
-      Glag = 'Glag',
-      Goth = 'Goth',
-      Gran = 'Gran',
-      Grek = 'Grek',
-      Gujr = 'Gujr',
-      Guru = 'Guru',
-      Hang = 'Hang',
-      Hani = 'Hani',
-      Hano = 'Hano',
-      Hatr = 'Hatr',
-      Hebr = 'Hebr',
-      Hira = 'Hira',
-      Hluw = 'Hluw',
-      Hmng = 'Hmng',
-      Hrkt = 'Hrkt',
-      Hung = 'Hung',
-      Ital = 'Ital',
-      Java = 'Java',
-      Kali = 'Kali',
-      Kana = 'Kana',
-      Khar = 'Khar',
-      Khmr = 'Khmr',
-      Khoj = 'Khoj',
-      Knda = 'Knda',
-      Kthi = 'Kthi',
-      Lana = 'Lana',
-      Laoo = 'Laoo',
-      Latn = 'Latn',
-      Lepc = 'Lepc',
-      Limb = 'Limb',
-      Lina = 'Lina',
-      Linb = 'Linb',
-      Lisu = 'Lisu',
-      Lyci = 'Lyci',
-      Lydi = 'Lydi',
-      Mahj = 'Mahj',
-      Mand = 'Mand',
-      Mani = 'Mani',
-      Marc = 'Marc',
-      Mend = 'Mend',
-      Merc = 'Merc',
-      Mero = 'Mero',
-      Mlym = 'Mlym',
-      Modi = 'Modi',
-      Mong = 'Mong',
-      Mroo = 'Mroo',
-      Mtei = 'Mtei',
-      Mult = 'Mult',
-      Mymr = 'Mymr',
-      Narb = 'Narb',
-      Nbat = 'Nbat',
-      Newa = 'Newa',
-      Nkoo = 'Nkoo',
-      Ogam = 'Ogam',
-      Olck = 'Olck',
-      Orkh = 'Orkh',
-      Orya = 'Orya',
-      Osge = 'Osge',
-      Osma = 'Osma',
-      Palm = 'Palm',
-      Pauc = 'Pauc',
-      Perm = 'Perm',
-      Phag = 'Phag',
-      Phli = 'Phli',
-      Phlp = 'Phlp',
-      Phnx = 'Phnx',
-      Plrd = 'Plrd',
-      Prti = 'Prti',
-      Rjng = 'Rjng',
-      Runr = 'Runr',
-      Samr = 'Samr',
-      Sarb = 'Sarb',
-      Saur = 'Saur',
-      Sgnw = 'Sgnw',
-      Shaw = 'Shaw',
-      Shrd = 'Shrd',
-      Sidd = 'Sidd',
-      Sind = 'Sind',
-      Sinh = 'Sinh',
-      Sora = 'Sora',
-      Sund = 'Sund',
-      Sylo = 'Sylo',
-      Syrc = 'Syrc',
-      Tagb = 'Tagb',
-      Takr = 'Takr',
-      Tale = 'Tale',
-      Talu = 'Talu',
-      Taml = 'Taml',
-      Tang = 'Tang',
-      Tavt = 'Tavt',
-      Telu = 'Telu',
-      Tfng = 'Tfng',
-      Tglg = 'Tglg',
-      Thaa = 'Thaa',
-      Thai = 'Thai',
-      Tibt = 'Tibt',
-      Tirh = 'Tirh',
-      Ugar = 'Ugar',
-      Vaii = 'Vaii',
-      Wara = 'Wara',
-      Xpeo = 'Xpeo',
-      Xsux = 'Xsux',
-      Yiii = 'Yiii',
-      Zinh = 'Zinh',
-      Zyyy = 'Zyyy',
-      Zzzz = 'Zzzz',
+      // Adlm = 'Adlm' and so on, for each script in script_list.h
+#define UCD_SCRIPT(code)                                        \
+      code = ((#code[0] << 24) | (#code[1] << 16)               \
+              | (#code[2] << 8) | #code[3]),
+#include "script_list.h"
 
       // Aliases
       Adlam = Adlm,
@@ -0,0 +1,231 @@
+/*
+ * libucd - Unicode database library
+ *
+ * Copyright (c) 2015 Alastair Houghton
+ *
+ */
+
+#ifndef LIBUCD_UTF_H_
+#define LIBUCD_UTF_H_
+
+#include "types.h"
+
+namespace ucd {
+
+  const codepoint replacement_character = 0xfffd;
+
+  /* Codecs for the three Unicode encoding forms.  These are used by the
+     string-level APIs, but you may find them useful too.
+
+     decode() reads a code point starting at ptr and advances ptr past it;
+     decode_prev() does the reverse, moving ptr back to the start of the
+     previous code point.  Ill-formed input decodes to U+FFFD, consuming
+     the maximal subpart as recommended by section 3.9 of the Unicode
+     Standard.
+
+     encode() writes a code point to out, which must have room for at least
+     max_length code units, returning the number of code units written. */
+
+  struct utf8_codec {
+    typedef char code_unit;
+    enum { max_length = 4 };
+
+    static unsigned length(codepoint cp) {
+      if (cp < 0x80)
+        return 1;
+      else if (cp < 0x800)
+        return 2;
+      else if (cp < 0x10000)
+        return 3;
+      else
+        return 4;
+    }
+
+    static codepoint decode(const code_unit *&ptr, const code_unit *end) {
+      uint8_t b0 = (uint8_t)*ptr++;
+      uint8_t lo = 0x80, hi = 0xbf;
+      unsigned count;
+      codepoint cp;
+
+      if (b0 < 0x80)
+        return b0;
+      else if (b0 >= 0xc2 && b0 <= 0xdf) {
+        count = 1;
+        cp = b0 & 0x1f;
+      } else if (b0 >= 0xe0 && b0 <= 0xef) {
+        count = 2;
+        cp = b0 & 0x0f;
+        if (b0 == 0xe0)
+          lo = 0xa0;
+        else if (b0 == 0xed)
+          hi = 0x9f;
+      } else if (b0 >= 0xf0 && b0 <= 0xf4) {
+        count = 3;
+        cp = b0 & 0x07;
+        if (b0 == 0xf0)
+          lo = 0x90;
+        else if (b0 == 0xf4)
+          hi = 0x8f;
+      } else
+        return replacement_character;
+
+      while (count--) {
+        if (ptr == end)
+          return replacement_character;
+
+        uint8_t b = (uint8_t)*ptr;
+        if (b < lo || b > hi)
+          return replacement_character;
+
+        cp = (cp << 6) | (b & 0x3f);
+        lo = 0x80;
+        hi = 0xbf;
+        ++ptr;
+      }
+
+      return cp;
+    }
+
+    static codepoint decode_prev(const code_unit *begin,
+                                 const code_unit *&ptr) {
+      const code_unit *last = ptr - 1;
+
+      if ((uint8_t)*last < 0x80) {
+        ptr = last;
+        return (uint8_t)*last;
+      }
+
+      // Find the lead byte, then make sure it decodes to exactly this run
+      const code_unit *start = last;
+      for (unsigned n = 0;
+           n < 3 && start > begin && ((uint8_t)*start & 0xc0) == 0x80;
+           ++n)
+        --start;
+
+      const code_unit *p = start;
+      codepoint cp = decode(p, ptr);
+
+      if (p == ptr) {
+        ptr = start;
+        return cp;
+      }
+
+      ptr = last;
+      return replacement_character;
+    }
+
+    static unsigned encode(codepoint cp, code_unit *out) {
+      if (cp < 0x80) {
+        out[0] = (code_unit)cp;
+        return 1;
+      } else if (cp < 0x800) {
+        out[0] = (code_unit)(0xc0 | (cp >> 6));
+        out[1] = (code_unit)(0x80 | (cp & 0x3f));
+        return 2;
+      } else if (cp < 0x10000) {
+        out[0] = (code_unit)(0xe0 | (cp >> 12));
+        out[1] = (code_unit)(0x80 | ((cp >> 6) & 0x3f));
+        out[2] = (code_unit)(0x80 | (cp & 0x3f));
+        return 3;
+      } else {
+        out[0] = (code_unit)(0xf0 | (cp >> 18));
+        out[1] = (code_unit)(0x80 | ((cp >> 12) & 0x3f));
+        out[2] = (code_unit)(0x80 | ((cp >> 6) & 0x3f));
+        out[3] = (code_unit)(0x80 | (cp & 0x3f));
+        return 4;
+      }
+    }
+  };
+
+  struct utf16_codec {
+    typedef char16_t code_unit;
+    enum { max_length = 2 };
+
+    static unsigned length(codepoint cp) {
+      return cp >= 0x10000 ? 2 : 1;
+    }
+
+    static codepoint decode(const code_unit *&ptr, const code_unit *end) {
+      char16_t cu0 = *ptr++;
+
+      if (cu0 < 0xd800 || cu0 > 0xdfff)
+        return cu0;
+
+      if (cu0 >= 0xdc00 || ptr == end || *ptr < 0xdc00 || *ptr > 0xdfff)
+        return replacement_character;
+
+      char16_t cu1 = *ptr++;
+
+      return 0x10000 + (((cu0 & 0x3ff) << 10) | (cu1 & 0x3ff));
+    }
+
+    static codepoint decode_prev(const code_unit *begin,
+                                 const code_unit *&ptr) {
+      char16_t cu1 = *--ptr;
+
+      if (cu1 < 0xd800 || cu1 > 0xdfff)
+        return cu1;
+
+      if (cu1 < 0xdc00 || ptr == begin || ptr[-1] < 0xd800 || ptr[-1] > 0xdbff)
+        return replacement_character;
+
+      char16_t cu0 = *--ptr;
+
+      return 0x10000 + (((cu0 & 0x3ff) << 10) | (cu1 & 0x3ff));
+    }
+
+    static unsigned encode(codepoint cp, code_unit *out) {
+      if (cp < 0x10000) {
+        out[0] = (code_unit)cp;
+        return 1;
+      }
+
+      cp -= 0x10000;
+      out[0] = (code_unit)(0xd800 | (cp >> 10));
+      out[1] = (code_unit)(0xdc00 | (cp & 0x3ff));
+      return 2;
+    }
+  };
+
+  struct utf32_codec {
+    typedef char32_t code_unit;
+    enum { max_length = 1 };
+
+    static unsigned length(codepoint) {
+      return 1;
+    }
+
+    static codepoint decode(const code_unit *&ptr, const code_unit *) {
+      char32_t cp = *ptr++;
+
+      if (cp > 0x10ffff || (cp >= 0xd800 && cp <= 0xdfff))
+        return replacement_character;
+
+      return cp;
+    }
+
+    static codepoint decode_prev(const code_unit *, const code_unit *&ptr) {
+      char32_t cp = *--ptr;
+
+      if (cp > 0x10ffff || (cp >= 0xd800 && cp <= 0xdfff))
+        return replacement_character;
+
+      return cp;
+    }
+
+    static unsigned encode(codepoint cp, code_unit *out) {
+      *out = cp;
+      return 1;
+    }
+  };
+
+}
+
+#endif /* LIBUCD_UTF_H_ */
+
+/*
+ * Local Variables:
+ * mode: c++
+ * End:
+ *
+ */
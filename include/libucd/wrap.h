@@ -0,0 +1,106 @@
+/*
+ * libucd - Unicode database library
+ *
+ * Copyright (c) 2015 Alastair Houghton
+ *
+ */
+
+#ifndef LIBUCD_WRAP_H_
+#define LIBUCD_WRAP_H_
+
+#include <cstddef>
+#include <string>
+
+#include "text.h"
+#include "segmentation.h"
+#include "linebreak.h"
+
+namespace ucd {
+
+  class database;
+
+  /* Splits some text into lines that fit in a given number of terminal
+     columns, breaking at the line break opportunities from UAX #14 where
+     possible and between grapheme clusters where not.  next() returns the
+     end of the next line (so the lines cover the whole text, including
+     any spaces and hard line breaks), or npos once there are no more.
+
+     Spaces at the end of a line don't count towards its width; the part
+     of the line you should actually display runs from start() to
+     content_end(), and is width() columns wide. */
+  class wrap_iterator {
+  public:
+    static const size_t npos = size_t(-1);
+
+  private:
+    const database     &_db;
+    text                _text;
+    size_t              _max_width;
+    bool                _east_asian;
+    bool                _have_emoji;
+    grapheme_iterator   _graphemes;
+    line_break_iterator _breaks;
+    size_t              _next_break;
+    size_t              _pos;
+
+    // The line we're building
+    struct line {
+      size_t start;
+      size_t width;
+      size_t content_end;
+      size_t content_width;
+    };
+    line                _line;
+
+    // The last break opportunity in it (if break_at > _line.start)
+    size_t              _break_at;
+    line                _at_break;
+
+    // The line we last returned
+    line                _current;
+    size_t              _current_end;
+
+    template <class Codec> size_t scan();
+    size_t emit(size_t end, const line &ln);
+
+  public:
+    wrap_iterator(const database &db, const text &txt, size_t width,
+                  bool east_asian = false);
+
+    size_t next();
+
+    // The line last returned by next()
+    size_t start() const { return _current.start; }
+    size_t end() const { return _current_end; }
+    size_t content_end() const { return _current.content_end; }
+    size_t width() const { return _current.content_width; }
+  };
+
+  /* Returns the length of the longest prefix of txt that fits in width
+     columns without splitting a grapheme cluster.  If pwidth isn't null,
+     the width of the prefix is stored there. */
+  size_t fit_to_width(const database &db, const text &txt, size_t width,
+                      bool east_asian = false, size_t *pwidth = nullptr);
+
+  /* If utf8 is wider than width columns, shortens it (at a grapheme cluster
+     boundary) and appends the ellipsis, such that the result fits. */
+  std::string truncate_to_width(const database &db, const std::string &utf8,
+                                size_t width,
+                                const std::string &ellipsis = "\xe2\x80\xa6",
+                                bool east_asian = false);
+
+  /* Wraps utf8 to width columns, using wrap_iterator, and returns the lines
+     separated by '\n', with trailing spaces removed. */
+  std::string wrap(const database &db, const std::string &utf8, size_t width,
+                   bool east_asian = false);
+
+}
+
+#endif /* LIBUCD_WRAP_H_ */
+
+/*
+ * Local Variables:
+ * mode: c++
+ * End:
+ *
+ */
@@ -0,0 +1,124 @@
+#include <libucd/libucd.h>
+#include "ucd-format.h"
+#include "ucd-impl.h"
+#include "ucd-trie.h"
+#include "ucd-text.h"
+#include "ucd-ascii.h"
+
+using namespace ucd;
+
+namespace {
+
+  /* Returns the Age of cp in the same form as the age table's versions[]
+     array, i.e. (major << 16) | minor, or zero if it is unassigned. */
+  inline uint32_t
+  packed_age(const database &db, const struct ucd_trie *ptrie,
+             const struct ucd_age *page, codepoint cp)
+  {
+    if (!ptrie) {
+      version v = db.age(cp);
+      return v == version::nil ? 0 : (v.major << 16) | v.minor;
+    }
+
+    uint32_t ndx = ucd_trie_lookup(ptrie, cp);
+
+    if (!ndx || ndx > page->num_versions)
+      return 0;
+
+    return page->versions[ndx - 1];
+  }
+
+  template <class Codec>
+  uint32_t
+  text_max_age(const database &db, const struct ucd_trie *ptrie,
+               const struct ucd_age *page, const text &txt)
+  {
+    typedef typename Codec::code_unit code_unit;
+
+    const code_unit *ptr = text_begin<Codec>(txt);
+    const code_unit *end = text_end<Codec>(txt);
+    uint32_t result = 0;
+
+    while (ptr < end) {
+      // All of ASCII has the same Age, so we only need to look up one
+      size_t run = ascii_span(ptr, end - ptr);
+      codepoint cp;
+
+      if (run) {
+        cp = *ptr;
+        ptr += run;
+      } else
+        cp = Codec::decode(ptr, end);
+
+      uint32_t age = packed_age(db, ptrie, page, cp);
+
+      if (age > result)
+        result = age;
+    }
+
+    return result;
+  }
+
+  template <class Codec>
+  size_t
+  text_first_newer_than(const database &db, const struct ucd_trie *ptrie,
+                        const struct ucd_age *page, const text &txt,
+                        uint32_t limit)
+  {
+    typedef typename Codec::code_unit code_unit;
+
+    const code_unit *begin = text_begin<Codec>(txt);
+    const code_unit *end = text_end<Codec>(txt);
+    const code_unit *ptr = begin;
+    bool ascii_ok = false;
+
+    while (ptr < end) {
+      if (ascii_ok)
+        ptr += ascii_span(ptr, end - ptr);
+      if (ptr == end)
+        break;
+
+      const code_unit *cp_start = ptr;
+      codepoint cp = Codec::decode(ptr, end);
+      uint32_t age = packed_age(db, ptrie, page, cp);
+
+      if (!age || age > limit)
+        return cp_start - begin;
+
+      if (cp < 0x80)
+        ascii_ok = true;
+    }
+
+    return end - begin;
+  }
+
+}
+
+version
+database::max_age(const text &txt) const
+{
+  const struct ucd_trie *ptrie = _pimpl->get_aget();
+  const struct ucd_age *page = _pimpl->get_age();
+  uint32_t age = 0;
+
+  UCD_TEXT_DISPATCH(txt, age = text_max_age, (*this, ptrie, page, txt));
+
+  if (!age)
+    return version::nil;
+
+  return version(UCD_AGE_MAJOR(age), UCD_AGE_MINOR(age), 0);
+}
+
+size_t
+database::first_newer_than(const text &txt, const version &v) const
+{
+  const struct ucd_trie *ptrie = _pimpl->get_aget();
+  const struct ucd_age *page = _pimpl->get_age();
+  uint32_t limit = (v.major << 16) | v.minor;
+  size_t result = 0;
+
+  UCD_TEXT_DISPATCH(txt, result = text_first_newer_than,
+                    (*this, ptrie, page, txt, limit));
+
+  return result;
+}
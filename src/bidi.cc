@@ -0,0 +1,838 @@
+#include <algorithm>
+
+#include <libucd/libucd.h>
+#include "ucd-format.h"
+#include "ucd-impl.h"
+#include "ucd-trie.h"
+#include "ucd-text.h"
+#include "ucd-ascii.h"
+
+using namespace ucd;
+
+const size_t bidi_workspace::npos;
+const unsigned bidi_workspace::max_depth;
+
+namespace {
+
+  // Shorthand for the Bidi_Class values, which we store as bytes
+  enum : uint8_t {
+    L = uint8_t(bc::L),
+    R = uint8_t(bc::R),
+    AL = uint8_t(bc::AL),
+    EN = uint8_t(bc::EN),
+    ES = uint8_t(bc::ES),
+    ET = uint8_t(bc::ET),
+    AN = uint8_t(bc::AN),
+    CS = uint8_t(bc::CS),
+    NSM = uint8_t(bc::NSM),
+    BN = uint8_t(bc::BN),
+    B = uint8_t(bc::B),
+    S = uint8_t(bc::S),
+    WS = uint8_t(bc::WS),
+    ON = uint8_t(bc::ON),
+    LRE = uint8_t(bc::LRE),
+    LRO = uint8_t(bc::LRO),
+    RLE = uint8_t(bc::RLE),
+    RLO = uint8_t(bc::RLO),
+    PDF = uint8_t(bc::PDF),
+    LRI = uint8_t(bc::LRI),
+    RLI = uint8_t(bc::RLI),
+    FSI = uint8_t(bc::FSI),
+    PDI = uint8_t(bc::PDI)
+  };
+
+  // The Bidi_Class values of the ASCII characters
+  const uint8_t ascii_classes[0x80] = {
+    BN, BN, BN, BN, BN, BN, BN, BN, BN, S,  B,  S,  WS, B,  BN, BN,
+    BN, BN, BN, BN, BN, BN, BN, BN, BN, BN, BN, BN, B,  B,  B,  S,
+    WS, ON, ON, ET, ET, ET, ON, ON, ON, ON, ON, ES, CS, ES, CS, CS,
+    EN, EN, EN, EN, EN, EN, EN, EN, EN, EN, CS, ON, ON, ON, ON, ON,
+    ON, L,  L,  L,  L,  L,  L,  L,  L,  L,  L,  L,  L,  L,  L,  L,
+    L,  L,  L,  L,  L,  L,  L,  L,  L,  L,  L,  ON, ON, ON, ON, ON,
+    ON, L,  L,  L,  L,  L,  L,  L,  L,  L,  L,  L,  L,  L,  L,  L,
+    L,  L,  L,  L,  L,  L,  L,  L,  L,  L,  L,  ON, ON, ON, ON, BN
+  };
+
+  // BD16 only needs to track this many open brackets
+  const size_t max_open_brackets = 63;
+
+  inline bool
+  is_isolate_initiator(uint8_t c)
+  {
+    return c == LRI || c == RLI || c == FSI;
+  }
+
+  // Characters removed by X9
+  inline bool
+  is_removed(uint8_t c)
+  {
+    return (c == RLE || c == LRE || c == RLO || c == LRO || c == PDF
+            || c == BN);
+  }
+
+  // Neutral and isolate formatting characters (NI in N1 and N2)
+  inline bool
+  is_ni(uint8_t t)
+  {
+    return (t == B || t == S || t == WS || t == ON || is_isolate_initiator(t)
+            || t == PDI);
+  }
+
+  // The strong direction a resolved type counts as in N0 to N2, or ON
+  inline uint8_t
+  strong_direction(uint8_t t)
+  {
+    switch (t) {
+    case L:
+      return L;
+    case R:
+    case EN:
+    case AN:
+      return R;
+    default:
+      return ON;
+    }
+  }
+
+  inline bool
+  may_be_bracket(codepoint cp)
+  {
+    return (cp >= 0x80 || cp == '(' || cp == ')' || cp == '[' || cp == ']'
+            || cp == '{' || cp == '}');
+  }
+
+  // BD16 compares brackets after canonical decomposition
+  inline codepoint
+  canonical_bracket(codepoint cp)
+  {
+    switch (cp) {
+    case 0x2329: return 0x3008;
+    case 0x232a: return 0x3009;
+    default:     return cp;
+    }
+  }
+
+  inline unsigned
+  next_odd_level(unsigned level)
+  {
+    return (level + 1) | 1;
+  }
+
+  inline unsigned
+  next_even_level(unsigned level)
+  {
+    return (level + 2) & ~1u;
+  }
+
+  // The classes that mean text needs the Bidi algorithm (see needs_bidi())
+  inline bool
+  is_rtl_or_control(uint8_t c)
+  {
+    switch (c) {
+    case R: case AL: case AN:
+    case LRE: case RLE: case LRO: case RLO: case PDF:
+    case LRI: case RLI: case FSI: case PDI:
+      return true;
+    default:
+      return false;
+    }
+  }
+
+  /* None of those classes occur below U+0590, so needs_bidi() skips code
+     units that can't start such a code point a block at a time.  In UTF-8
+     that means bytes below 0xd6, which includes every continuation byte,
+     so we only ever stop on a lead byte. */
+  const uint32_t first_rtl = 0x0590;
+  const uint8_t first_rtl_utf8 = 0xc0 | (first_rtl >> 6);
+
+  size_t
+  ltr_span(const char *ptr, size_t len)
+  {
+    size_t n = 0;
+
+#ifdef __SSE2__
+    const __m128i limit = _mm_set1_epi8(char(first_rtl_utf8));
+
+    // A byte is >= the limit if it is unchanged by taking the maximum
+    while (len - n >= 16) {
+      __m128i v = _mm_loadu_si128((const __m128i *)(ptr + n));
+      if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(v, limit), v)))
+        break;
+      n += 16;
+    }
+#endif
+
+    /* Adding (0x100 - first_rtl_utf8) to the low seven bits of each byte
+       sets the top bit if they are >= (first_rtl_utf8 - 0x80), and can't
+       carry; the byte is >= first_rtl_utf8 if its own top bit is set too. */
+    while (len - n >= 8) {
+      uint64_t w = ascii_load64(ptr + n);
+      uint64_t ge = ((w & ~ascii_high_bits)
+                     + (0x100 - first_rtl_utf8) * ascii_ones);
+      if (ge & w & ascii_high_bits)
+        break;
+      n += 8;
+    }
+
+    while (n < len && uint8_t(ptr[n]) < first_rtl_utf8)
+      ++n;
+
+    return n;
+  }
+
+  size_t
+  ltr_span(const char16_t *ptr, size_t len)
+  {
+    size_t n = 0;
+
+#ifdef __SSE2__
+    const __m128i limit = _mm_set1_epi16(first_rtl - 1);
+    const __m128i zero = _mm_setzero_si128();
+
+    // Saturating subtraction leaves zero in the units below first_rtl
+    while (len - n >= 8) {
+      __m128i v = _mm_loadu_si128((const __m128i *)(ptr + n));
+      __m128i below = _mm_cmpeq_epi16(_mm_subs_epu16(v, limit), zero);
+      if (_mm_movemask_epi8(below) != 0xffff)
+        break;
+      n += 8;
+    }
+#endif
+
+    while (n < len && ptr[n] < first_rtl)
+      ++n;
+
+    return n;
+  }
+
+  size_t
+  ltr_span(const char32_t *ptr, size_t len)
+  {
+    size_t n = 0;
+    while (n < len && ptr[n] < first_rtl)
+      ++n;
+    return n;
+  }
+
+  template <class Codec>
+  bool
+  text_needs_bidi(const database &db, const struct ucd_trie *ptrie,
+                  const text &txt)
+  {
+    typedef typename Codec::code_unit code_unit;
+
+    const code_unit *ptr = text_begin<Codec>(txt);
+    const code_unit *end = text_end<Codec>(txt);
+
+    while (ptr < end) {
+      ptr += ltr_span(ptr, end - ptr);
+      if (ptr == end)
+        break;
+
+      codepoint cp = Codec::decode(ptr, end);
+
+      if (ptrie ? ucd_trie_lookup(ptrie, cp)
+          : is_rtl_or_control(uint8_t(db.bidi_class(cp))))
+        return true;
+    }
+
+    return false;
+  }
+
+}
+
+bool
+database::needs_bidi(const text &txt) const
+{
+  const struct ucd_trie *ptrie = _pimpl->get_rtlt();
+  bool result = false;
+
+  UCD_TEXT_DISPATCH(txt, result = text_needs_bidi, (*this, ptrie, txt));
+
+  return result;
+}
+
+bidi_workspace::bidi_workspace(const database &db)
+  : _db(db), _paragraph_level(0)
+{
+}
+
+/* If classify is false, the text doesn't need the Bidi algorithm, so we
+   don't bother looking up the classes; as everything is at level 0, L1
+   won't care what they are. */
+template <class Codec>
+void
+bidi_workspace::decode(const text &txt, bool classify)
+{
+  typedef typename Codec::code_unit code_unit;
+
+  const code_unit *begin = text_begin<Codec>(txt);
+  const code_unit *end = text_end<Codec>(txt);
+  const code_unit *ptr = begin;
+
+  _cps.clear();
+  _offsets.clear();
+  _classes.clear();
+
+  while (ptr < end) {
+    _offsets.push_back(ptr - begin);
+
+    codepoint cp = Codec::decode(ptr, end);
+
+    _cps.push_back(cp);
+    if (!classify)
+      _classes.push_back(L);
+    else if (cp < 0x80)
+      _classes.push_back(ascii_classes[cp]);
+    else
+      _classes.push_back(uint8_t(_db.bidi_class(cp)));
+  }
+
+  _offsets.push_back(end - begin);
+
+  _types.assign(_classes.begin(), _classes.end());
+  _levels.assign(_cps.size(), 0);
+  _matching.assign(_cps.size(), npos);
+}
+
+// BD9: match isolate initiators with PDIs
+void
+bidi_workspace::match_isolates()
+{
+  std::vector<size_t> &open = _sequence;
+
+  open.clear();
+
+  for (size_t n = 0; n < _classes.size(); ++n) {
+    uint8_t c = _classes[n];
+
+    if (is_isolate_initiator(c))
+      open.push_back(n);
+    else if (c == PDI && !open.empty()) {
+      _matching[n] = open.back();
+      _matching[open.back()] = n;
+      open.pop_back();
+    } else if (c == B)
+      open.clear();
+  }
+}
+
+/* P2, P3: returns 0 or 1 for the first strong character between begin and
+   end, skipping isolates, or -1 if there isn't one. */
+int
+bidi_workspace::first_strong(size_t begin, size_t end) const
+{
+  for (size_t n = begin; n < end; ++n) {
+    uint8_t c = _classes[n];
+
+    if (c == L)
+      return 0;
+    if (c == R || c == AL)
+      return 1;
+    if (c == B)
+      break;
+    if (is_isolate_initiator(c)) {
+      if (_matching[n] == npos)
+        break;
+      n = _matching[n];
+    }
+  }
+
+  return -1;
+}
+
+// X1 to X8
+void
+bidi_workspace::resolve_explicit()
+{
+  unsigned depth = 0;
+  unsigned overflow_isolates = 0, overflow_embeddings = 0;
+  unsigned valid_isolates = 0;
+  size_t len = _classes.size();
+
+  _stack[0] = status{ uint8_t(_paragraph_level), ON, false };
+
+  for (size_t n = 0; n < len; ++n) {
+    uint8_t c = _classes[n];
+    const status &top = _stack[depth];
+
+    switch (c) {
+    case RLE:
+    case LRE:
+    case RLO:
+    case LRO:
+      {
+        unsigned level = (c == RLE || c == RLO
+                          ? next_odd_level(top.level)
+                          : next_even_level(top.level));
+        _levels[n] = top.level;
+        if (level <= max_depth && !overflow_isolates
+            && !overflow_embeddings) {
+          uint8_t override_class = c == RLO ? R : c == LRO ? L : ON;
+          _stack[++depth] = status{ uint8_t(level), override_class,
+                                    false };                         // X2-X5
+        } else if (!overflow_isolates)
+          ++overflow_embeddings;
+      }
+      break;
+
+    case RLI:
+    case LRI:
+    case FSI:
+      {
+        bool rtl = c == RLI;
+
+        if (c == FSI) {
+          size_t end = _matching[n] != npos ? _matching[n] : len;
+          rtl = first_strong(n + 1, end) == 1;                       // X5c
+        }
+
+        _levels[n] = top.level;
+        if (top.override_class != ON)
+          _types[n] = top.override_class;
+
+        unsigned level = (rtl
+                          ? next_odd_level(top.level)
+                          : next_even_level(top.level));
+        if (level <= max_depth && !overflow_isolates
+            && !overflow_embeddings) {
+          ++valid_isolates;
+          _stack[++depth] = status{ uint8_t(level), ON, true };   // X5a, X5b
+        } else
+          ++overflow_isolates;
+      }
+      break;
+
+    case PDI:
+      if (overflow_isolates)
+        --overflow_isolates;                                         // X6a
+      else if (valid_isolates) {
+        overflow_embeddings = 0;
+        while (!_stack[depth].isolate)
+          --depth;
+        --depth;
+        --valid_isolates;
+      }
+
+      _levels[n] = _stack[depth].level;
+      if (_stack[depth].override_class != ON)
+        _types[n] = _stack[depth].override_class;
+      break;
+
+    case PDF:
+      _levels[n] = top.level;
+      if (overflow_isolates)
+        ;                                                            // X7
+      else if (overflow_embeddings)
+        --overflow_embeddings;
+      else if (!top.isolate && depth)
+        --depth;
+      break;
+
+    case B:
+      _levels[n] = _paragraph_level;                                 // X8
+      break;
+
+    case BN:
+      _levels[n] = top.level;
+      break;
+
+    default:
+      _levels[n] = top.level;                                        // X6
+      if (top.override_class != ON)
+        _types[n] = top.override_class;
+      break;
+    }
+  }
+}
+
+// X9, X10, then W1 to I2 for each isolating run sequence
+void
+bidi_workspace::resolve_sequences()
+{
+  size_t len = _classes.size();
+
+  _kept.clear();
+  for (size_t n = 0; n < len; ++n) {
+    if (!is_removed(_classes[n]))
+      _kept.push_back(n);
+  }
+
+  _runs.clear();
+  for (size_t k = 0; k < _kept.size(); ++k) {
+    if (!k || _levels[_kept[k]] != _levels[_kept[k - 1]])
+      _runs.push_back(level_run{ k, k });
+    else
+      _runs.back().last = k;
+  }
+
+  // Finds the level run that starts with character n, or returns npos
+  auto run_starting_at = [this](size_t n) -> size_t {
+    auto kit = std::lower_bound(_kept.begin(), _kept.end(), n);
+    if (kit == _kept.end() || *kit != n)
+      return npos;
+    size_t k = kit - _kept.begin();
+    auto rit = std::lower_bound(_runs.begin(), _runs.end(), k,
+                                [](const level_run &run, size_t k) {
+                                  return run.first < k;
+                                });
+    if (rit == _runs.end() || rit->first != k)
+      return npos;
+    return rit - _runs.begin();
+  };
+
+  // Finds whether character n ends a level run
+  auto ends_run = [this](size_t n) -> bool {
+    auto kit = std::lower_bound(_kept.begin(), _kept.end(), n);
+    if (kit == _kept.end() || *kit != n)
+      return false;
+    size_t k = kit - _kept.begin();
+    return k + 1 == _kept.size() || _levels[_kept[k + 1]] != _levels[n];
+  };
+
+  for (size_t r = 0; r < _runs.size(); ++r) {
+    size_t first = _kept[_runs[r].first];
+
+    /* Runs that start with a PDI matching an isolate initiator at the end
+       of a run have already been dealt with, as part of the sequence that
+       the initiator belongs to. */
+    if (_classes[first] == PDI && _matching[first] != npos
+        && ends_run(_matching[first]))
+      continue;
+
+    _sequence.clear();
+
+    size_t last_run = r;
+    for (;;) {
+      const level_run &run = _runs[last_run];
+      for (size_t k = run.first; k <= run.last; ++k)
+        _sequence.push_back(_kept[k]);
+
+      size_t last = _kept[run.last];
+      if (!is_isolate_initiator(_classes[last]) || _matching[last] == npos)
+        break;
+
+      size_t next = run_starting_at(_matching[last]);
+      if (next == npos)
+        break;
+      last_run = next;
+    }
+
+    unsigned level = _levels[first];
+    size_t kfirst = _runs[r].first, klast = _runs[last_run].last;
+    size_t last = _sequence.back();
+    unsigned before = (kfirst
+                       ? _levels[_kept[kfirst - 1]] : _paragraph_level);
+    unsigned after = (is_isolate_initiator(_classes[last])
+                      || klast + 1 == _kept.size()
+                      ? _paragraph_level : _levels[_kept[klast + 1]]);
+    unsigned sos = (std::max(before, level) & 1) ? R : L;
+    unsigned eos = (std::max(after, level) & 1) ? R : L;
+
+    resolve_weak(sos);
+    resolve_brackets(sos, level);
+    resolve_neutral(sos, eos, level);
+  }
+
+  resolve_implicit();
+
+  // Give the removed characters the level of the character before them
+  for (size_t n = 0; n < len; ++n) {
+    if (is_removed(_classes[n]))
+      _levels[n] = n ? _levels[n - 1] : _paragraph_level;
+  }
+}
+
+// W1 to W7
+void
+bidi_workspace::resolve_weak(unsigned sos)
+{
+  size_t len = _sequence.size();
+  auto type = [this](size_t k) -> uint8_t & { return _types[_sequence[k]]; };
+
+  for (size_t k = 0; k < len; ++k) {
+    if (type(k) == NSM) {
+      if (!k)
+        type(k) = sos;
+      else {
+        uint8_t prev = _classes[_sequence[k - 1]];
+        type(k) = (is_isolate_initiator(prev) || prev == PDI
+                   ? uint8_t(ON) : type(k - 1));                     // W1
+      }
+    }
+  }
+
+  uint8_t last_strong = sos;
+  for (size_t k = 0; k < len; ++k) {
+    uint8_t t = type(k);
+
+    if (t == L || t == R)
+      last_strong = t;
+    else if (t == AL) {
+      last_strong = AL;
+      type(k) = R;                                                   // W3
+    } else if (t == EN && last_strong == AL)
+      type(k) = AN;                                                  // W2
+  }
+
+  for (size_t k = 1; k + 1 < len; ++k) {
+    uint8_t t = type(k), prev = type(k - 1), next = type(k + 1);
+
+    if (t == ES && prev == EN && next == EN)
+      type(k) = EN;                                                  // W4
+    else if (t == CS && prev == next && (prev == EN || prev == AN))
+      type(k) = prev;                                                // W4
+  }
+
+  for (size_t k = 0; k < len;) {
+    if (type(k) != ET) {
+      ++k;
+      continue;
+    }
+
+    size_t start = k;
+    while (k < len && type(k) == ET)
+      ++k;
+
+    if ((start && type(start - 1) == EN) || (k < len && type(k) == EN)) {
+      for (size_t j = start; j < k; ++j)
+        type(j) = EN;                                                // W5
+    }
+  }
+
+  for (size_t k = 0; k < len; ++k) {
+    uint8_t t = type(k);
+    if (t == ES || t == ET || t == CS)
+      type(k) = ON;                                                  // W6
+  }
+
+  last_strong = sos;
+  for (size_t k = 0; k < len; ++k) {
+    uint8_t t = type(k);
+
+    if (t == L || t == R)
+      last_strong = t;
+    else if (t == EN && last_strong == L)
+      type(k) = L;                                                   // W7
+  }
+}
+
+// BD16 and N0
+void
+bidi_workspace::resolve_brackets(unsigned sos, unsigned level)
+{
+  size_t len = _sequence.size();
+  auto type = [this](size_t k) -> uint8_t & { return _types[_sequence[k]]; };
+
+  _openers.clear();
+  _pairs.clear();
+
+  for (size_t k = 0; k < len; ++k) {
+    codepoint cp = _cps[_sequence[k]];
+
+    if (type(k) != ON || !may_be_bracket(cp))
+      continue;
+
+    bpt bracket_type;
+    codepoint paired = _db.bidi_paired_bracket(cp, bracket_type);
+
+    if (bracket_type == bpt::Open) {
+      if (_openers.size() == max_open_brackets)
+        break;
+      _openers.push_back(bracket{ canonical_bracket(paired), k });
+    } else if (bracket_type == bpt::Close) {
+      codepoint closing = canonical_bracket(cp);
+      for (size_t j = _openers.size(); j-- > 0;) {
+        if (_openers[j].closing == closing) {
+          _pairs.push_back(bracket_pair{ _openers[j].pos, k });
+          _openers.resize(j);
+          break;
+        }
+      }
+    }
+  }
+
+  std::sort(_pairs.begin(), _pairs.end());
+
+  uint8_t embedding = (level & 1) ? R : L;
+  uint8_t opposite = (level & 1) ? L : R;
+
+  // Sets the type of a bracket, and of any NSMs that follow it
+  auto set_type = [&](size_t k, uint8_t dir) {
+    type(k) = dir;
+    for (++k; k < len && _classes[_sequence[k]] == NSM; ++k)
+      type(k) = dir;
+  };
+
+  for (const bracket_pair &pair : _pairs) {
+    bool found_embedding = false, found_opposite = false;
+
+    for (size_t k = pair.open + 1; k < pair.close; ++k) {
+      uint8_t dir = strong_direction(type(k));
+      if (dir == embedding) {
+        found_embedding = true;
+        break;
+      } else if (dir == opposite)
+        found_opposite = true;
+    }
+
+    uint8_t dir;
+
+    if (found_embedding)
+      dir = embedding;                                               // N0b
+    else if (found_opposite) {
+      uint8_t context = sos;
+      for (size_t k = pair.open; k-- > 0;) {
+        uint8_t d = strong_direction(type(k));
+        if (d != ON) {
+          context = d;
+          break;
+        }
+      }
+      dir = context == opposite ? opposite : embedding;              // N0c
+    } else
+      continue;                                                      // N0d
+
+    set_type(pair.open, dir);
+    set_type(pair.close, dir);
+  }
+}
+
+// N1, N2
+void
+bidi_workspace::resolve_neutral(unsigned sos, unsigned eos, unsigned level)
+{
+  size_t len = _sequence.size();
+  auto type = [this](size_t k) -> uint8_t & { return _types[_sequence[k]]; };
+  uint8_t embedding = (level & 1) ? R : L;
+
+  for (size_t k = 0; k < len;) {
+    if (!is_ni(type(k))) {
+      ++k;
+      continue;
+    }
+
+    size_t start = k;
+    while (k < len && is_ni(type(k)))
+      ++k;
+
+    uint8_t before = start ? strong_direction(type(start - 1)) : sos;
+    uint8_t after = k < len ? strong_direction(type(k)) : eos;
+    uint8_t dir = before == after ? before : embedding;             // N1, N2
+
+    for (size_t j = start; j < k; ++j)
+      type(j) = dir;
+  }
+}
+
+// I1, I2
+void
+bidi_workspace::resolve_implicit()
+{
+  for (size_t n : _kept) {
+    uint8_t t = _types[n];
+
+    if (!(_levels[n] & 1)) {
+      if (t == R)
+        _levels[n] += 1;                                             // I1
+      else if (t == AN || t == EN)
+        _levels[n] += 2;
+    } else if (t == L || t == EN || t == AN)
+      _levels[n] += 1;                                               // I2
+  }
+}
+
+void
+bidi_workspace::resolve(const text &txt, direction dir)
+{
+  /* Without any right-to-left characters, numbers or controls, a
+     left-to-right paragraph stays at level 0 throughout (W7 turns any
+     European numbers into L), so we can skip straight to the end. */
+  if (dir != direction::rtl && !_db.needs_bidi(txt)) {
+    UCD_TEXT_DISPATCH(txt, decode, (txt, false));
+
+    _paragraph_level = 0;
+    _order.clear();
+    _line_levels.clear();
+    return;
+  }
+
+  UCD_TEXT_DISPATCH(txt, decode, (txt, true));
+
+  match_isolates();
+
+  switch (dir) {
+  case direction::ltr:
+    _paragraph_level = 0;
+    break;
+  case direction::rtl:
+    _paragraph_level = 1;
+    break;
+  case direction::automatic:
+    _paragraph_level = first_strong(0, _classes.size()) == 1 ? 1 : 0;
+    break;
+  }
+
+  resolve_explicit();
+  resolve_sequences();
+
+  _order.clear();
+  _line_levels.clear();
+}
+
+// L1, L2
+const size_t *
+bidi_workspace::reorder(size_t first, size_t last)
+{
+  if (last > _levels.size())
+    last = _levels.size();
+  if (first > last)
+    first = last;
+
+  size_t len = last - first;
+
+  _line_levels.assign(_levels.begin() + first, _levels.begin() + last);
+
+  bool trailing = true;
+  for (size_t k = len; k-- > 0;) {
+    uint8_t c = _classes[first + k];
+
+    if (c == S || c == B) {
+      _line_levels[k] = _paragraph_level;
+      trailing = true;
+    } else if (trailing && (c == WS || is_isolate_initiator(c) || c == PDI
+                            || is_removed(c)))
+      _line_levels[k] = _paragraph_level;
+    else
+      trailing = false;
+  }
+
+  _order.resize(len);
+  for (size_t k = 0; k < len; ++k)
+    _order[k] = first + k;
+
+  if (!len)
+    return _order.data();
+
+  unsigned highest = *std::max_element(_line_levels.begin(),
+                                       _line_levels.end());
+  unsigned lowest_odd = *std::min_element(_line_levels.begin(),
+                                          _line_levels.end()) | 1;
+
+  for (unsigned level = highest; level >= lowest_odd; --level) {
+    for (size_t k = 0; k < len;) {
+      if (_line_levels[k] < level) {
+        ++k;
+        continue;
+      }
+
+      size_t start = k;
+      while (k < len && _line_levels[k] >= level)
+        ++k;
+
+      std::reverse(_order.begin() + start, _order.begin() + k);
+    }
+  }
+
+  return _order.data();
+}
@@ -0,0 +1,1087 @@
+#include <algorithm>
+#include <string>
+
+#include <libucd/libucd.h>
+#include "ucd-format.h"
+#include "ucd-impl.h"
+#include "ucd-trie.h"
+#include "ucd-ascii.h"
+#include "ucd-output.h"
+
+using namespace ucd;
+
+namespace {
+
+  enum class case_kind {
+    upper,
+    lower,
+    title,
+    fold
+  };
+
+  enum class case_language {
+    root,
+    lithuanian,
+    turkic
+  };
+
+  // No full case mapping is longer than three code points
+  enum {
+    max_mapping = 3
+  };
+
+  const codepoint LATIN_CAPITAL_I = 0x0049;
+  const codepoint LATIN_SMALL_I = 0x0069;
+  const codepoint LATIN_CAPITAL_I_WITH_DOT_ABOVE = 0x0130;
+  const codepoint LATIN_SMALL_DOTLESS_I = 0x0131;
+  const codepoint COMBINING_DOT_ABOVE = 0x0307;
+  const codepoint GREEK_CAPITAL_SIGMA = 0x03a3;
+  const codepoint GREEK_SMALL_FINAL_SIGMA = 0x03c2;
+
+  case_language
+  language_from_code(const char *language)
+  {
+    if (!language || !language[0] || !language[1])
+      return case_language::root;
+
+    // Only the primary language subtag matters
+    if (language[2] && language[2] != '-' && language[2] != '_')
+      return case_language::root;
+
+    char a = language[0], b = language[1];
+
+    if (a >= 'A' && a <= 'Z')
+      a = a - 'A' + 'a';
+    if (b >= 'A' && b <= 'Z')
+      b = b - 'A' + 'a';
+
+    if (a == 'l' && b == 't')
+      return case_language::lithuanian;
+    if ((a == 't' && b == 'r') || (a == 'a' && b == 'z'))
+      return case_language::turkic;
+
+    return case_language::root;
+  }
+
+  struct case_tries {
+    const struct ucd_case_trie *upper;
+    const struct ucd_case_trie *lower;
+    const struct ucd_case_trie *title;
+    const struct ucd_case_trie *fold;
+  };
+
+  size_t
+  full_mapping(const database &db, const case_tries &tries,
+               case_kind kind, codepoint cp, codepoint *out)
+  {
+    const struct ucd_case_trie *ptrie = nullptr;
+    size_t count = 0;
+
+    switch (kind) {
+    case case_kind::upper: ptrie = tries.upper; break;
+    case case_kind::lower: ptrie = tries.lower; break;
+    case case_kind::title: ptrie = tries.title; break;
+    case case_kind::fold:  ptrie = tries.fold;  break;
+    }
+
+    if (ptrie) {
+      count = ucd_case_trie_mapping(ptrie, cp, false, out, max_mapping);
+      return std::min(count, (size_t)max_mapping);
+    }
+
+    // Older data files don't have the tries
+    switch (kind) {
+    case case_kind::upper:
+      count = db.uppercase_mapping(cp, out, max_mapping);
+      break;
+    case case_kind::lower:
+      count = db.lowercase_mapping(cp, out, max_mapping);
+      break;
+    case case_kind::title:
+      count = db.titlecase_mapping(cp, out, max_mapping);
+      break;
+    case case_kind::fold:
+      count = db.case_folding(cp, out, max_mapping);
+      break;
+    }
+
+    return std::min(count, (size_t)max_mapping);
+  }
+
+  template <class Codec>
+  class case_converter {
+  public:
+    typedef typename Codec::code_unit code_unit;
+
+  private:
+    const database  &_db;
+    case_tries       _tries;
+    case_language    _lang;
+    const code_unit *_begin;
+    const code_unit *_end;
+
+  public:
+    case_converter(const database &db, const case_tries &tries,
+                   const char *language,
+                   const code_unit *in, size_t len)
+      : _db(db), _tries(tries), _lang(language_from_code(language)),
+        _begin(in), _end(in + len) {}
+
+    size_t convert(case_kind kind, code_unit *out, size_t out_len) const {
+      output_buffer<Codec> buf(out, out_len);
+
+      if (kind == case_kind::title)
+        titlecase(buf);
+      else
+        convert(kind, buf);
+
+      return buf.length();
+    }
+
+  private:
+    bool special_mapping(case_kind kind, codepoint cp,
+                         const code_unit *start, const code_unit *next,
+                         codepoint *out, size_t &count) const;
+    size_t mapping(case_kind kind, codepoint cp,
+                   const code_unit *start, const code_unit *next,
+                   codepoint *out) const {
+      size_t count;
+      if (special_mapping(kind, cp, start, next, out, count))
+        return count;
+      return full_mapping(_db, _tries, kind, cp, out);
+    }
+
+    bool is_final_sigma(const code_unit *start, const code_unit *next) const;
+    bool is_after_soft_dotted(const code_unit *start) const;
+    bool is_more_above(const code_unit *next) const;
+    bool is_before_dot(const code_unit *next) const;
+    bool is_after_I(const code_unit *start) const;
+
+    const code_unit *next_word_boundary(const code_unit *ptr) const;
+
+    void convert(case_kind kind, output_buffer<Codec> &buf) const;
+    void titlecase(output_buffer<Codec> &buf) const;
+  };
+
+  /* The conditional mappings from SpecialCasing.txt; the contexts are
+     defined in Table 3-17 of the Unicode Standard. */
+  template <class Codec>
+  bool
+  case_converter<Codec>::special_mapping(case_kind kind, codepoint cp,
+                                         const code_unit *start,
+                                         const code_unit *next,
+                                         codepoint *out,
+                                         size_t &count) const
+  {
+    if (kind == case_kind::fold)
+      return false;
+
+    if (cp == GREEK_CAPITAL_SIGMA) {
+      if (kind == case_kind::lower && is_final_sigma(start, next)) {
+        out[0] = GREEK_SMALL_FINAL_SIGMA;
+        count = 1;
+        return true;
+      }
+      return false;
+    }
+
+    switch (_lang) {
+    case case_language::root:
+      return false;
+
+    case case_language::lithuanian:
+      if (kind != case_kind::lower) {
+        // Remove DOT ABOVE after "i" with upper or titlecase
+        if (cp == COMBINING_DOT_ABOVE && is_after_soft_dotted(start)) {
+          count = 0;
+          return true;
+        }
+        return false;
+      }
+
+      /* Introduce an explicit dot above when lowercasing capital I's and
+         J's whenever there are more accents above */
+      switch (cp) {
+      case 0x0049:
+      case 0x004a:
+      case 0x012e:
+        if (!is_more_above(next))
+          return false;
+        out[0] = cp == 0x012e ? 0x012f : cp + 0x20;
+        out[1] = COMBINING_DOT_ABOVE;
+        count = 2;
+        return true;
+      case 0x00cc:
+      case 0x00cd:
+      case 0x0128:
+        out[0] = LATIN_SMALL_I;
+        out[1] = COMBINING_DOT_ABOVE;
+        out[2] = cp == 0x00cc ? 0x0300 : cp == 0x00cd ? 0x0301 : 0x0303;
+        count = 3;
+        return true;
+      }
+      return false;
+
+    case case_language::turkic:
+      if (kind != case_kind::lower) {
+        // When uppercasing, i turns into a dotted capital I
+        if (cp == LATIN_SMALL_I) {
+          out[0] = LATIN_CAPITAL_I_WITH_DOT_ABOVE;
+          count = 1;
+          return true;
+        }
+        return false;
+      }
+
+      switch (cp) {
+      case LATIN_CAPITAL_I_WITH_DOT_ABOVE:
+        out[0] = LATIN_SMALL_I;
+        count = 1;
+        return true;
+      case COMBINING_DOT_ABOVE:
+        // Remove dot_above in the sequence I + dot_above
+        if (!is_after_I(start))
+          return false;
+        count = 0;
+        return true;
+      case LATIN_CAPITAL_I:
+        // Unless an I is before a dot_above, it turns into a dotless i
+        if (is_before_dot(next))
+          return false;
+        out[0] = LATIN_SMALL_DOTLESS_I;
+        count = 1;
+        return true;
+      }
+      return false;
+    }
+
+    return false;
+  }
+
+  /* C is preceded by a sequence consisting of a cased letter and then zero
+     or more case-ignorable characters, and C is not followed by a sequence
+     consisting of zero or more case-ignorable characters and then a cased
+     letter. */
+  template <class Codec>
+  bool
+  case_converter<Codec>::is_final_sigma(const code_unit *start,
+                                        const code_unit *next) const
+  {
+    const code_unit *ptr = start;
+    bool after_cased = false;
+
+    while (ptr > _begin) {
+      codepoint cp = Codec::decode_prev(_begin, ptr);
+      if (_db.case_ignorable(cp))
+        continue;
+      after_cased = _db.cased(cp);
+      break;
+    }
+
+    if (!after_cased)
+      return false;
+
+    ptr = next;
+    while (ptr < _end) {
+      codepoint cp = Codec::decode(ptr, _end);
+      if (_db.case_ignorable(cp))
+        continue;
+      return !_db.cased(cp);
+    }
+
+    return true;
+  }
+
+  /* There is a Soft_Dotted character before C, with no intervening
+     character of combining class 0 or 230 (Above). */
+  template <class Codec>
+  bool
+  case_converter<Codec>::is_after_soft_dotted(const code_unit *start) const
+  {
+    const code_unit *ptr = start;
+
+    while (ptr > _begin) {
+      codepoint cp = Codec::decode_prev(_begin, ptr);
+      if (_db.soft_dotted(cp))
+        return true;
+      ccc c = _db.canonical_combining_class(cp);
+      if (c == 0 || c == 230)
+        return false;
+    }
+
+    return false;
+  }
+
+  /* C is followed by a character of combining class 230 (Above) with no
+     intervening character of combining class 0. */
+  template <class Codec>
+  bool
+  case_converter<Codec>::is_more_above(const code_unit *next) const
+  {
+    const code_unit *ptr = next;
+
+    while (ptr < _end) {
+      ccc c = _db.canonical_combining_class(Codec::decode(ptr, _end));
+      if (c == 230)
+        return true;
+      if (c == 0)
+        return false;
+    }
+
+    return false;
+  }
+
+  /* C is followed by COMBINING DOT ABOVE (U+0307), with no intervening
+     character of combining class 0 or 230 (Above). */
+  template <class Codec>
+  bool
+  case_converter<Codec>::is_before_dot(const code_unit *next) const
+  {
+    const code_unit *ptr = next;
+
+    while (ptr < _end) {
+      codepoint cp = Codec::decode(ptr, _end);
+      if (cp == COMBINING_DOT_ABOVE)
+        return true;
+      ccc c = _db.canonical_combining_class(cp);
+      if (c == 0 || c == 230)
+        return false;
+    }
+
+    return false;
+  }
+
+  /* There is an uppercase I before C, with no intervening character of
+     combining class 0 or 230 (Above). */
+  template <class Codec>
+  bool
+  case_converter<Codec>::is_after_I(const code_unit *start) const
+  {
+    const code_unit *ptr = start;
+
+    while (ptr > _begin) {
+      codepoint cp = Codec::decode_prev(_begin, ptr);
+      if (cp == LATIN_CAPITAL_I)
+        return true;
+      ccc c = _db.canonical_combining_class(cp);
+      if (c == 0 || c == 230)
+        return false;
+    }
+
+    return false;
+  }
+
+  bool
+  is_ahletter(WB wb)
+  {
+    return wb == WB::ALetter || wb == WB::Hebrew_Letter;
+  }
+
+  bool
+  is_ignored(WB wb)
+  {
+    return wb == WB::Extend || wb == WB::Format || wb == WB::ZWJ;
+  }
+
+  /* Titlecasing needs the word boundaries from UAX #29; we implement the
+     rules that matter for cased text here (WB3 through WB13b); the emoji
+     and regional indicator rules don't affect the result, because those
+     characters are not cased. */
+  template <class Codec>
+  const typename Codec::code_unit *
+  case_converter<Codec>::next_word_boundary(const code_unit *ptr) const
+  {
+    WB prev = _db.word_break(Codec::decode(ptr, _end));
+
+    // WB3, WB3a
+    if (prev == WB::CR) {
+      const code_unit *next = ptr;
+      if (next < _end && Codec::decode(next, _end) == '\n')
+        return next;
+      return ptr;
+    }
+    if (prev == WB::LF || prev == WB::Newline)
+      return ptr;
+
+    while (ptr < _end) {
+      const code_unit *here = ptr;
+      WB cur = _db.word_break(Codec::decode(ptr, _end));
+
+      // WB3b
+      if (cur == WB::CR || cur == WB::LF || cur == WB::Newline)
+        return here;
+
+      // WB4
+      if (is_ignored(cur))
+        continue;
+
+      // WB6, WB7, WB7b, WB7c, WB11, WB12
+      WB want = WB::XX;
+      if (is_ahletter(prev) && (cur == WB::MidLetter || cur == WB::MidNumLet
+                                || cur == WB::Single_Quote))
+        want = WB::ALetter;
+      else if (prev == WB::Numeric && (cur == WB::MidNum
+                                       || cur == WB::MidNumLet
+                                       || cur == WB::Single_Quote))
+        want = WB::Numeric;
+      else if (prev == WB::Hebrew_Letter && cur == WB::Double_Quote)
+        want = WB::Hebrew_Letter;
+
+      if (want != WB::XX) {
+        const code_unit *after_mid = ptr;
+        const code_unit *look = ptr;
+        WB next = WB::XX;
+
+        while (look < _end) {
+          next = _db.word_break(Codec::decode(look, _end));
+          if (!is_ignored(next))
+            break;
+          after_mid = look;
+        }
+
+        if (next == want || (want == WB::ALetter && is_ahletter(next))) {
+          ptr = after_mid;
+          continue;
+        }
+      }
+
+      bool join;
+      switch (cur) {
+      case WB::ALetter:
+      case WB::Hebrew_Letter:
+        // WB5, WB10, WB13b
+        join = (is_ahletter(prev) || prev == WB::Numeric
+                || prev == WB::ExtendNumLet);
+        break;
+      case WB::Numeric:
+        // WB8, WB9, WB13b
+        join = (is_ahletter(prev) || prev == WB::Numeric
+                || prev == WB::ExtendNumLet);
+        break;
+      case WB::Katakana:
+        // WB13, WB13b
+        join = prev == WB::Katakana || prev == WB::ExtendNumLet;
+        break;
+      case WB::ExtendNumLet:
+        // WB13a
+        join = (is_ahletter(prev) || prev == WB::Numeric
+                || prev == WB::Katakana || prev == WB::ExtendNumLet);
+        break;
+      case WB::Single_Quote:
+        // WB7a
+        join = prev == WB::Hebrew_Letter;
+        break;
+      default:
+        join = false;
+        break;
+      }
+
+      if (!join)
+        return here;
+
+      prev = cur;
+    }
+
+    return ptr;
+  }
+
+  template <class Codec>
+  void
+  case_converter<Codec>::convert(case_kind kind,
+                                 output_buffer<Codec> &buf) const
+  {
+    const code_unit *ptr = _begin;
+    codepoint mapped[max_mapping];
+
+    while (ptr < _end) {
+      /* None of the language specific rules apply to ASCII, so we can deal
+         with it in bulk */
+      if (_lang == case_language::root) {
+        size_t count = ascii_span(ptr, _end - ptr);
+
+        if (count) {
+          code_unit *dst = buf.reserve(count);
+          if (dst) {
+            if (kind == case_kind::upper)
+              ascii_toupper(ptr, dst, count);
+            else
+              ascii_tolower(ptr, dst, count);
+          }
+          ptr += count;
+          continue;
+        }
+      }
+
+      const code_unit *start = ptr;
+      codepoint cp = Codec::decode(ptr, _end);
+
+      buf.put(mapped, mapping(kind, cp, start, ptr, mapped));
+    }
+  }
+
+  /* For each word, titlecase the first cased character and lowercase the
+     characters that follow it; anything before it is left alone. */
+  template <class Codec>
+  void
+  case_converter<Codec>::titlecase(output_buffer<Codec> &buf) const
+  {
+    const code_unit *ptr = _begin;
+    codepoint mapped[max_mapping];
+
+    while (ptr < _end) {
+      const code_unit *word_end = next_word_boundary(ptr);
+      bool seen_cased = false;
+
+      while (ptr < word_end) {
+        const code_unit *start = ptr;
+        codepoint cp = Codec::decode(ptr, _end);
+
+        if (seen_cased) {
+          buf.put(mapped, mapping(case_kind::lower, cp, start, ptr, mapped));
+        } else if (_db.cased(cp)) {
+          buf.put(mapped, mapping(case_kind::title, cp, start, ptr, mapped));
+          seen_cased = true;
+        } else {
+          buf.put(cp);
+        }
+      }
+    }
+  }
+
+  template <class Codec, class String>
+  String
+  convert_string(const database &db, const case_tries &tries,
+                 case_kind kind, const char *language, const String &str)
+  {
+    case_converter<Codec> cvt(db, tries, language, str.data(), str.size());
+    String result(str.size(), 0);
+    size_t len = cvt.convert(kind, &result[0], result.size());
+
+    if (len > result.size()) {
+      result.resize(len);
+      cvt.convert(kind, &result[0], result.size());
+    } else {
+      result.resize(len);
+    }
+
+    return result;
+  }
+
+  /* Produces the case folded form of a string one code point at a time,
+     so that we can compare or hash strings without folding them first. */
+  template <class Codec>
+  class folding_reader {
+  public:
+    typedef typename Codec::code_unit code_unit;
+
+  private:
+    const database  &_db;
+    case_tries       _tries;
+    const code_unit *_ptr;
+    const code_unit *_end;
+    codepoint        _pending[max_mapping];
+    size_t           _pos, _count;
+
+  public:
+    folding_reader(const database &db, const case_tries &tries,
+                   const code_unit *in, size_t len)
+      : _db(db), _tries(tries), _ptr(in), _end(in + len),
+        _pos(0), _count(0) {}
+
+    // True if we aren't part way through the folding of a code point
+    bool idle() const { return _pos == _count; }
+
+    const code_unit *ptr() const { return _ptr; }
+    size_t remaining() const { return _end - _ptr; }
+    void skip(size_t count) { _ptr += count; }
+
+    bool next(codepoint &cp) {
+      while (_pos == _count) {
+        if (_ptr == _end)
+          return false;
+        _count = full_mapping(_db, _tries, case_kind::fold,
+                              Codec::decode(_ptr, _end), _pending);
+        _pos = 0;
+      }
+      cp = _pending[_pos++];
+      return true;
+    }
+  };
+
+  template <class Codec>
+  int
+  casefold_compare(const database &db, const case_tries &tries,
+                   const typename Codec::code_unit *a, size_t a_len,
+                   const typename Codec::code_unit *b, size_t b_len)
+  {
+    folding_reader<Codec> ra(db, tries, a, a_len);
+    folding_reader<Codec> rb(db, tries, b, b_len);
+
+    for (;;) {
+      if (ra.idle() && rb.idle()) {
+        size_t count = ascii_casefold_match(ra.ptr(), rb.ptr(),
+                                            std::min(ra.remaining(),
+                                                     rb.remaining()));
+        ra.skip(count);
+        rb.skip(count);
+      }
+
+      codepoint ca, cb;
+      bool have_a = ra.next(ca), have_b = rb.next(cb);
+
+      if (!have_a || !have_b)
+        return int(have_a) - int(have_b);
+      if (ca != cb)
+        return ca < cb ? -1 : 1;
+    }
+  }
+
+  /* This is FNV-1a over the UTF-8 encoding of the case folded string, so
+     the result doesn't depend on the encoding of the input. */
+  const uint64_t fnv_offset_basis = 0xcbf29ce484222325ull;
+  const uint64_t fnv_prime = 0x100000001b3ull;
+
+  template <class T>
+  inline uint64_t
+  fnv1a_ascii_lower(uint64_t hash, const T *ptr, size_t len)
+  {
+    for (size_t n = 0; n < len; ++n) {
+      T ch = ptr[n];
+      if (ch >= 'A' && ch <= 'Z')
+        ch += 'a' - 'A';
+      hash = (hash ^ uint8_t(ch)) * fnv_prime;
+    }
+    return hash;
+  }
+
+  inline uint64_t
+  fnv1a_ascii_lower(uint64_t hash, const char *ptr, size_t len)
+  {
+    char lower[64];
+
+    while (len) {
+      size_t chunk = std::min(len, sizeof(lower));
+      ascii_tolower(ptr, lower, chunk);
+      for (size_t n = 0; n < chunk; ++n)
+        hash = (hash ^ uint8_t(lower[n])) * fnv_prime;
+      ptr += chunk;
+      len -= chunk;
+    }
+
+    return hash;
+  }
+
+  template <class Codec>
+  size_t
+  casefold_hash(const database &db, const case_tries &tries,
+                const typename Codec::code_unit *in, size_t len)
+  {
+    const typename Codec::code_unit *ptr = in, *end = in + len;
+    uint64_t hash = fnv_offset_basis;
+    codepoint folded[max_mapping];
+
+    while (ptr < end) {
+      size_t count = ascii_span(ptr, end - ptr);
+      if (count) {
+        hash = fnv1a_ascii_lower(hash, ptr, count);
+        ptr += count;
+        continue;
+      }
+
+      count = full_mapping(db, tries, case_kind::fold,
+                           Codec::decode(ptr, end), folded);
+      for (size_t n = 0; n < count; ++n) {
+        char utf8[utf8_codec::max_length];
+        unsigned ulen = utf8_codec::encode(folded[n], utf8);
+        for (unsigned m = 0; m < ulen; ++m)
+          hash = (hash ^ uint8_t(utf8[m])) * fnv_prime;
+      }
+    }
+
+    return size_t(hash);
+  }
+
+}
+
+#define CASE_TRIES                                                      \
+  case_tries { _pimpl->get_CASt(), _pimpl->get_cast(), _pimpl->get_Cast(), \
+               _pimpl->get_csft() }
+
+#define CASE_FNS(fn,kind)                                               \
+size_t                                                                  \
+database::fn(const char *in, size_t len, char *out, size_t out_len,     \
+             const char *language) const                                \
+{                                                                       \
+  return case_converter<utf8_codec>(*this, CASE_TRIES, language,        \
+                                    in, len).convert(kind, out, out_len); \
+}                                                                       \
+                                                                        \
+size_t                                                                  \
+database::fn(const char16_t *in, size_t len, char16_t *out,             \
+             size_t out_len, const char *language) const                \
+{                                                                       \
+  return case_converter<utf16_codec>(*this, CASE_TRIES, language,       \
+                                     in, len).convert(kind, out, out_len); \
+}                                                                       \
+                                                                        \
+size_t                                                                  \
+database::fn(const char32_t *in, size_t len, char32_t *out,             \
+             size_t out_len, const char *language) const                \
+{                                                                       \
+  return case_converter<utf32_codec>(*this, CASE_TRIES, language,       \
+                                     in, len).convert(kind, out, out_len); \
+}                                                                       \
+                                                                        \
+std::string                                                             \
+database::fn(const std::string &str, const char *language) const        \
+{                                                                       \
+  return convert_string<utf8_codec>(*this, CASE_TRIES, kind,            \
+                                    language, str);                     \
+}                                                                       \
+                                                                        \
+std::u16string                                                          \
+database::fn(const std::u16string &str, const char *language) const     \
+{                                                                       \
+  return convert_string<utf16_codec>(*this, CASE_TRIES, kind,           \
+                                     language, str);                    \
+}                                                                       \
+                                                                        \
+std::u32string                                                          \
+database::fn(const std::u32string &str, const char *language) const     \
+{                                                                       \
+  return convert_string<utf32_codec>(*this, CASE_TRIES, kind,           \
+                                     language, str);                    \
+}
+
+CASE_FNS(to_uppercase, case_kind::upper)
+CASE_FNS(to_lowercase, case_kind::lower)
+CASE_FNS(to_titlecase, case_kind::title)
+
+size_t
+database::fold_case(const char *in, size_t len,
+                    char *out, size_t out_len) const
+{
+  return case_converter<utf8_codec>(*this, CASE_TRIES, nullptr,
+                                    in, len).convert(case_kind::fold,
+                                                     out, out_len);
+}
+
+size_t
+database::fold_case(const char16_t *in, size_t len,
+                    char16_t *out, size_t out_len) const
+{
+  return case_converter<utf16_codec>(*this, CASE_TRIES, nullptr,
+                                     in, len).convert(case_kind::fold,
+                                                      out, out_len);
+}
+
+size_t
+database::fold_case(const char32_t *in, size_t len,
+                    char32_t *out, size_t out_len) const
+{
+  return case_converter<utf32_codec>(*this, CASE_TRIES, nullptr,
+                                     in, len).convert(case_kind::fold,
+                                                      out, out_len);
+}
+
+std::string
+database::fold_case(const std::string &str) const
+{
+  return convert_string<utf8_codec>(*this, CASE_TRIES, case_kind::fold,
+                                    nullptr, str);
+}
+
+std::u16string
+database::fold_case(const std::u16string &str) const
+{
+  return convert_string<utf16_codec>(*this, CASE_TRIES, case_kind::fold,
+                                     nullptr, str);
+}
+
+std::u32string
+database::fold_case(const std::u32string &str) const
+{
+  return convert_string<utf32_codec>(*this, CASE_TRIES, case_kind::fold,
+                                     nullptr, str);
+}
+
+int
+database::casefold_compare(const char *a, size_t a_len,
+                           const char *b, size_t b_len) const
+{
+  return ::casefold_compare<utf8_codec>(*this, CASE_TRIES,
+                                        a, a_len, b, b_len);
+}
+
+int
+database::casefold_compare(const char16_t *a, size_t a_len,
+                           const char16_t *b, size_t b_len) const
+{
+  return ::casefold_compare<utf16_codec>(*this, CASE_TRIES,
+                                         a, a_len, b, b_len);
+}
+
+int
+database::casefold_compare(const char32_t *a, size_t a_len,
+                           const char32_t *b, size_t b_len) const
+{
+  return ::casefold_compare<utf32_codec>(*this, CASE_TRIES,
+                                         a, a_len, b, b_len);
+}
+
+int
+database::casefold_compare(const std::string &a,
+                           const std::string &b) const
+{
+  return casefold_compare(a.data(), a.size(), b.data(), b.size());
+}
+
+int
+database::casefold_compare(const std::u16string &a,
+                           const std::u16string &b) const
+{
+  return casefold_compare(a.data(), a.size(), b.data(), b.size());
+}
+
+int
+database::casefold_compare(const std::u32string &a,
+                           const std::u32string &b) const
+{
+  return casefold_compare(a.data(), a.size(), b.data(), b.size());
+}
+
+size_t
+database::casefold_hash(const char *in, size_t len) const
+{
+  return ::casefold_hash<utf8_codec>(*this, CASE_TRIES, in, len);
+}
+
+size_t
+database::casefold_hash(const char16_t *in, size_t len) const
+{
+  return ::casefold_hash<utf16_codec>(*this, CASE_TRIES, in, len);
+}
+
+size_t
+database::casefold_hash(const char32_t *in, size_t len) const
+{
+  return ::casefold_hash<utf32_codec>(*this, CASE_TRIES, in, len);
+}
+
+size_t
+database::casefold_hash(const std::string &str) const
+{
+  return casefold_hash(str.data(), str.size());
+}
+
+size_t
+database::casefold_hash(const std::u16string &str) const
+{
+  return casefold_hash(str.data(), str.size());
+}
+
+size_t
+database::casefold_hash(const std::u32string &str) const
+{
+  return casefold_hash(str.data(), str.size());
+}
+
+static const struct ucd_cclo_entry *
+find_case_closure(const struct ucd_cclo *pcclo, codepoint cp)
+{
+  unsigned min = 0, max = pcclo->num_entries, mid;
+
+  while (min < max) {
+    mid = (min + max) / 2;
+
+    const struct ucd_cclo_entry &entry = pcclo->entries[mid];
+
+    if (cp < entry.cp)
+      max = mid;
+    else if (cp > entry.cp)
+      min = mid + 1;
+    else
+      return &entry;
+  }
+
+  return nullptr;
+}
+
+static inline const uint32_t *
+case_closure_class(const struct ucd_cclo *pcclo,
+                   const struct ucd_cclo_entry *pentry)
+{
+  return (const uint32_t *)((const uint8_t *)pcclo + pentry->offset);
+}
+
+namespace {
+
+  struct folding_pair {
+    codepoint cp;
+    codepoint folded;
+  };
+
+  /* Without the case closure table, we can still find the code points that
+     fold to something else, because they are all in the case folding
+     table; returns each of them with its simple case folding. */
+  std::vector<folding_pair>
+  folding_pairs(const database &db, const struct ucd_case *pcsef)
+  {
+    std::vector<folding_pair> result;
+
+    for (uint32_t n = 0; n < pcsef->num_ranges; ++n) {
+      codepoint first, last;
+
+      get_case_range_bounds(pcsef->ranges[n], first, last);
+
+      for (codepoint cp = first; cp <= last; ++cp) {
+        codepoint folded = db.simple_case_folding(cp);
+        if (folded != cp)
+          result.push_back(folding_pair { cp, folded });
+      }
+    }
+
+    return result;
+  }
+
+  bool
+  in_ranges(const cpranges &ranges, codepoint cp)
+  {
+    for (const cprange &range : ranges) {
+      if (cp >= range.first && cp <= range.last)
+        return true;
+    }
+    return false;
+  }
+
+}
+
+size_t
+database::case_closure(codepoint cp, codepoint *out, size_t out_len) const
+{
+  const struct ucd_cclo *pcclo = _pimpl->get_cclo();
+
+  if (!pcclo) {
+    codepoint folded = simple_case_folding(cp);
+    cpvector members(1, folded);
+
+    for (const folding_pair &pair : folding_pairs(*this, _pimpl->get_csef())) {
+      if (pair.folded == folded)
+        members.push_back(pair.cp);
+    }
+
+    std::sort(members.begin(), members.end());
+
+    for (size_t n = 0; n < members.size() && n < out_len; ++n)
+      out[n] = members[n];
+
+    return members.size();
+  }
+
+  const struct ucd_cclo_entry *pentry = find_case_closure(pcclo, cp);
+
+  if (!pentry) {
+    if (out_len >= 1)
+      *out = cp;
+    return 1;
+  }
+
+  const uint32_t *pclass = case_closure_class(pcclo, pentry);
+  size_t count = pclass[0];
+
+  for (size_t n = 0; n < count && n < out_len; ++n)
+    out[n] = pclass[n + 1];
+
+  return count;
+}
+
+cpvector
+database::case_closure(codepoint cp) const
+{
+  codepoint buf[8];
+  size_t count = case_closure(cp, buf, 8);
+
+  if (count > 8) {
+    cpvector result(count);
+    case_closure(cp, result.data(), count);
+    return result;
+  }
+
+  return cpvector(buf, buf + count);
+}
+
+void
+database::case_closure(cpranges &ranges) const
+{
+  const struct ucd_cclo *pcclo = _pimpl->get_cclo();
+  cpvector extra;
+
+  if (pcclo) {
+    const struct ucd_cclo_entry *begin = pcclo->entries;
+    const struct ucd_cclo_entry *end = begin + pcclo->num_entries;
+
+    // Only the code points listed in the table can add anything
+    for (const cprange &range : ranges) {
+      const struct ucd_cclo_entry *pentry
+        = std::lower_bound(begin, end, range.first,
+                           [](const struct ucd_cclo_entry &e, codepoint cp) {
+                             return e.cp < cp;
+                           });
+
+      for (; pentry < end && pentry->cp <= range.last; ++pentry) {
+        const uint32_t *pclass = case_closure_class(pcclo, pentry);
+        for (uint32_t n = 1; n <= pclass[0]; ++n) {
+          codepoint member = pclass[n];
+          if (member < range.first || member > range.last)
+            extra.push_back(member);
+        }
+      }
+    }
+  } else {
+    std::vector<folding_pair> pairs = folding_pairs(*this,
+                                                    _pimpl->get_csef());
+    cpvector classes;
+
+    // Find the foldings of the cased characters we have...
+    for (const folding_pair &pair : pairs) {
+      if (in_ranges(ranges, pair.cp) || in_ranges(ranges, pair.folded))
+        classes.push_back(pair.folded);
+    }
+
+    std::sort(classes.begin(), classes.end());
+
+    // ...then add everything with the same folding
+    for (const folding_pair &pair : pairs) {
+      if (std::binary_search(classes.begin(), classes.end(), pair.folded)) {
+        extra.push_back(pair.cp);
+        extra.push_back(pair.folded);
+      }
+    }
+  }
+
+  if (extra.empty())
+    return;
+
+  for (codepoint cp : extra)
+    ranges.push_back(cprange { cp, cp });
+
+  std::sort(ranges.begin(), ranges.end(),
+            [](const cprange &a, const cprange &b) {
+              return a.first < b.first;
+            });
+
+  // Merge overlapping and adjacent ranges
+  size_t kept = 0;
+  for (size_t n = 1; n < ranges.size(); ++n) {
+    cprange &last = ranges[kept];
+    const cprange &range = ranges[n];
+
+    if (range.first <= last.last + 1) {
+      if (range.last > last.last)
+        last.last = range.last;
+    } else {
+      ranges[++kept] = range;
+    }
+  }
+  ranges.resize(kept + 1);
+}
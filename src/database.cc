@@ -13,6 +13,8 @@
 
 #include <libucd/libucd.h>
 #include "ucd-format.h"
+#include "ucd-impl.h"
+#include "ucd-trie.h"
 
 using namespace ucd;
 
@@ -111,175 +113,60 @@ loose_match(const char *a, const char *aend, const char *b,
     return 0;
 }
 
-struct database::impl {
-  int                       fd;
-  off_t                     len;
-  bool                      mapped;
-
-  const struct ucd_header  *pheader;
-  const struct ucd_strings *pstrings;
-  const struct ucd_names   *pnames;
-  const struct ucd_u1nm    *pu1nm;
-  const struct ucd_isoc    *pisoc;
-  const struct ucd_alis    *palis;
-  const struct ucd_jamo    *pjamo;
-  const struct ucd_genc    *pgenc;
-  const struct ucd_numb    *pnumb;
-  const struct ucd_ccc     *pccc;
-  const struct ucd_case    *pCASE, *pcase, *pCase, *pcsef, *pkccf, *pnfkc;
-  const struct ucd_bidi    *pbidi;
-  const struct ucd_deco    *pdeco;
-  const struct ucd_mirr    *pmirr;
-  const struct ucd_brak    *pbrak;
-  const struct ucd_age     *page;
-  const struct ucd_scpt    *pscpt;
-  const struct ucd_qc      *pnfcqc, *pnfkcqc, *pnfdqc, *pnfkdqc;
-  const struct ucd_join    *pjoin;
-  const struct ucd_brk     *plbrk, *pgbrk, *psbrk, *pwbrk;
-  const struct ucd_eaw     *peaw;
-  const struct ucd_rads    *prads;
-  const struct ucd_inc     *pinmc, *pinsc;
-  const struct ucd_prmc    *pprmc;
-
-  const struct ucd_n32     *pscpn;
-  const struct ucd_n16     *pjamn;
-  const struct ucd_n16     *pgcn;
-  const struct ucd_n8      *pcccn;
-  const struct ucd_n8      *pnumn;
-  const struct ucd_n8      *pbdin;
-  const struct ucd_n8      *pdecn;
-  const struct ucd_n8      *pjtn, *pjgn;
-  const struct ucd_n8      *plbkn, *pgbkn, *psbkn, *pwbkn;
-  const struct ucd_n8      *peawn;
-  const struct ucd_n8      *pimcn, *piscn;
-
-#define BINPROP(n,m,t) const struct ucd_binprop *pbinprop_ ## m;
-#include "ucd-binprops.h"
-
-  std::vector<class block> blocks;
-
-  ~impl();
-
-  const void *get_table(uint32_t table_id) const;
-  const char *get_strptr_unsafe(ucd_string_id_t sid, size_t &max_len);
-  const char *get_strptr(ucd_string_id_t sid, size_t &len);
-  std::string get_string(ucd_string_id_t sid);
-  const struct ucd_names *get_names();
-  const struct ucd_u1nm *get_u1nm();
-  const struct ucd_isoc *get_isoc();
-  const struct ucd_alis *get_alis();
-  const struct ucd_jamo *get_jamo();
-  const struct ucd_genc *get_genc();
-  const struct ucd_numb *get_numb();
-  const struct ucd_ccc  *get_ccc();
-  const struct ucd_case *get_CASE();
-  const struct ucd_case  *get_case();
-  const struct ucd_case  *get_Case();
-  const struct ucd_case *get_csef();
-  const struct ucd_case *get_kccf();
-  const struct ucd_case *get_nfkc();
-  const struct ucd_bidi *get_bidi();
-  const struct ucd_deco *get_deco();
-  const struct ucd_mirr *get_mirr();
-  const struct ucd_brak *get_brak();
-  const struct ucd_age *get_age();
-  const struct ucd_scpt *get_scpt();
-  const struct ucd_qc *get_nfcqc();
-  const struct ucd_qc *get_nfkcqc();
-  const struct ucd_qc *get_nfdqc();
-  const struct ucd_qc *get_nfkdqc();
-  const struct ucd_join *get_join();
-  const struct ucd_brk *get_lbrk();
-  const struct ucd_brk *get_gbrk();
-  const struct ucd_brk *get_sbrk();
-  const struct ucd_brk *get_wbrk();
-  const struct ucd_eaw *get_eaw();
-  const struct ucd_rads *get_rads();
-  const struct ucd_inc *get_inmc();
-  const struct ucd_inc *get_insc();
-  const struct ucd_prmc *get_prmc();
-
-  const struct ucd_n16 *get_jamn();
-  const struct ucd_n16 *get_gcn();
-  const struct ucd_n8  *get_cccn();
-  const struct ucd_n8  *get_numn();
-  const struct ucd_n8  *get_bdin();
-  const struct ucd_n8  *get_decn();
-  const struct ucd_n8  *get_jtn();
-  const struct ucd_n8  *get_jgn();
-  const struct ucd_n8  *get_lbkn();
-  const struct ucd_n8  *get_gbkn();
-  const struct ucd_n8  *get_sbkn();
-  const struct ucd_n8  *get_wbkn();
-  const struct ucd_n8  *get_eawn();
-  const struct ucd_n8  *get_imcn();
-  const struct ucd_n8  *get_iscn();
-  const struct ucd_n32 *get_scpn();
-
-#undef BINPROP
-#define BINPROP(n,m,t)                                           \
-  const struct ucd_binprop *get_binprop_##m() {                  \
-    if (!pbinprop_ ## m)                                         \
-      pbinprop_ ## m = (const struct ucd_binprop *)get_table(t); \
-    return pbinprop_ ## m;                                       \
-  }
-#include "ucd-binprops.h"
-
-  void init_blocks();
-
-  std::string strip(const std::string &s);
-  template <class table, class valtype>
-  bool search(const table *ptbl, valtype value, std::string &str)
-  {
-    uint32_t min = 0, max = ptbl->num_fwd, mid;
+template <class table, class valtype>
+bool
+database::impl::search(const table *ptbl, valtype value, std::string &str)
+{
+  uint32_t min = 0, max = ptbl->num_fwd, mid;
 
-    while (min < max) {
-      mid = (min + max) / 2;
+  while (min < max) {
+    mid = (min + max) / 2;
 
-      if (value < ptbl->names[mid].value)
-        max = mid;
-      else if (value > ptbl->names[mid].value)
-        min = mid + 1;
-      else {
-        str = get_string(ptbl->names[mid].name);
-        return true;
-      }
+    if (value < ptbl->names[mid].value)
+      max = mid;
+    else if (value > ptbl->names[mid].value)
+      min = mid + 1;
+    else {
+      str = get_string(ptbl->names[mid].name);
+      return true;
     }
-
-    return false;
   }
 
-  template <class table, class valtype>
-  bool search(const table *ptbl, const std::string &str, valtype &result)
-  {
-    std::string stripped = strip(str);
-    const char *nstr = stripped.c_str();
-    uint32_t min = 0, max = ptbl->num_rev, mid;
-    auto *entries = ptbl->names + ptbl->num_fwd;
+  return false;
+}
 
-    while (min < max) {
-      mid = (min + max) / 2;
+template <class table, class valtype>
+bool
+database::impl::search(const table *ptbl, const std::string &str,
+                       valtype &result)
+{
+  std::string stripped = strip(str);
+  const char *nstr = stripped.c_str();
+  uint32_t min = 0, max = ptbl->num_rev, mid;
+  auto *entries = ptbl->names + ptbl->num_fwd;
 
-      uint32_t sid = entries[mid].name;
-      size_t max_len;
-      const char *nameptr = get_strptr_unsafe(sid, max_len);
-      const char *nameend = nameptr + max_len;
+  while (min < max) {
+    mid = (min + max) / 2;
 
-      int ret = loose_match(nameptr, nameend, nstr, LOOSE_IGNORE_DASHES);
+    uint32_t sid = entries[mid].name;
+    size_t max_len;
+    const char *nameptr = get_strptr_unsafe(sid, max_len);
+    const char *nameend = nameptr + max_len;
 
-      if (ret > 0)
-        max = mid;
-      else if (ret < 0)
-        min = mid + 1;
-      else {
-        result = entries[mid].value;
-        return true;
-      }
-    }
+    int ret = loose_match(nameptr, nameend, nstr, LOOSE_IGNORE_DASHES);
 
-    return false;
+    if (ret > 0)
+      max = mid;
+    else if (ret < 0)
+      min = mid + 1;
+    else {
+      result = entries[mid].value;
+      return true;
+    }
   }
-};
+
+  return false;
+}
 
 database::impl::~impl()
 {
@@ -354,6 +241,8 @@ GETTER(alis, ucd_alis, UCD_alis)
 GETTER(jamo, ucd_jamo, UCD_jamo)
 GETTER(genc, ucd_genc, UCD_genc)
 GETTER(numb, ucd_numb, UCD_numb)
+GETTER(dig0, ucd_dig0, UCD_dig0)
+GETTER(numt, ucd_numeric_trie, UCD_numt)
 GETTER(ccc, ucd_ccc, UCD_ccc)
 GETTER(CASE, ucd_case, UCD_CASE)
 GETTER(case, ucd_case, UCD_case)
@@ -378,9 +267,29 @@ GETTER(sbrk, ucd_brk, UCD_sbrk)
 GETTER(wbrk, ucd_brk, UCD_wbrk)
 GETTER(eaw, ucd_eaw, UCD_eaw)
 GETTER(rads, ucd_rads, UCD_rads)
+GETTER(rsix, ucd_rsix, UCD_rsix)
 GETTER(inmc, ucd_inc, UCD_inmc)
 GETTER(insc, ucd_inc, UCD_insc)
 GETTER(prmc, ucd_prmc, UCD_prmc)
+GETTER(CASt, ucd_case_trie, UCD_CASt)
+GETTER(cast, ucd_case_trie, UCD_cast)
+GETTER(Cast, ucd_case_trie, UCD_Cast)
+GETTER(csft, ucd_case_trie, UCD_csft)
+GETTER(cclo, ucd_cclo, UCD_cclo)
+GETTER(gcbt, ucd_trie, UCD_gcbt)
+GETTER(wbkt, ucd_trie, UCD_wbkt)
+GETTER(sbkt, ucd_trie, UCD_sbkt)
+GETTER(lbkt, ucd_trie, UCD_lbkt)
+GETTER(widt, ucd_trie, UCD_widt)
+GETTER(rtlt, ucd_trie, UCD_rtlt)
+GETTER(jntt, ucd_trie, UCD_jntt)
+GETTER(aget, ucd_trie, UCD_aget)
+GETTER(emjt, ucd_trie, UCD_emjt)
+GETTER(emsq, ucd_emsq, UCD_emsq)
+GETTER(cnft, ucd_confusables, UCD_cnft)
+GETTER(idnt, ucd_trie, UCD_idnt)
+GETTER(hidt, ucd_trie, UCD_hidt)
+GETTER(scst, ucd_script_sets, UCD_scst)
 
 GETTER(jamn, ucd_n16, UCD_jamn)
 GETTER(gcn, ucd_n16, UCD_gcn)
@@ -428,6 +337,34 @@ database::impl::init_blocks()
   }
 }
 
+// A script newer than the library is better as Unknown than missing
+static void
+insert_script(script_set &scripts, sc script)
+{
+  if (!scripts.insert(script))
+    scripts.insert(Script::Unknown);
+}
+
+void
+database::impl::init_script_sets()
+{
+  const struct ucd_script_sets *pscst = get_scst();
+  const uint32_t *ptr = (const uint32_t *)((const uint8_t *)pscst
+                                           + pscst->sets_offset);
+
+  script_sets.reserve(pscst->num_sets);
+
+  for (unsigned n = 0; n < pscst->num_sets; ++n) {
+    script_set scripts;
+    uint32_t count = *ptr++;
+
+    for (uint32_t m = 0; m < count; ++m)
+      insert_script(scripts, sc(*ptr++));
+
+    script_sets.push_back(scripts);
+  }
+}
+
 database::database()
 {
 }
@@ -1006,9 +943,92 @@ database::unicode_radical_stroke(codepoint cp) const
   return stroke_count::none;
 }
 
-static void
-get_case_range_bounds(const struct ucd_case_range &range,
-                      codepoint &ecp, codepoint &lcp)
+// Radical, then simplified flag, then residual strokes, in 17 bits
+static inline unsigned
+radical_stroke_key(unsigned radical, bool simplified, int strokes)
+{
+  return (radical << 9) | (unsigned(simplified) << 8) | uint8_t(strokes + 128);
+}
+
+size_t
+database::characters_with_radical_stroke(const stroke_count &rs,
+                                         const codepoint *&cps) const
+{
+  const struct ucd_rsix *prsix = _pimpl->get_rsix();
+
+  cps = nullptr;
+
+  if (!prsix)
+    return 0;
+
+  unsigned key = radical_stroke_key(rs.radical(), rs.is_simplified(),
+                                    rs.additional_strokes());
+  unsigned min = 0, max = prsix->num_entries, mid;
+
+  while (min < max) {
+    mid = (min + max) / 2;
+
+    const struct ucd_rsix_entry &entry = prsix->entries[mid];
+    unsigned ekey = radical_stroke_key(entry.radical, entry.simplified,
+                                       entry.strokes);
+
+    if (key < ekey)
+      max = mid;
+    else if (key > ekey)
+      min = mid + 1;
+    else {
+      cps = (const codepoint *)((const uint8_t *)prsix + prsix->cps_offset)
+        + entry.first;
+      return entry.count;
+    }
+  }
+
+  return 0;
+}
+
+std::vector<codepoint>
+database::characters_with_radical_stroke(const stroke_count &rs) const
+{
+  const codepoint *cps;
+  size_t count = characters_with_radical_stroke(rs, cps);
+
+  if (cps)
+    return std::vector<codepoint>(cps, cps + count);
+
+  std::vector<codepoint> result;
+
+  if (!_pimpl->get_rsix()) {
+    const struct ucd_rads *prads = _pimpl->get_rads();
+
+    for (unsigned n = 0; n < prads->num_ranges; ++n) {
+      const struct ucd_rads_range &range = prads->ranges[n];
+
+      for (codepoint cp = range.first_cp; cp <= range.last_cp; ++cp) {
+        if (unicode_radical_stroke(cp) == rs)
+          result.push_back(cp);
+      }
+    }
+  }
+
+  return result;
+}
+
+uint64_t
+database::radical_stroke_sort_key(codepoint cp) const
+{
+  stroke_count rs = unicode_radical_stroke(cp);
+
+  if (rs == stroke_count::none)
+    return (uint64_t(1) << 38) | cp;
+
+  return ((uint64_t(radical_stroke_key(rs.radical(), rs.is_simplified(),
+                                       rs.additional_strokes())) << 21)
+          | cp);
+}
+
+void
+ucd::get_case_range_bounds(const struct ucd_case_range &range,
+                           codepoint &ecp, codepoint &lcp)
 {
   ecp = UCD_CASE_RANGE_CP(range.entry);
   ucd_case_range_kind_t kind = UCD_CASE_RANGE_KIND(range.entry);
@@ -1212,32 +1232,52 @@ case_mapping(const struct ucd_case *pcase,
   }
 }
 
+/* Data files built with newer versions of ucdc have tries for the case
+   mappings, which are much faster than searching the range tables */
+static size_t
+case_mapping(const struct ucd_case_trie *ptrie,
+             const struct ucd_case *pcase,
+             codepoint from_cp,
+             codepoint *out, size_t out_len,
+             MappingType fos=MappingType::Full)
+{
+  if (ptrie)
+    return ucd_case_trie_mapping(ptrie, from_cp, fos == MappingType::Simple,
+                                 out, out_len);
+
+  return case_mapping(pcase, from_cp, out, out_len, fos);
+}
+
 size_t
 database::uppercase_mapping(codepoint from_cp,
                             codepoint *out, size_t out_len) const
 {
-  return case_mapping(_pimpl->get_CASE(), from_cp, out, out_len);
+  return case_mapping(_pimpl->get_CASt(), _pimpl->get_CASE(),
+                      from_cp, out, out_len);
 }
 
 size_t
 database::lowercase_mapping(codepoint from_cp,
                             codepoint *out, size_t out_len) const
 {
-  return case_mapping(_pimpl->get_case(), from_cp, out, out_len);
+  return case_mapping(_pimpl->get_cast(), _pimpl->get_case(),
+                      from_cp, out, out_len);
 }
 
 size_t
 database::titlecase_mapping(codepoint from_cp,
                             codepoint *out, size_t out_len) const
 {
-  return case_mapping(_pimpl->get_Case(), from_cp, out, out_len);
+  return case_mapping(_pimpl->get_Cast(), _pimpl->get_Case(),
+                      from_cp, out, out_len);
 }
 
 codepoint
 database::simple_case_folding(codepoint cp) const
 {
   codepoint out;
-  case_mapping(_pimpl->get_csef(), cp, &out, 1, MappingType::Simple);
+  case_mapping(_pimpl->get_csft(), _pimpl->get_csef(), cp, &out, 1,
+               MappingType::Simple);
   return out;
 }
 
@@ -1245,8 +1285,8 @@ size_t
 database::case_folding(codepoint from_cp,
                        codepoint *out, size_t out_len) const
 {
-  return case_mapping(_pimpl->get_csef(), from_cp, out, out_len,
-                      MappingType::Full);
+  return case_mapping(_pimpl->get_csft(), _pimpl->get_csef(),
+                      from_cp, out, out_len, MappingType::Full);
 }
 
 size_t
@@ -1383,28 +1423,50 @@ case_mapping(const struct ucd_case *pcase,
   return result;
 }
 
+static std::vector<codepoint>
+case_mapping(const struct ucd_case_trie *ptrie,
+             const struct ucd_case *pcase,
+             codepoint from_cp,
+             MappingType fos=MappingType::Full)
+{
+  if (!ptrie)
+    return case_mapping(pcase, from_cp, fos);
+
+  codepoint buf[4];
+  size_t count = ucd_case_trie_mapping(ptrie, from_cp,
+                                       fos == MappingType::Simple, buf, 4);
+  if (count <= 4)
+    return std::vector<codepoint>(buf, buf + count);
+
+  std::vector<codepoint> result(count);
+  ucd_case_trie_mapping(ptrie, from_cp, fos == MappingType::Simple,
+                        result.data(), count);
+  return result;
+}
+
 std::vector<codepoint>
 database::uppercase_mapping(codepoint cp) const
 {
-  return case_mapping(_pimpl->get_CASE(), cp);
+  return case_mapping(_pimpl->get_CASt(), _pimpl->get_CASE(), cp);
 }
 
 std::vector<codepoint>
 database::lowercase_mapping(codepoint cp) const
 {
-  return case_mapping(_pimpl->get_case(), cp);
+  return case_mapping(_pimpl->get_cast(), _pimpl->get_case(), cp);
 }
 
 std::vector<codepoint>
 database::titlecase_mapping(codepoint cp) const
 {
-  return case_mapping(_pimpl->get_Case(), cp);
+  return case_mapping(_pimpl->get_Cast(), _pimpl->get_Case(), cp);
 }
 
 std::vector<codepoint>
 database::case_folding(codepoint cp) const
 {
-  return case_mapping(_pimpl->get_csef(), cp, MappingType::Full);
+  return case_mapping(_pimpl->get_csft(), _pimpl->get_csef(), cp,
+                      MappingType::Full);
 }
 
 std::vector<codepoint>
@@ -1535,6 +1597,108 @@ database::numeric_value(codepoint cp) const
   return NaN;
 }
 
+static const struct ucd_numeric_value *
+find_numeric_value(const struct ucd_numeric_trie *pnumt, codepoint cp)
+{
+  uint32_t ndx = ucd_trie_lookup(&pnumt->trie, cp);
+
+  if (!ndx || ndx > pnumt->num_values)
+    return nullptr;
+
+  const struct ucd_numeric_value *values
+    = (const struct ucd_numeric_value *)((const char *)pnumt
+                                         + pnumt->values_offset);
+
+  return &values[ndx - 1];
+}
+
+double
+database::numeric_value_double(codepoint cp) const
+{
+  // The only ASCII characters with numeric values are the digits
+  if (cp < 0x80) {
+    if (cp >= '0' && cp <= '9')
+      return double(cp - '0');
+    return double(NaN);
+  }
+
+  const struct ucd_numeric_trie *pnumt = _pimpl->get_numt();
+
+  if (!pnumt)
+    return double(numeric_value(cp));
+
+  const struct ucd_numeric_value *pvalue = find_numeric_value(pnumt, cp);
+
+  return pvalue ? pvalue->value : double(NaN);
+}
+
+rational
+database::numeric_value_rational(codepoint cp) const
+{
+  if (cp < 0x80) {
+    if (cp >= '0' && cp <= '9')
+      return rational(cp - '0');
+    return rational();
+  }
+
+  const struct ucd_numeric_trie *pnumt = _pimpl->get_numt();
+
+  if (!pnumt)
+    return numeric_value(cp).to_rational();
+
+  const struct ucd_numeric_value *pvalue = find_numeric_value(pnumt, cp);
+
+  if (!pvalue)
+    return rational();
+
+  return rational(pvalue->numerator, pvalue->denominator);
+}
+
+int
+database::digit_value(codepoint cp, codepoint &zero) const
+{
+  if (cp < 0x80) {
+    zero = '0';
+    return cp >= '0' && cp <= '9' ? int(cp - '0') : -1;
+  }
+
+  const struct ucd_dig0 *pdig0 = _pimpl->get_dig0();
+
+  if (!pdig0) {
+    if (numeric_type(cp) != Numeric_Type::Decimal)
+      return -1;
+
+    int value = int(numeric_value(cp));
+    zero = cp - value;
+    return value;
+  }
+
+  // Find the last zero at or before cp
+  unsigned min = 0, max = pdig0->num_entries, mid;
+
+  while (min < max) {
+    mid = (min + max) / 2;
+
+    if (cp < pdig0->entries[mid])
+      max = mid;
+    else
+      min = mid + 1;
+  }
+
+  if (!min || cp - pdig0->entries[min - 1] > 9)
+    return -1;
+
+  zero = pdig0->entries[min - 1];
+  return int(cp - zero);
+}
+
+int
+database::digit_value(codepoint cp) const
+{
+  codepoint zero;
+  return digit_value(cp, zero);
+}
+
 bc
 database::bidi_class(codepoint cp) const
 {
@@ -1762,7 +1926,7 @@ database::primary_composite(codepoint starter, codepoint composing) const
 
     return SBase + LVIndex;
   } else if (starter >= SBase && starter < SBase + SCount
-             && composing >= TBase && composing < TBase + TCount) {
+             && composing > TBase && composing < TBase + TCount) {
     unsigned SIndex = starter - SBase;
 
     if ((SIndex % TCount) == 0) {
@@ -1939,10 +2103,9 @@ database::script(codepoint cp) const
   return Script::Unknown;
 }
 
-std::vector<sc>
-database::script_extensions(codepoint cp) const
+size_t
+database::script_extensions(codepoint cp, const sc *&scripts) const
 {
-  std::vector<sc> result;
   const struct ucd_scpt *pscpt = _pimpl->get_scpt();
   const struct ucd_scpt_extensions *psext
     = (const struct ucd_scpt_extensions *)(pscpt->entries + pscpt->num_entries);
@@ -1961,16 +2124,51 @@ database::script_extensions(codepoint cp) const
     else if (cp >= ncp)
       min = mid + 1;
     else {
-      unsigned count = UCD_SCPT_EXT_COUNT(psext->entries[mid].entry);
-      const uint32_t *scripts = (const uint32_t *)((uint8_t *)pscpt
-                                                   + psext->entries[mid].offset);
+      scripts = (const sc *)((const uint8_t *)pscpt
+                             + psext->entries[mid].offset);
+      return UCD_SCPT_EXT_COUNT(psext->entries[mid].entry);
+    }
+  }
 
-      result.assign(scripts, scripts + count);
+  scripts = nullptr;
+  return 0;
+}
 
-      return result;
-    }
+std::vector<sc>
+database::script_extensions(codepoint cp) const
+{
+  const sc *scripts;
+  size_t count = script_extensions(cp, scripts);
+
+  return std::vector<sc>(scripts, scripts + count);
+}
+
+script_set
+database::script_extension_set(codepoint cp) const
+{
+  const struct ucd_script_sets *pscst = _pimpl->get_scst();
+
+  if (pscst) {
+    if (_pimpl->script_sets.empty())
+      _pimpl->init_script_sets();
+
+    return _pimpl->script_sets[ucd_trie_lookup(&pscst->trie, cp)];
   }
 
+  const sc *scripts;
+  size_t count = script_extensions(cp, scripts);
+  sc single;
+
+  if (!count) {
+    single = script(cp);
+    scripts = &single;
+    count = 1;
+  }
+
+  script_set result;
+  for (size_t n = 0; n < count; ++n)
+    insert_script(result, scripts[n]);
+
   return result;
 }
 
@@ -2064,6 +2262,11 @@ database::joining_group(codepoint cp) const
 jt
 database::joining_type(codepoint cp) const
 {
+  const struct ucd_trie *ptrie = _pimpl->get_jntt();
+
+  if (ptrie)
+    return Joining_Type(ucd_trie_lookup(ptrie, cp));
+
   jg dummy;
   return joining_type(cp, dummy);
 }
@@ -2071,6 +2274,11 @@ database::joining_type(codepoint cp) const
 lb
 database::line_break(codepoint cp) const
 {
+  const struct ucd_trie *ptrie = _pimpl->get_lbkt();
+
+  if (ptrie)
+    return Line_Break(ucd_trie_lookup(ptrie, cp));
+
   const struct ucd_brk *pbrk = _pimpl->get_lbrk();
 
   // There is a sentinel on the lbrk table
@@ -2096,6 +2304,18 @@ database::line_break(codepoint cp) const
 GCB
 database::grapheme_cluster_break(codepoint cp) const
 {
+  const struct ucd_trie *ptrie = _pimpl->get_gcbt();
+
+  if (ptrie) {
+    GCB gcb = Grapheme_Cluster_Break(ucd_trie_lookup(ptrie, cp));
+
+    // As with the gbrk table, LV is stored as LVT
+    if (gcb == Grapheme_Cluster_Break::LVT && !((cp - SBase) % TCount))
+      gcb = Grapheme_Cluster_Break::LV;
+
+    return gcb;
+  }
+
   const struct ucd_brk *pbrk = _pimpl->get_gbrk();
 
   // There is a sentinel on the gbrk table
@@ -2132,6 +2352,11 @@ database::grapheme_cluster_break(codepoint cp) const
 SB
 database::sentence_break(codepoint cp) const
 {
+  const struct ucd_trie *ptrie = _pimpl->get_sbkt();
+
+  if (ptrie)
+    return Sentence_Break(ucd_trie_lookup(ptrie, cp));
+
   const struct ucd_brk *pbrk = _pimpl->get_sbrk();
 
   // There is a sentinel on the lbrk table
@@ -2157,6 +2382,11 @@ database::sentence_break(codepoint cp) const
 WB
 database::word_break(codepoint cp) const
 {
+  const struct ucd_trie *ptrie = _pimpl->get_wbkt();
+
+  if (ptrie)
+    return Word_Break(ucd_trie_lookup(ptrie, cp));
+
   const struct ucd_brk *pbrk = _pimpl->get_wbrk();
 
   // There is a sentinel on the lbrk table
@@ -2204,6 +2434,46 @@ database::east_asian_width(codepoint cp) const
   return East_Asian_Width::Neutral;
 }
 
+unsigned
+database::display_width(codepoint cp, bool east_asian) const
+{
+  const struct ucd_trie *ptrie = _pimpl->get_widt();
+  unsigned width;
+
+  if (ptrie)
+    width = ucd_trie_lookup(ptrie, cp);
+  else {
+    gc cat = general_category(cp);
+
+    if (cat == General_Category::Mn || cat == General_Category::Me
+        || cat == General_Category::Cf || cat == General_Category::Cc
+        || cat == General_Category::Zl || cat == General_Category::Zp
+        || default_ignorable_code_point(cp)
+        || (cp >= 0x1160 && cp <= 0x11ff) || (cp >= 0xd7b0 && cp <= 0xd7ff))
+      return 0;
+
+    // Emoji data is optional
+    if (_pimpl->get_binprop_emoji_presentation() && emoji_presentation(cp))
+      return 2;
+
+    switch (east_asian_width(cp)) {
+    case East_Asian_Width::Wide:
+    case East_Asian_Width::Fullwidth:
+      return 2;
+    case East_Asian_Width::Ambiguous:
+      width = UCD_WIDTH_AMBIGUOUS;
+      break;
+    default:
+      return 1;
+    }
+  }
+
+  if (width == UCD_WIDTH_AMBIGUOUS)
+    return east_asian ? 2 : 1;
+
+  return width;
+}
+
 InPC
 database::indic_positional_category(codepoint cp) const
 {
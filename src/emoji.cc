@@ -0,0 +1,315 @@
+#include <libucd/libucd.h>
+#include "ucd-format.h"
+#include "ucd-impl.h"
+#include "ucd-trie.h"
+#include "ucd-text.h"
+#include "ucd-ascii.h"
+
+using namespace ucd;
+
+const size_t emoji_iterator::npos;
+
+namespace {
+
+  const codepoint no_codepoint = codepoint(-1);
+  const codepoint zwj = 0x200d;
+  const codepoint keycap = 0x20e3;
+  const codepoint text_selector = 0xfe0e;
+  const codepoint emoji_selector = 0xfe0f;
+  const codepoint first_tag = 0xe0020;
+  const codepoint last_tag = 0xe007e;
+  const codepoint cancel_tag = 0xe007f;
+
+  inline bool
+  is_regional_indicator(codepoint cp)
+  {
+    return cp >= 0x1f1e6 && cp <= 0x1f1ff;
+  }
+
+  inline bool
+  is_keycap_base(codepoint cp)
+  {
+    return (cp >= '0' && cp <= '9') || cp == '#' || cp == '*';
+  }
+
+  inline bool
+  is_tag(codepoint cp)
+  {
+    return cp >= first_tag && cp <= last_tag;
+  }
+
+  const trie_flag emoji_flags[] = {
+    { UCD_EMOJI,                has_property<&database::emoji> },
+    { UCD_EMOJI_PRESENTATION,   has_property<&database::emoji_presentation> },
+    { UCD_EMOJI_MODIFIER,       has_property<&database::emoji_modifier> },
+    { UCD_EMOJI_MODIFIER_BASE,  has_property<&database::emoji_modifier_base> }
+  };
+
+  struct emoji_tables {
+    flag_trie              props;
+    const struct ucd_emsq *pemsq;
+  };
+
+  template <class Codec>
+  struct cursor {
+    typedef typename Codec::code_unit code_unit;
+
+    const code_unit *ptr;
+    const code_unit *end;
+
+    codepoint peek() const {
+      if (ptr >= end)
+        return no_codepoint;
+      const code_unit *next = ptr;
+      return Codec::decode(next, end);
+    }
+
+    void advance() { Codec::decode(ptr, end); }
+  };
+
+  /* Runs the automaton from ptr, returning the end of the longest listed
+     sequence that starts there, or nullptr. */
+  template <class Codec>
+  const typename Codec::code_unit *
+  match_listed(const struct ucd_emsq *pemsq,
+               const typename Codec::code_unit *ptr,
+               const typename Codec::code_unit *end,
+               emoji_sequence &type)
+  {
+    typedef typename Codec::code_unit code_unit;
+
+    const struct ucd_emsq_edge *edges
+      = (const struct ucd_emsq_edge *)((const uint8_t *)pemsq
+                                       + pemsq->edges_offset);
+    const code_unit *match = nullptr;
+    uint32_t node = 0;
+
+    while (ptr < end) {
+      codepoint cp = Codec::decode(ptr, end);
+      const struct ucd_emsq_node &n = pemsq->nodes[node];
+      unsigned min = n.first_edge, max = n.first_edge + n.num_edges, mid;
+
+      while (min < max) {
+        mid = (min + max) / 2;
+
+        if (cp < edges[mid].cp)
+          max = mid;
+        else if (cp > edges[mid].cp)
+          min = mid + 1;
+        else
+          break;
+      }
+
+      if (min >= max || edges[mid].node >= pemsq->num_nodes)
+        break;
+
+      node = edges[mid].node;
+
+      uint8_t ntype = pemsq->nodes[node].type;
+      if (ntype && ntype <= uint8_t(emoji_sequence::tag)) {
+        match = ptr;
+        type = emoji_sequence(ntype);
+      }
+    }
+
+    return match;
+  }
+
+  /* Matches an emoji character, along with a skin tone modifier or a
+     presentation selector.  qualified is set if the result should be
+     displayed as an emoji. */
+  template <class Codec>
+  bool
+  match_element(const emoji_tables &tables, cursor<Codec> &cur,
+                bool &qualified, bool &modified)
+  {
+    unsigned flags = tables.props.lookup(cur.peek());
+
+    if (!(flags & UCD_EMOJI))
+      return false;
+
+    cur.advance();
+
+    codepoint next = cur.peek();
+
+    qualified = flags & UCD_EMOJI_PRESENTATION;
+    modified = false;
+
+    if ((flags & UCD_EMOJI_MODIFIER_BASE)
+        && (tables.props.lookup(next) & UCD_EMOJI_MODIFIER)) {
+      cur.advance();
+      qualified = modified = true;
+    } else if (next == emoji_selector) {
+      cur.advance();
+      qualified = true;
+    } else if (next == text_selector) {
+      cur.advance();
+      qualified = false;
+    }
+
+    return true;
+  }
+
+  /* Matches any well formed emoji sequence from ptr, following the grammar
+     in UTS #51, returning its end or nullptr. */
+  template <class Codec>
+  const typename Codec::code_unit *
+  match_sequence(const emoji_tables &tables,
+                 const typename Codec::code_unit *ptr,
+                 const typename Codec::code_unit *end,
+                 emoji_sequence &type)
+  {
+    cursor<Codec> cur = { ptr, end };
+    codepoint cp = cur.peek();
+
+    if (is_regional_indicator(cp)) {
+      cursor<Codec> flag = cur;
+      flag.advance();
+      if (is_regional_indicator(flag.peek())) {
+        flag.advance();
+        type = emoji_sequence::flag;
+        return flag.ptr;
+      }
+    } else if (is_keycap_base(cp)) {
+      cursor<Codec> kc = cur;
+      kc.advance();
+      if (kc.peek() == emoji_selector)
+        kc.advance();
+      if (kc.peek() == keycap) {
+        kc.advance();
+        type = emoji_sequence::keycap;
+        return kc.ptr;
+      }
+    }
+
+    bool qualified, modified;
+
+    if (!match_element(tables, cur, qualified, modified))
+      return nullptr;
+
+    type = modified ? emoji_sequence::modifier : emoji_sequence::basic;
+
+    // Tag sequences only count if they're terminated properly
+    if (is_tag(cur.peek())) {
+      cursor<Codec> tags = cur;
+      while (is_tag(tags.peek()))
+        tags.advance();
+      if (tags.peek() == cancel_tag) {
+        tags.advance();
+        cur = tags;
+        type = emoji_sequence::tag;
+        qualified = true;
+      }
+    }
+
+    while (type != emoji_sequence::tag && cur.peek() == zwj) {
+      cursor<Codec> joined = cur;
+      bool q, m;
+
+      joined.advance();
+      if (!match_element(tables, joined, q, m))
+        break;
+
+      cur = joined;
+      type = emoji_sequence::zwj;
+      qualified = true;
+    }
+
+    if (!qualified)
+      return nullptr;
+
+    return cur.ptr;
+  }
+
+  template <class Codec>
+  bool
+  find_emoji_in(const emoji_tables &tables, const text &txt, size_t pos,
+                emoji_match &match)
+  {
+    typedef typename Codec::code_unit code_unit;
+
+    const code_unit *begin = text_begin<Codec>(txt);
+    const code_unit *end = text_end<Codec>(txt);
+    const code_unit *ptr = begin + pos;
+
+    while (ptr < end) {
+      /* The only ASCII characters that start emoji are the keycap bases,
+         and then only if something non-ASCII follows */
+      size_t run = ascii_span(ptr, end - ptr);
+      const code_unit *start = ptr + run;
+
+      if (run) {
+        if (start == end)
+          break;
+        if (is_keycap_base(start[-1]))
+          --start;
+      }
+
+      ptr = start;
+      codepoint cp = Codec::decode(ptr, end);
+
+      if (cp >= 0x80 && !(tables.props.lookup(cp) & UCD_EMOJI))
+        continue;
+
+      emoji_sequence listed_type = emoji_sequence::none;
+      emoji_sequence type = emoji_sequence::none;
+      const code_unit *listed_end = nullptr;
+      const code_unit *seq_end
+        = match_sequence<Codec>(tables, start, end, type);
+
+      if (tables.pemsq)
+        listed_end = match_listed<Codec>(tables.pemsq, start, end,
+                                         listed_type);
+
+      if (!listed_end && !seq_end)
+        continue;
+
+      match.start = start - begin;
+      if (listed_end && (!seq_end || listed_end >= seq_end)) {
+        match.end = listed_end - begin;
+        match.type = listed_type;
+        match.rgi = true;
+      } else {
+        match.end = seq_end - begin;
+        match.type = type;
+        match.rgi = type == emoji_sequence::basic;
+      }
+
+      return true;
+    }
+
+    return false;
+  }
+
+}
+
+bool
+database::find_emoji(const text &txt, size_t pos, emoji_match &match) const
+{
+  // Emoji data is optional, so there may be no properties to fall back on
+  size_t count = 0;
+  if (_pimpl->get_binprop_emoji())
+    count = sizeof(emoji_flags) / sizeof(emoji_flags[0]);
+  emoji_tables tables = {
+    flag_trie(*this, _pimpl->get_emjt(), emoji_flags, count),
+    _pimpl->get_emsq()
+  };
+  bool result = false;
+
+  if (pos >= txt.length())
+    return false;
+
+  UCD_TEXT_DISPATCH(txt, result = find_emoji_in,
+                    (tables, txt, pos, match));
+
+  return result;
+}
+
+size_t
+emoji_iterator::next()
+{
+  if (!_db.find_emoji(_text, _match.end, _match))
+    return npos;
+
+  return _match.end;
+}
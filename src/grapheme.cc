@@ -0,0 +1,187 @@
+#include <libucd/libucd.h>
+#include "ucd-text.h"
+
+using namespace ucd;
+
+const size_t grapheme_iterator::npos;
+
+namespace {
+
+  /* The state is the Grapheme_Cluster_Break value of the last code point,
+     except that we need to know whether we're after an odd or even number
+     of Regional_Indicators, and whether we're after E_Base (or E_Base_GAZ)
+     followed by any number of Extend characters. */
+  enum {
+    num_classes = 18,
+
+    state_ri_odd = unsigned(GCB::RI),
+    state_e_base = num_classes,
+    state_ri_even,
+
+    num_states,
+
+    no_break = 0x80,
+    state_mask = 0x7f
+  };
+
+  bool
+  is_control(unsigned c)
+  {
+    return (c == unsigned(GCB::CN) || c == unsigned(GCB::CR)
+            || c == unsigned(GCB::LF));
+  }
+
+  // Rules GB3 to GB999 from UAX #29
+  bool
+  gcb_joins(unsigned state, unsigned c)
+  {
+    switch (state) {
+    case unsigned(GCB::CR):
+      return c == unsigned(GCB::LF);                                 // GB3
+    case unsigned(GCB::CN):
+    case unsigned(GCB::LF):
+      return false;                                                  // GB4
+    }
+
+    if (is_control(c))
+      return false;                                                  // GB5
+
+    switch (state) {
+    case unsigned(GCB::L):
+      if (c == unsigned(GCB::L) || c == unsigned(GCB::V)
+          || c == unsigned(GCB::LV) || c == unsigned(GCB::LVT))
+        return true;                                                 // GB6
+      break;
+    case unsigned(GCB::LV):
+    case unsigned(GCB::V):
+      if (c == unsigned(GCB::V) || c == unsigned(GCB::T))
+        return true;                                                 // GB7
+      break;
+    case unsigned(GCB::LVT):
+    case unsigned(GCB::T):
+      if (c == unsigned(GCB::T))
+        return true;                                                 // GB8
+      break;
+    }
+
+    if (c == unsigned(GCB::EX) || c == unsigned(GCB::ZWJ))
+      return true;                                                   // GB9
+    if (c == unsigned(GCB::SM))
+      return true;                                                   // GB9a
+    if (state == unsigned(GCB::PP))
+      return true;                                                   // GB9b
+    if (state == state_e_base && c == unsigned(GCB::EM))
+      return true;                                                   // GB10
+    if (state == unsigned(GCB::ZWJ)
+        && (c == unsigned(GCB::GAZ) || c == unsigned(GCB::EBG)))
+      return true;                                                   // GB11
+    if (state == state_ri_odd && c == unsigned(GCB::RI))
+      return true;                                                   // GB12, 13
+
+    return false;                                                    // GB999
+  }
+
+  unsigned
+  gcb_next_state(unsigned state, unsigned c, bool joined)
+  {
+    switch (c) {
+    case unsigned(GCB::RI):
+      return joined && state == state_ri_odd ? state_ri_even : state_ri_odd;
+    case unsigned(GCB::EX):
+      return joined && state == state_e_base ? unsigned(state_e_base) : c;
+    case unsigned(GCB::EB):
+    case unsigned(GCB::EBG):
+      return state_e_base;
+    default:
+      return c;
+    }
+  }
+
+  /* The rules compiled into a table indexed by state and the class of the
+     next code point; each entry is the next state, plus no_break if there
+     isn't a boundary before the code point. */
+  struct gcb_table {
+    uint8_t entries[num_states][num_classes];
+
+    gcb_table() {
+      for (unsigned state = 0; state < num_states; ++state) {
+        for (unsigned c = 0; c < num_classes; ++c) {
+          bool joined = gcb_joins(state, c);
+          entries[state][c] = (gcb_next_state(state, c, joined)
+                               | (joined ? no_break : 0));
+        }
+      }
+    }
+  };
+
+  const gcb_table &
+  get_gcb_table()
+  {
+    static const gcb_table table;
+    return table;
+  }
+
+  inline unsigned
+  gcb_class(const database &db, codepoint cp)
+  {
+    unsigned c = unsigned(db.grapheme_cluster_break(cp));
+    return c < num_classes ? c : unsigned(GCB::XX);
+  }
+
+  template <class Codec>
+  size_t
+  next_grapheme_boundary(const database &db, const text &txt, size_t pos)
+  {
+    typedef typename Codec::code_unit code_unit;
+
+    const code_unit *begin = text_begin<Codec>(txt);
+    const code_unit *end = text_end<Codec>(txt);
+    const code_unit *ptr = begin + pos;
+
+    /* Two ASCII characters in a row are always separate clusters unless
+       they're CR LF, and a control character is always followed by a
+       boundary, except for CR LF again. */
+    uint32_t u0 = unit_value(ptr[0]);
+    if (u0 < 0x80) {
+      if (ptr + 1 == end)
+        return pos + 1;
+
+      uint32_t u1 = unit_value(ptr[1]);
+      if (u0 == '\r')
+        return pos + (u1 == '\n' ? 2 : 1);
+      if (u1 < 0x80 || u0 < 0x20 || u0 == 0x7f)
+        return pos + 1;
+    }
+
+    const gcb_table &table = get_gcb_table();
+    codepoint first = Codec::decode(ptr, end);
+    unsigned state = gcb_next_state(0, gcb_class(db, first), false);
+
+    while (ptr < end) {
+      const code_unit *next = ptr;
+      codepoint cp = Codec::decode(next, end);
+      unsigned entry = table.entries[state][gcb_class(db, cp)];
+
+      if (!(entry & no_break))
+        break;
+
+      state = entry & state_mask;
+      ptr = next;
+    }
+
+    return ptr - begin;
+  }
+
+}
+
+size_t
+grapheme_iterator::next()
+{
+  if (_pos >= _text.length())
+    return npos;
+
+  UCD_TEXT_DISPATCH(_text, _pos = next_grapheme_boundary,
+                    (_db, _text, _pos));
+
+  return _pos;
+}
@@ -0,0 +1,149 @@
+#include <libucd/libucd.h>
+#include "ucd-format.h"
+#include "ucd-impl.h"
+#include "ucd-trie.h"
+#include "ucd-ascii.h"
+
+using namespace ucd;
+
+namespace {
+
+  const trie_flag ident_flags[] = {
+    { UCD_IDENT_ID_START,            has_property<&database::id_start> },
+    { UCD_IDENT_ID_CONTINUE,         has_property<&database::id_continue> },
+    { UCD_IDENT_XID_START,           has_property<&database::xid_start> },
+    { UCD_IDENT_XID_CONTINUE,        has_property<&database::xid_continue> },
+    { UCD_IDENT_PATTERN_SYNTAX,      has_property<&database::pattern_syntax> },
+    { UCD_IDENT_PATTERN_WHITE_SPACE,
+      has_property<&database::pattern_white_space> }
+  };
+
+  inline bool
+  is_ascii_start(codepoint cp)
+  {
+    return (cp >= 'a' && cp <= 'z') || (cp >= 'A' && cp <= 'Z') || cp == '_';
+  }
+
+  inline bool
+  is_ascii_pattern_white_space(codepoint cp)
+  {
+    return cp == ' ' || (cp >= '\t' && cp <= '\r');
+  }
+
+  template <class Codec>
+  size_t
+  scan_identifier(const flag_trie &props,
+                  const typename Codec::code_unit *in, size_t len,
+                  identifier_syntax syntax)
+  {
+    typedef typename Codec::code_unit code_unit;
+
+    const code_unit *ptr = in, *end = in + len;
+    unsigned start_flag, continue_flag;
+
+    if (syntax == identifier_syntax::id) {
+      start_flag = UCD_IDENT_ID_START;
+      continue_flag = UCD_IDENT_ID_CONTINUE;
+    } else {
+      start_flag = UCD_IDENT_XID_START;
+      continue_flag = UCD_IDENT_XID_CONTINUE;
+    }
+
+    if (ptr == end)
+      return 0;
+
+    codepoint cp = Codec::decode(ptr, end);
+
+    if (cp < 0x80 ? !is_ascii_start(cp) : !(props.lookup(cp) & start_flag))
+      return 0;
+
+    /* In ASCII, ID_Continue and XID_Continue are both [A-Za-z0-9_], so
+       anything ASCII left after the span ends the identifier */
+    while (ptr < end) {
+      ptr += ascii_word_span(ptr, end - ptr);
+      if (ptr == end)
+        break;
+
+      const code_unit *next = ptr;
+      cp = Codec::decode(next, end);
+
+      if (cp < 0x80 || !(props.lookup(cp) & continue_flag))
+        break;
+
+      ptr = next;
+    }
+
+    return ptr - in;
+  }
+
+  template <class Codec>
+  size_t
+  scan_pattern_white_space(const flag_trie &props,
+                           const typename Codec::code_unit *in, size_t len)
+  {
+    typedef typename Codec::code_unit code_unit;
+
+    const code_unit *ptr = in, *end = in + len;
+
+    while (ptr < end) {
+      const code_unit *next = ptr;
+      codepoint cp = Codec::decode(next, end);
+
+      if (cp < 0x80) {
+        if (!is_ascii_pattern_white_space(cp))
+          break;
+      } else if (!(props.lookup(cp) & UCD_IDENT_PATTERN_WHITE_SPACE))
+        break;
+
+      ptr = next;
+    }
+
+    return ptr - in;
+  }
+
+}
+
+size_t
+database::scan_identifier(const char *in, size_t len,
+                          identifier_syntax syntax) const
+{
+  flag_trie props(*this, _pimpl->get_idnt(), ident_flags);
+  return ::scan_identifier<utf8_codec>(props, in, len, syntax);
+}
+
+size_t
+database::scan_identifier(const char16_t *in, size_t len,
+                          identifier_syntax syntax) const
+{
+  flag_trie props(*this, _pimpl->get_idnt(), ident_flags);
+  return ::scan_identifier<utf16_codec>(props, in, len, syntax);
+}
+
+size_t
+database::scan_identifier(const char32_t *in, size_t len,
+                          identifier_syntax syntax) const
+{
+  flag_trie props(*this, _pimpl->get_idnt(), ident_flags);
+  return ::scan_identifier<utf32_codec>(props, in, len, syntax);
+}
+
+size_t
+database::scan_pattern_white_space(const char *in, size_t len) const
+{
+  flag_trie props(*this, _pimpl->get_idnt(), ident_flags);
+  return ::scan_pattern_white_space<utf8_codec>(props, in, len);
+}
+
+size_t
+database::scan_pattern_white_space(const char16_t *in, size_t len) const
+{
+  flag_trie props(*this, _pimpl->get_idnt(), ident_flags);
+  return ::scan_pattern_white_space<utf16_codec>(props, in, len);
+}
+
+size_t
+database::scan_pattern_white_space(const char32_t *in, size_t len) const
+{
+  flag_trie props(*this, _pimpl->get_idnt(), ident_flags);
+  return ::scan_pattern_white_space<utf32_codec>(props, in, len);
+}
@@ -0,0 +1,81 @@
+#include <libucd/libucd.h>
+
+using namespace ucd;
+
+namespace {
+
+  const codepoint zwnj = 0x200c;
+  const codepoint zwj = 0x200d;
+
+  inline jt
+  get_joining_type(const database &db, codepoint cp)
+  {
+    // Nothing in ASCII joins, and it's neither Mn, Me nor Cf
+    if (cp < 0x80 || cp == zwnj)
+      return Joining_Type::Non_Joining;
+    if (cp == zwj)
+      return Joining_Type::Join_Causing;
+    return db.joining_type(cp);
+  }
+
+  // Can a character of type t join to the one after it?
+  inline bool
+  joins_forward(jt t)
+  {
+    return (t == Joining_Type::Left_Joining || t == Joining_Type::Dual_Joining
+            || t == Joining_Type::Join_Causing);
+  }
+
+  // To the one before?
+  inline bool
+  joins_backward(jt t)
+  {
+    return (t == Joining_Type::Right_Joining
+            || t == Joining_Type::Dual_Joining
+            || t == Joining_Type::Join_Causing);
+  }
+
+}
+
+void
+ucd::joining_forms(const database &db, const codepoint *cps, size_t count,
+                   joining_form *forms)
+{
+  const size_t npos = size_t(-1);
+  size_t prev = npos;
+  jt prev_type = Joining_Type::Non_Joining;
+
+  for (size_t n = 0; n < count; ++n) {
+    jt type = get_joining_type(db, cps[n]);
+
+    forms[n] = joining_form::none;
+
+    if (type == Joining_Type::Transparent)
+      continue;
+
+    bool joined = joins_forward(prev_type) && joins_backward(type);
+
+    // Now we know the previous character joins to this one, fix its form
+    if (joined && prev != npos) {
+      if (forms[prev] == joining_form::isolated)
+        forms[prev] = joining_form::initial;
+      else if (forms[prev] == joining_form::final)
+        forms[prev] = joining_form::medial;
+    }
+
+    switch (type) {
+    case Joining_Type::Right_Joining:
+    case Joining_Type::Dual_Joining:
+      forms[n] = joined ? joining_form::final : joining_form::isolated;
+      break;
+    case Joining_Type::Left_Joining:
+      forms[n] = joining_form::isolated;
+      break;
+    default:
+      break;
+    }
+
+    prev = n;
+    prev_type = type;
+  }
+}
@@ -0,0 +1,379 @@
+#include <libucd/libucd.h>
+#include "ucd-text.h"
+
+using namespace ucd;
+
+const size_t line_break_iterator::npos;
+
+namespace {
+
+  enum {
+    num_classes = 43,
+
+    // Used for _prev and _last at the start of the text (or of a line)
+    sot = 0xff
+  };
+
+  /* The pair table entries.  An indirect break is only allowed if there
+     are spaces between the two characters, and a prohibited break isn't
+     allowed even then. */
+  enum {
+    direct_break = 0,
+    indirect_break = 1,
+    prohibited_break = 2
+  };
+
+  inline bool
+  is(unsigned c, lb v)
+  {
+    return c == unsigned(v);
+  }
+
+  inline bool
+  is_ahletter(unsigned c)
+  {
+    return is(c, lb::AL) || is(c, lb::HL);
+  }
+
+  inline bool
+  is_ideographic(unsigned c)
+  {
+    return is(c, lb::ID) || is(c, lb::EB) || is(c, lb::EM);
+  }
+
+  inline bool
+  is_hangul(unsigned c)
+  {
+    return (is(c, lb::JL) || is(c, lb::JV) || is(c, lb::JT)
+            || is(c, lb::H2) || is(c, lb::H3));
+  }
+
+  inline bool
+  is_hard_break(unsigned c)
+  {
+    return (is(c, lb::BK) || is(c, lb::CR) || is(c, lb::LF)
+            || is(c, lb::NL));
+  }
+
+  // Rules LB11 to LB31 from UAX #14, for a pair of resolved classes
+  unsigned
+  lb_pair(unsigned b, unsigned a)
+  {
+    if (is(a, lb::WJ))
+      return prohibited_break;                                       // LB11
+    if (is(b, lb::WJ) || is(b, lb::GL))
+      return indirect_break;                                     // LB11, 12
+    if (is(a, lb::GL) && !is(b, lb::BA) && !is(b, lb::HY))
+      return indirect_break;                                         // LB12a
+    if (is(a, lb::CL) || is(a, lb::CP) || is(a, lb::EX) || is(a, lb::IS)
+        || is(a, lb::SY))
+      return prohibited_break;                                       // LB13
+    if (is(b, lb::OP))
+      return prohibited_break;                                       // LB14
+    if (is(b, lb::QU) && is(a, lb::OP))
+      return prohibited_break;                                       // LB15
+    if ((is(b, lb::CL) || is(b, lb::CP)) && is(a, lb::NS))
+      return prohibited_break;                                       // LB16
+    if (is(b, lb::B2) && is(a, lb::B2))
+      return prohibited_break;                                       // LB17
+    if (is(a, lb::QU) || is(b, lb::QU))
+      return indirect_break;                                         // LB19
+    if (is(a, lb::CB) || is(b, lb::CB))
+      return direct_break;                                           // LB20
+    if (is(a, lb::BA) || is(a, lb::HY) || is(a, lb::NS) || is(b, lb::BB))
+      return indirect_break;                                         // LB21
+    if (is(b, lb::SY) && is(a, lb::HL))
+      return indirect_break;                                         // LB21b
+    if (is(a, lb::IN)
+        && (is_ahletter(b) || is(b, lb::EX) || is_ideographic(b)
+            || is(b, lb::IN) || is(b, lb::NU)))
+      return indirect_break;                                         // LB22
+    if ((is_ahletter(b) && is(a, lb::NU))
+        || (is(b, lb::NU) && is_ahletter(a)))
+      return indirect_break;                                         // LB23
+    if ((is(b, lb::PR) && is_ideographic(a))
+        || (is_ideographic(b) && is(a, lb::PO)))
+      return indirect_break;                                         // LB23a
+    if (((is(b, lb::PR) || is(b, lb::PO)) && is_ahletter(a))
+        || (is_ahletter(b) && (is(a, lb::PR) || is(a, lb::PO))))
+      return indirect_break;                                         // LB24
+    if ((is(a, lb::PO) || is(a, lb::PR))
+        && (is(b, lb::CL) || is(b, lb::CP) || is(b, lb::NU)))
+      return indirect_break;                                         // LB25
+    if ((is(b, lb::PO) || is(b, lb::PR)) && (is(a, lb::OP) || is(a, lb::NU)))
+      return indirect_break;                                         // LB25
+    if (is(a, lb::NU)
+        && (is(b, lb::HY) || is(b, lb::IS) || is(b, lb::NU)
+            || is(b, lb::SY)))
+      return indirect_break;                                         // LB25
+    if (is(b, lb::JL)
+        && (is(a, lb::JL) || is(a, lb::JV) || is(a, lb::H2)
+            || is(a, lb::H3)))
+      return indirect_break;                                         // LB26
+    if ((is(b, lb::JV) || is(b, lb::H2)) && (is(a, lb::JV) || is(a, lb::JT)))
+      return indirect_break;                                         // LB26
+    if ((is(b, lb::JT) || is(b, lb::H3)) && is(a, lb::JT))
+      return indirect_break;                                         // LB26
+    if ((is_hangul(b) && (is(a, lb::IN) || is(a, lb::PO)))
+        || (is(b, lb::PR) && is_hangul(a)))
+      return indirect_break;                                         // LB27
+    if (is_ahletter(b) && is_ahletter(a))
+      return indirect_break;                                         // LB28
+    if (is(b, lb::IS) && is_ahletter(a))
+      return indirect_break;                                         // LB29
+    if ((is_ahletter(b) || is(b, lb::NU)) && is(a, lb::OP))
+      return indirect_break;                                         // LB30
+    if (is(b, lb::CP) && (is_ahletter(a) || is(a, lb::NU)))
+      return indirect_break;                                         // LB30
+    if (is(b, lb::RI) && is(a, lb::RI))
+      return indirect_break;                                         // LB30a
+    if (is(b, lb::EB) && is(a, lb::EM))
+      return indirect_break;                                         // LB30b
+
+    return direct_break;                                             // LB31
+  }
+
+  /* The pair table, indexed by the (resolved) class of the character
+     before the break and of the character after it, together with the
+     Line_Break values of the ASCII characters. */
+  struct lb_table {
+    uint8_t pairs[num_classes][num_classes];
+    uint8_t ascii[0x80];
+
+    lb_table() {
+      for (unsigned b = 0; b < num_classes; ++b) {
+        for (unsigned a = 0; a < num_classes; ++a)
+          pairs[b][a] = lb_pair(b, a);
+      }
+
+      for (unsigned cp = 0; cp < 0x80; ++cp) {
+        lb cls = lb::AL;
+
+        if (cp < 0x20 || cp == 0x7f)
+          cls = lb::CM;
+        else if (cp >= '0' && cp <= '9')
+          cls = lb::NU;
+
+        switch (cp) {
+        case '\t': cls = lb::BA; break;
+        case '\n': cls = lb::LF; break;
+        case 0x0b:
+        case 0x0c: cls = lb::BK; break;
+        case '\r': cls = lb::CR; break;
+        case ' ':  cls = lb::SP; break;
+        case '!':
+        case '?':  cls = lb::EX; break;
+        case '"':
+        case '\'': cls = lb::QU; break;
+        case '$':
+        case '+':
+        case '\\': cls = lb::PR; break;
+        case '%':  cls = lb::PO; break;
+        case '(':
+        case '[':
+        case '{':  cls = lb::OP; break;
+        case ')':
+        case ']':  cls = lb::CP; break;
+        case '}':  cls = lb::CL; break;
+        case ',':
+        case '.':
+        case ':':
+        case ';':  cls = lb::IS; break;
+        case '-':  cls = lb::HY; break;
+        case '/':  cls = lb::SY; break;
+        case '|':  cls = lb::BA; break;
+        }
+
+        ascii[cp] = uint8_t(cls);
+      }
+    }
+  };
+
+  const lb_table &
+  get_lb_table()
+  {
+    static const lb_table table;
+    return table;
+  }
+
+  // LB1
+  unsigned
+  resolve_class(const database &db, codepoint cp, bool east_asian)
+  {
+    unsigned c = unsigned(db.line_break(cp));
+
+    switch (c) {
+    case unsigned(lb::AI):
+      return unsigned(east_asian ? lb::ID : lb::AL);
+    case unsigned(lb::SA):
+      {
+        gc cat = db.general_category(cp);
+        if (cat == General_Category::Mn || cat == General_Category::Mc)
+          return unsigned(lb::CM);
+      }
+      return unsigned(lb::AL);
+    case unsigned(lb::CJ):
+      return unsigned(lb::NS);
+    case unsigned(lb::SG):
+    case unsigned(lb::XX):
+      return unsigned(lb::AL);
+    }
+
+    return c < num_classes ? c : unsigned(lb::AL);
+  }
+
+}
+
+line_break_iterator::line_break_iterator(const database &db, const text &txt,
+                                         bool east_asian)
+  : _db(db), _text(txt), _pos(0), _break(0), _east_asian(east_asian),
+    _mandatory(false), _done(false)
+{
+  restart();
+}
+
+void
+line_break_iterator::restart()
+{
+  _prev = sot;
+  _last = sot;
+  _spaces = false;
+  _zwj = false;
+  _ri_odd = false;
+  _hl_hyphen = false;
+}
+
+// Returns true if there is a break opportunity before a character of class cls
+bool
+line_break_iterator::step(unsigned cls)
+{
+  unsigned last = _last;
+  bool after_zwj = _zwj;
+
+  // LB4, LB5
+  if (last != sot && is_hard_break(last) && !(is(last, lb::CR)
+                                              && is(cls, lb::LF))) {
+    restart();
+    step(cls);
+    _mandatory = true;
+    return true;
+  }
+
+  _mandatory = false;
+  _last = cls;
+  _zwj = is(cls, lb::ZWJ);
+
+  if (is_hard_break(cls))
+    return false;                                                // LB6
+
+  if (is(cls, lb::SP)) {
+    _spaces = true;
+    return false;                                                // LB7
+  }
+
+  if (is(cls, lb::ZW)) {
+    _prev = cls;
+    _spaces = false;
+    return false;                                                // LB7
+  }
+
+  if (is(cls, lb::CM) || is(cls, lb::ZWJ)) {
+    if (last != sot && !is(last, lb::SP) && !is(last, lb::ZW))
+      return false;                                              // LB9
+    cls = unsigned(lb::AL);                                      // LB10
+  }
+
+  bool brk;
+
+  if (_prev == sot)
+    brk = _spaces;                                               // LB2, 18
+  else if (is(_prev, lb::ZW))
+    brk = true;                                                  // LB8
+  else if (after_zwj && is_ideographic(cls))
+    brk = false;                                                 // LB8a
+  else {
+    switch (get_lb_table().pairs[_prev][cls]) {
+    case prohibited_break:
+      brk = false;
+      break;
+    case indirect_break:
+      brk = _spaces;
+      break;
+    default:
+      brk = true;
+      break;
+    }
+
+    if (!_spaces) {
+      if (_hl_hyphen)
+        brk = false;                                             // LB21a
+      else if (is(_prev, lb::RI) && is(cls, lb::RI) && !_ri_odd)
+        brk = true;                                              // LB30a
+    }
+  }
+
+  _hl_hyphen = (!_spaces && is(_prev, lb::HL)
+                && (is(cls, lb::HY) || is(cls, lb::BA)));
+  _ri_odd = (is(cls, lb::RI)
+             && !(is(_prev, lb::RI) && !_spaces && _ri_odd));
+  _prev = cls;
+  _spaces = false;
+
+  return brk;
+}
+
+template <class Codec>
+size_t
+line_break_iterator::scan()
+{
+  typedef typename Codec::code_unit code_unit;
+
+  const lb_table &table = get_lb_table();
+  const code_unit *begin = text_begin<Codec>(_text);
+  const code_unit *end = text_end<Codec>(_text);
+  const code_unit *ptr = begin + _pos;
+
+  while (ptr < end) {
+    size_t offset = ptr - begin;
+    uint32_t unit = unit_value(*ptr);
+    unsigned cls;
+
+    if (unit < 0x80) {
+      cls = table.ascii[unit];
+      ++ptr;
+    } else {
+      codepoint cp = Codec::decode(ptr, end);
+      cls = resolve_class(_db, cp, _east_asian);
+    }
+
+    if (step(cls)) {
+      _pos = ptr - begin;
+      return offset;
+    }
+  }
+
+  _pos = ptr - begin;
+  return npos;
+}
+
+size_t
+line_break_iterator::next()
+{
+  if (_done)
+    return npos;
+
+  size_t brk = npos;
+  UCD_TEXT_DISPATCH(_text, brk = scan, ());
+
+  if (brk == npos) {
+    // LB3
+    _done = true;
+    if (!_text.length())
+      return npos;
+    brk = _text.length();
+    _mandatory = is_hard_break(_last);
+  }
+
+  _break = brk;
+  return brk;
+}
@@ -0,0 +1,217 @@
+#include <algorithm>
+#include <string>
+
+#include <libucd/libucd.h>
+#include "ucd-ascii.h"
+#include "ucd-output.h"
+#include "ucd-normalize.h"
+
+using namespace ucd;
+
+namespace {
+
+  /* The longest NFKC_Casefold mapping is for U+FDFA, at 18 code points;
+     we fall back to the allocating version if we ever meet a longer one. */
+  enum {
+    max_nfkc_casefold = 32
+  };
+
+  /* Applies the NFKC_Casefold mapping to each (canonically decomposed)
+     code point passed to put(), then decomposes the result again so that
+     it can be passed on for reordering and composition. */
+  template <class Sink>
+  class nfkc_casefold_mapper {
+  private:
+    const database &_db;
+    Sink           &_sink;
+
+  public:
+    nfkc_casefold_mapper(const database &db, Sink &sink)
+      : _db(db), _sink(sink) {}
+
+    void put(codepoint cp) {
+      if (cp < 0x80) {
+        if (cp >= 'A' && cp <= 'Z')
+          cp += 'a' - 'A';
+        _sink.put(cp);
+        return;
+      }
+
+      if (!_db.changes_when_nfkc_casefolded(cp)) {
+        canonical_decompose(_db, cp, _sink);
+        return;
+      }
+
+      codepoint mapped[max_nfkc_casefold];
+      size_t count = _db.nfkc_casefold(cp, mapped, max_nfkc_casefold);
+
+      if (count <= max_nfkc_casefold) {
+        for (size_t n = 0; n < count; ++n)
+          canonical_decompose(_db, mapped[n], _sink);
+      } else {
+        for (codepoint m : _db.nfkc_casefold(cp))
+          canonical_decompose(_db, m, _sink);
+      }
+    }
+  };
+
+  // True if a U+FFFD from decode() was really there, not ill-formed input
+  template <class Codec>
+  bool
+  is_encoded_replacement(const typename Codec::code_unit *start,
+                         const typename Codec::code_unit *ptr)
+  {
+    typename Codec::code_unit buf[Codec::max_length];
+    unsigned len = Codec::encode(replacement_character, buf);
+
+    return size_t(ptr - start) == len && std::equal(buf, buf + len, start);
+  }
+
+  /* A string is unchanged by toNFKC_Casefold() if it's in NFC and none of
+     its characters are changed by the NFKC_Casefold mapping.  We can only
+     be sure of the former if the NFC_Quick_Check is Yes throughout, so we
+     may return false for some strings that are actually unchanged.
+     Ill-formed input becomes U+FFFD, so it is never unchanged. */
+  template <class Codec>
+  bool
+  is_nfkc_casefolded(const database &db,
+                     const typename Codec::code_unit *in, size_t len)
+  {
+    const typename Codec::code_unit *ptr = in, *end = in + len;
+    ccc last_class = 0;
+
+    while (ptr < end) {
+      size_t count = ascii_lower_span(ptr, end - ptr);
+      if (count) {
+        ptr += count;
+        last_class = 0;
+        continue;
+      }
+
+      const typename Codec::code_unit *cp_start = ptr;
+      codepoint cp = Codec::decode(ptr, end);
+
+      if (cp < 0x80)
+        return false;
+
+      if (cp == replacement_character
+          && !is_encoded_replacement<Codec>(cp_start, ptr))
+        return false;
+
+      if (db.changes_when_nfkc_casefolded(cp)
+          || db.nfc_quick_check(cp) != maybe::yes)
+        return false;
+
+      ccc cclass = db.canonical_combining_class(cp);
+      if (cclass && cclass < last_class)
+        return false;
+      last_class = cclass;
+    }
+
+    return true;
+  }
+
+  template <class Codec>
+  size_t
+  nfkc_casefold(const database &db,
+                const typename Codec::code_unit *in, size_t len,
+                typename Codec::code_unit *out, size_t out_len)
+  {
+    typedef output_buffer<Codec> output;
+    typedef canonical_orderer<output> orderer;
+
+    const typename Codec::code_unit *ptr = in, *end = in + len;
+    output buf(out, out_len);
+    orderer composer(db, buf, true);
+    nfkc_casefold_mapper<orderer> mapper(db, composer);
+
+    while (ptr < end) {
+      codepoint cp = Codec::decode(ptr, end);
+      canonical_decompose(db, cp, mapper);
+    }
+
+    composer.flush();
+
+    return buf.length();
+  }
+
+  template <class Codec, class String>
+  String
+  nfkc_casefold_string(const database &db, const String &str)
+  {
+    if (is_nfkc_casefolded<Codec>(db, str.data(), str.size()))
+      return str;
+
+    String result(str.size(), 0);
+    size_t len = nfkc_casefold<Codec>(db, str.data(), str.size(),
+                                      &result[0], result.size());
+
+    if (len > result.size()) {
+      result.resize(len);
+      nfkc_casefold<Codec>(db, str.data(), str.size(),
+                           &result[0], result.size());
+    } else {
+      result.resize(len);
+    }
+
+    return result;
+  }
+
+}
+
+size_t
+database::nfkc_casefold(const char *in, size_t len,
+                        char *out, size_t out_len) const
+{
+  return ::nfkc_casefold<utf8_codec>(*this, in, len, out, out_len);
+}
+
+size_t
+database::nfkc_casefold(const char16_t *in, size_t len,
+                        char16_t *out, size_t out_len) const
+{
+  return ::nfkc_casefold<utf16_codec>(*this, in, len, out, out_len);
+}
+
+size_t
+database::nfkc_casefold(const char32_t *in, size_t len,
+                        char32_t *out, size_t out_len) const
+{
+  return ::nfkc_casefold<utf32_codec>(*this, in, len, out, out_len);
+}
+
+std::string
+database::nfkc_casefold(const std::string &str) const
+{
+  return nfkc_casefold_string<utf8_codec>(*this, str);
+}
+
+std::u16string
+database::nfkc_casefold(const std::u16string &str) const
+{
+  return nfkc_casefold_string<utf16_codec>(*this, str);
+}
+
+std::u32string
+database::nfkc_casefold(const std::u32string &str) const
+{
+  return nfkc_casefold_string<utf32_codec>(*this, str);
+}
+
+bool
+database::is_nfkc_casefolded(const char *in, size_t len) const
+{
+  return ::is_nfkc_casefolded<utf8_codec>(*this, in, len);
+}
+
+bool
+database::is_nfkc_casefolded(const char16_t *in, size_t len) const
+{
+  return ::is_nfkc_casefolded<utf16_codec>(*this, in, len);
+}
+
+bool
+database::is_nfkc_casefolded(const char32_t *in, size_t len) const
+{
+  return ::is_nfkc_casefolded<utf32_codec>(*this, in, len);
+}
@@ -1,8 +1,91 @@
+#include <climits>
 #include <string>
 #include <libucd/libucd.h>
+#include "ucd-text.h"
+#include "ucd-ascii.h"
 
 using namespace ucd;
 
+namespace {
+
+  template <class Codec>
+  bool
+  parse_decimal_text(const database &db, const text &txt, long long &value)
+  {
+    typedef typename Codec::code_unit code_unit;
+
+    const code_unit *ptr = text_begin<Codec>(txt);
+    const code_unit *end = text_end<Codec>(txt);
+    bool negative = false;
+
+    if (ptr < end && (*ptr == '+' || *ptr == '-'))
+      negative = *ptr++ == '-';
+
+    if (ptr == end)
+      return false;
+
+    const unsigned long long limit
+      = (negative ? 0ull - (unsigned long long)LLONG_MIN
+         : (unsigned long long)LLONG_MAX);
+    unsigned long long result = 0;
+    codepoint zero = 0;
+
+    while (ptr < end) {
+      size_t run = ascii_digit_span(ptr, end - ptr);
+      unsigned digit;
+
+      if (run) {
+        if (zero && zero != '0')
+          return false;
+        zero = '0';
+
+        for (size_t n = 0; n < run; ++n) {
+          digit = unsigned(ptr[n] - '0');
+          if (result > (limit - digit) / 10)
+            return false;
+          result = result * 10 + digit;
+        }
+
+        ptr += run;
+        continue;
+      }
+
+      codepoint cp = Codec::decode(ptr, end);
+      codepoint cp_zero;
+      int d = db.digit_value(cp, cp_zero);
+
+      if (d < 0 || (zero && cp_zero != zero))
+        return false;
+
+      zero = cp_zero;
+      digit = unsigned(d);
+
+      if (result > (limit - digit) / 10)
+        return false;
+      result = result * 10 + digit;
+    }
+
+    // This avoids overflow for LLONG_MIN
+    if (negative && result)
+      value = -(long long)(result - 1) - 1;
+    else
+      value = (long long)result;
+
+    return true;
+  }
+
+}
+
+bool
+database::parse_decimal(const text &txt, long long &value) const
+{
+  bool result = false;
+
+  UCD_TEXT_DISPATCH(txt, result = parse_decimal_text, (*this, txt, value));
+
+  return result;
+}
+
 std::string
 numeric::to_string() const
 {
@@ -37,3 +120,25 @@ numeric::to_string() const
     return buffer;
   }
 }
+
+rational
+numeric::to_rational() const
+{
+  if (!_base && _exponent < 0)
+    return rational();
+
+  if (_exponent >= 0)
+    return rational((long long)*this);
+
+  long long num = _multiplier;
+  long long den = llpow(_base, -_exponent);
+  long long a = num < 0 ? -num : num, b = den;
+
+  while (b) {
+    long long t = a % b;
+    a = b;
+    b = t;
+  }
+
+  return rational(num / a, den / a);
+}
@@ -0,0 +1,294 @@
+#include <cstring>
+
+#include <libucd/libucd.h>
+#include "ucd-text.h"
+
+using namespace ucd;
+
+const unsigned script_set::npos;
+const unsigned script_set::max_scripts;
+const unsigned script_set::num_words;
+const size_t script_iterator::npos;
+const unsigned script_iterator::max_brackets;
+
+namespace {
+
+  // Every script in script_list.h; a script's index is its position
+  constexpr sc all_scripts[] = {
+#define UCD_SCRIPT(code) Script::code,
+#include <libucd/script_list.h>
+  };
+
+  const unsigned num_scripts = Script_Index::count;
+
+  static_assert(num_scripts <= script_set::max_scripts,
+                "script_set needs to be bigger");
+  static_assert(Script::Latn == 'Latn' && Script::Zzzz == 'Zzzz',
+                "script codes in types.h don't match their names");
+
+  constexpr bool
+  scripts_in_order()
+  {
+    for (unsigned n = 1; n < num_scripts; ++n) {
+      if (all_scripts[n - 1] >= all_scripts[n])
+        return false;
+    }
+    return true;
+  }
+
+  static_assert(scripts_in_order(),
+                "script_list.h must be in order, with no duplicates");
+
+  /* index() uses an open-addressed hash table, built at compile time, that
+     maps each script's code to one more than its index (zero is empty).
+     It is kept less than half full, so a lookup rarely needs to probe. */
+  const unsigned hash_bits = 9;
+  const unsigned hash_size = 1u << hash_bits;
+
+  static_assert(num_scripts < hash_size / 2,
+                "the script hash table needs to be bigger");
+
+  constexpr unsigned
+  script_hash(sc script)
+  {
+    return (uint32_t(script) * 0x9e3779b1u) >> (32 - hash_bits);
+  }
+
+  struct script_hash_table {
+    uint16_t slots[hash_size];
+  };
+
+  constexpr script_hash_table
+  make_script_hash_table()
+  {
+    script_hash_table table = {};
+
+    for (unsigned n = 0; n < num_scripts; ++n) {
+      unsigned h = script_hash(all_scripts[n]);
+
+      while (table.slots[h])
+        h = (h + 1) & (hash_size - 1);
+
+      table.slots[h] = uint16_t(n + 1);
+    }
+
+    return table;
+  }
+
+  constexpr script_hash_table script_hashes = make_script_hash_table();
+
+  inline bool
+  contains(const sc *scripts, size_t count, sc script)
+  {
+    for (size_t n = 0; n < count; ++n) {
+      if (scripts[n] == script)
+        return true;
+    }
+    return false;
+  }
+
+}
+
+unsigned
+script_set::index(sc script)
+{
+  for (unsigned h = script_hash(script); ; h = (h + 1) & (hash_size - 1)) {
+    unsigned slot = script_hashes.slots[h];
+
+    if (!slot)
+      return npos;
+    if (all_scripts[slot - 1] == script)
+      return slot - 1;
+  }
+}
+
+sc
+script_set::script(unsigned ndx)
+{
+  if (ndx >= num_scripts)
+    return Script::bad_script;
+  return all_scripts[ndx];
+}
+
+size_t
+script_set::size() const
+{
+  size_t count = 0;
+
+  for (unsigned n = 0; n < num_words; ++n) {
+    for (uint64_t w = _bits[n]; w; w &= w - 1)
+      ++count;
+  }
+
+  return count;
+}
+
+sc
+script_set::first() const
+{
+  for (unsigned n = 0; n < num_words; ++n) {
+    if (!_bits[n])
+      continue;
+
+    unsigned bit = 0;
+    while (!((_bits[n] >> bit) & 1))
+      ++bit;
+
+    return script(n * 64 + bit);
+  }
+
+  return Script::bad_script;
+}
+
+/* Adds a character that could be any of the given scripts to the current
+   run, returning false if it doesn't belong there. */
+bool
+script_iterator::add(const sc *scripts, size_t count)
+{
+  if (count == 1
+      && (scripts[0] == Script::Common || scripts[0] == Script::Inherited))
+    return true;
+
+  // Script_Extensions lists are nowhere near this long, but just in case
+  if (count > 64)
+    count = 64;
+
+  if (!_num_candidates) {
+    _candidates = count > 1 ? scripts : nullptr;
+    _candidate = scripts[0];
+    _num_candidates = unsigned(count);
+    _possible = count == 64 ? ~uint64_t(0) : (uint64_t(1) << count) - 1;
+  } else {
+    uint64_t possible = 0;
+
+    for (unsigned n = 0; n < _num_candidates; ++n) {
+      uint64_t bit = uint64_t(1) << n;
+      sc candidate = _candidates ? _candidates[n] : _candidate;
+
+      if ((_possible & bit) && contains(scripts, count, candidate))
+        possible |= bit;
+    }
+
+    if (!possible)
+      return false;
+
+    _possible = possible;
+  }
+
+  // The run's script is the first candidate left
+  for (unsigned n = 0; n < _num_candidates; ++n) {
+    if (_possible & (uint64_t(1) << n)) {
+      _script = _candidates ? _candidates[n] : _candidate;
+      break;
+    }
+  }
+
+  // Brackets opened before we knew the script get it now
+  for (; _unresolved < _depth; ++_unresolved)
+    _brackets[_unresolved].script = _script;
+
+  return true;
+}
+
+template <class Codec>
+size_t
+script_iterator::scan()
+{
+  typedef typename Codec::code_unit code_unit;
+
+  const code_unit *begin = text_begin<Codec>(_text);
+  const code_unit *end = text_end<Codec>(_text);
+  const code_unit *ptr = begin + _start;
+
+  while (ptr < end) {
+    const code_unit *cp_start = ptr;
+    codepoint cp = Codec::decode(ptr, end);
+    const sc *scripts;
+    sc script;
+    size_t count;
+
+    // ASCII has no Script_Extensions, and only the letters are Latin
+    if (cp < 0x80) {
+      script = ((cp >= 'A' && cp <= 'Z') || (cp >= 'a' && cp <= 'z')
+                ? Script::Latin : Script::Common);
+      scripts = &script;
+      count = 1;
+    } else {
+      count = _db.script_extensions(cp, scripts);
+      if (!count) {
+        script = _db.script(cp);
+        scripts = &script;
+        count = 1;
+      }
+    }
+
+    // A closing bracket takes the script of the bracket it closes
+    bpt type = Bidi_Paired_Bracket_Type::None;
+    codepoint paired = cp;
+    unsigned match = _depth;
+
+    if (cp >= 0x80 || cp == '(' || cp == ')' || cp == '[' || cp == ']'
+        || cp == '{' || cp == '}')
+      paired = _db.bidi_paired_bracket(cp, type);
+
+    if (type == Bidi_Paired_Bracket_Type::Close) {
+      while (match > 0 && _brackets[match - 1].closing != cp)
+        --match;
+
+      if (match) {
+        script = _brackets[--match].script;
+        scripts = &script;
+        count = 1;
+      } else
+        match = _depth;
+    }
+
+    if (!add(scripts, count)) {
+      ptr = cp_start;
+      break;
+    }
+
+    if (type == Bidi_Paired_Bracket_Type::Open) {
+      // If there are too many, forget the oldest
+      if (_depth == max_brackets) {
+        memmove(_brackets, _brackets + 1,
+                (max_brackets - 1) * sizeof(bracket));
+        --_depth;
+        if (_unresolved)
+          --_unresolved;
+      }
+
+      _brackets[_depth].closing = paired;
+      _brackets[_depth].script = _script;
+      ++_depth;
+
+      // If we don't know the run's script yet, add() will fill it in
+      if (_num_candidates)
+        _unresolved = _depth;
+    } else if (match < _depth) {
+      _depth = match;
+      if (_unresolved > _depth)
+        _unresolved = _depth;
+    }
+  }
+
+  return ptr - begin;
+}
+
+size_t
+script_iterator::next()
+{
+  if (_end >= _text.length())
+    return npos;
+
+  _start = _end;
+  _script = Script::Common;
+  _candidates = nullptr;
+  _num_candidates = 0;
+  _possible = 0;
+  _unresolved = _depth;
+
+  UCD_TEXT_DISPATCH(_text, _end = scan, ());
+
+  return _end;
+}
@@ -0,0 +1,462 @@
+#include <string>
+#include <cstring>
+
+#include <libucd/libucd.h>
+#include "ucd-format.h"
+#include "ucd-impl.h"
+#include "ucd-trie.h"
+#include "ucd-text.h"
+#include "ucd-ascii.h"
+#include "ucd-output.h"
+#include "ucd-normalize.h"
+
+using namespace ucd;
+
+namespace {
+
+  /* Replaces each (canonically decomposed and ordered) code point passed to
+     put() with its prototype from confusables.txt, then decomposes the
+     result again so that it can be passed on for reordering. */
+  template <class Sink>
+  class confusable_mapper {
+  private:
+    const database               &_db;
+    const struct ucd_confusables *_pcnft;
+    Sink                         &_sink;
+
+  public:
+    confusable_mapper(const database &db,
+                      const struct ucd_confusables *pcnft, Sink &sink)
+      : _db(db), _pcnft(pcnft), _sink(sink) {}
+
+    void put(codepoint cp) {
+      uint32_t ndx = _pcnft ? ucd_trie_lookup(&_pcnft->trie, cp) : 0;
+
+      if (!ndx || ndx > _pcnft->num_prototypes) {
+        _sink.put(cp);
+        return;
+      }
+
+      const uint8_t *base = (const uint8_t *)_pcnft;
+      const uint32_t *offsets
+        = (const uint32_t *)(base + _pcnft->offsets_offset);
+      const uint32_t *prototype
+        = (const uint32_t *)(base + offsets[ndx - 1]);
+
+      for (uint32_t n = 0; n < prototype[0]; ++n)
+        canonical_decompose(_db, prototype[n + 1], _sink);
+    }
+  };
+
+  template <class Codec>
+  size_t
+  skeleton(const database &db, const struct ucd_confusables *pcnft,
+           const typename Codec::code_unit *in, size_t len,
+           typename Codec::code_unit *out, size_t out_len)
+  {
+    typedef output_buffer<Codec> output;
+    typedef canonical_orderer<output> final_orderer;
+    typedef confusable_mapper<final_orderer> mapper;
+    typedef canonical_orderer<mapper> orderer;
+
+    const typename Codec::code_unit *ptr = in, *end = in + len;
+    output buf(out, out_len);
+    final_orderer reorder(db, buf, false);
+    mapper map(db, pcnft, reorder);
+    orderer order(db, map, false);
+
+    while (ptr < end) {
+      codepoint cp = Codec::decode(ptr, end);
+      canonical_decompose(db, cp, order);
+    }
+
+    order.flush();
+    reorder.flush();
+
+    return buf.length();
+  }
+
+  template <class Codec, class String>
+  String
+  skeleton_string(const database &db, const struct ucd_confusables *pcnft,
+                  const String &str)
+  {
+    String result(str.size(), 0);
+    size_t len = skeleton<Codec>(db, pcnft, str.data(), str.size(),
+                                 &result[0], result.size());
+
+    if (len > result.size()) {
+      result.resize(len);
+      skeleton<Codec>(db, pcnft, str.data(), str.size(),
+                      &result[0], result.size());
+    } else {
+      result.resize(len);
+    }
+
+    return result;
+  }
+
+  /* UTS #39 augments the script sets of Han, Hiragana, Katakana, Hangul and
+     Bopomofo characters with the writing systems that use them (Jpan, Kore
+     and Hanb).  script_set has no room for those, so we keep them as flags;
+     they also happen to correspond to the three combinations of scripts
+     allowed at Highly_Restrictive, if you add Latin and Han to each. */
+  enum {
+    cjk_jpan = 0x01,
+    cjk_kore = 0x02,
+    cjk_hanb = 0x04,
+
+    cjk_all  = 0x07
+  };
+
+  inline unsigned
+  cjk_writing_systems(const script_set &scripts)
+  {
+    unsigned result = 0;
+
+    if (scripts.test(Script_Index::Hani))
+      return cjk_all;
+    if (scripts.test(Script_Index::Hira) || scripts.test(Script_Index::Kana))
+      result |= cjk_jpan;
+    if (scripts.test(Script_Index::Hang))
+      result |= cjk_kore;
+    if (scripts.test(Script_Index::Bopo))
+      result |= cjk_hanb;
+
+    return result;
+  }
+
+  class restriction_scanner {
+  private:
+    bool       _any;          // Seen anything that isn't Common or Inherited
+    script_set _resolved;     // The resolved script set so far
+    unsigned   _resolved_cjk;
+    unsigned   _covered;      // Highly_Restrictive combinations still OK
+    bool       _any_others;   // Seen anything that isn't Latin
+    script_set _others;       // The scripts all of those have in common
+
+  public:
+    restriction_scanner()
+      : _any(false), _resolved_cjk(cjk_all), _covered(cjk_all),
+        _any_others(false) {}
+
+    void add(const script_set &scripts) {
+      if (scripts.test(Script_Index::Zyyy) || scripts.test(Script_Index::Zinh))
+        return;
+
+      unsigned cjk = cjk_writing_systems(scripts);
+      bool latin = scripts.test(Script_Index::Latn);
+
+      if (!_any) {
+        _resolved = scripts;
+        _any = true;
+      } else {
+        _resolved &= scripts;
+      }
+
+      _resolved_cjk &= cjk;
+      _covered &= latin ? unsigned(cjk_all) : cjk;
+
+      if (!latin) {
+        if (!_any_others) {
+          _others = scripts;
+          _any_others = true;
+        } else {
+          _others &= scripts;
+        }
+      }
+    }
+
+    ucd::restriction_level level() const {
+      if (!_any || !_resolved.empty() || _resolved_cjk)
+        return restriction_level::single_script;
+
+      if (_covered)
+        return restriction_level::highly_restrictive;
+
+      script_set others = _others;
+      others.reset(Script_Index::Cyrl);
+      others.reset(Script_Index::Grek);
+
+      if (!others.empty())
+        return restriction_level::moderately_restrictive;
+
+      return restriction_level::minimally_restrictive;
+    }
+  };
+
+  inline bool
+  is_ascii_letter(codepoint cp)
+  {
+    return (cp >= 'a' && cp <= 'z') || (cp >= 'A' && cp <= 'Z');
+  }
+
+  template <class Codec>
+  ucd::restriction_level
+  text_restriction_level(const database &db, const text &txt)
+  {
+    typedef typename Codec::code_unit code_unit;
+
+    const code_unit *ptr = text_begin<Codec>(txt);
+    const code_unit *end = text_end<Codec>(txt);
+
+    if (ascii_span(ptr, end - ptr) == size_t(end - ptr))
+      return restriction_level::ascii_only;
+
+    const script_set latin(Script::Latin);
+    restriction_scanner scanner;
+
+    while (ptr < end) {
+      // ASCII is either Latin or Common, and adding Latin twice is a no-op
+      size_t run = ascii_span(ptr, end - ptr);
+
+      if (run) {
+        for (const code_unit *run_end = ptr + run; ptr < run_end; ++ptr) {
+          if (is_ascii_letter(*ptr)) {
+            scanner.add(latin);
+            ptr = run_end;
+            break;
+          }
+        }
+        continue;
+      }
+
+      codepoint cp = Codec::decode(ptr, end);
+      scanner.add(db.script_extension_set(cp));
+    }
+
+    return scanner.level();
+  }
+
+  bool
+  is_unassigned(const database &db, codepoint cp)
+  {
+    return db.general_category(cp) == General_Category::Unassigned;
+  }
+
+  const trie_flag hidden_flags[] = {
+    { UCD_HIDDEN_BIDI_CONTROL,
+      has_property<&database::bidi_control> },
+    { UCD_HIDDEN_DEFAULT_IGNORABLE,
+      has_property<&database::default_ignorable_code_point> },
+    { UCD_HIDDEN_JOIN_CONTROL,
+      has_property<&database::join_control> },
+    { UCD_HIDDEN_VARIATION_SELECTOR,
+      has_property<&database::variation_selector> },
+    { UCD_HIDDEN_NONCHARACTER,
+      has_property<&database::noncharacter_code_point> },
+    { UCD_HIDDEN_UNASSIGNED, is_unassigned }
+  };
+
+  template <class Codec>
+  size_t
+  find_hidden(const flag_trie &props, const text &txt, size_t pos,
+              unsigned mask)
+  {
+    typedef typename Codec::code_unit code_unit;
+
+    const code_unit *begin = text_begin<Codec>(txt);
+    const code_unit *end = text_end<Codec>(txt);
+    const code_unit *ptr = begin + pos;
+
+    while (ptr < end) {
+      ptr += ascii_span(ptr, end - ptr);
+      if (ptr == end)
+        break;
+
+      const code_unit *cp_start = ptr;
+      codepoint cp = Codec::decode(ptr, end);
+
+      if (props.lookup(cp) & mask)
+        return cp_start - begin;
+    }
+
+    return end - begin;
+  }
+
+  // Copies a run of code units we're keeping; out may be the same as in
+  template <class Codec>
+  void
+  copy_run(output_buffer<Codec> &buf,
+           const typename Codec::code_unit *from,
+           const typename Codec::code_unit *to)
+  {
+    typename Codec::code_unit *dest = buf.reserve(to - from);
+
+    if (dest)
+      std::memmove(dest, from, (to - from) * sizeof(*from));
+  }
+
+  template <class Codec>
+  size_t
+  strip_hidden(const flag_trie &props,
+               const typename Codec::code_unit *in, size_t len,
+               typename Codec::code_unit *out, size_t out_len,
+               unsigned mask)
+  {
+    typedef typename Codec::code_unit code_unit;
+
+    const code_unit *ptr = in, *end = in + len;
+    const code_unit *keep = in;
+    output_buffer<Codec> buf(out, out_len);
+
+    while (ptr < end) {
+      ptr += ascii_span(ptr, end - ptr);
+      if (ptr == end)
+        break;
+
+      const code_unit *cp_start = ptr;
+      codepoint cp = Codec::decode(ptr, end);
+
+      if (props.lookup(cp) & mask) {
+        copy_run(buf, keep, cp_start);
+        keep = ptr;
+      }
+    }
+
+    copy_run(buf, keep, end);
+
+    return buf.length();
+  }
+
+  template <class Codec, class String>
+  String
+  strip_hidden_string(const flag_trie &props, const String &str,
+                      unsigned mask)
+  {
+    text txt(str);
+    size_t first = find_hidden<Codec>(props, txt, 0, mask);
+
+    if (first == str.size())
+      return str;
+
+    String result(str);
+    size_t len = strip_hidden<Codec>(props, result.data() + first,
+                                     result.size() - first,
+                                     &result[first], result.size() - first,
+                                     mask);
+    result.resize(first + len);
+
+    return result;
+  }
+
+}
+
+size_t
+database::skeleton(const char *in, size_t len,
+                   char *out, size_t out_len) const
+{
+  return ::skeleton<utf8_codec>(*this, _pimpl->get_cnft(),
+                                in, len, out, out_len);
+}
+
+size_t
+database::skeleton(const char16_t *in, size_t len,
+                   char16_t *out, size_t out_len) const
+{
+  return ::skeleton<utf16_codec>(*this, _pimpl->get_cnft(),
+                                 in, len, out, out_len);
+}
+
+size_t
+database::skeleton(const char32_t *in, size_t len,
+                   char32_t *out, size_t out_len) const
+{
+  return ::skeleton<utf32_codec>(*this, _pimpl->get_cnft(),
+                                 in, len, out, out_len);
+}
+
+std::string
+database::skeleton(const std::string &str) const
+{
+  return skeleton_string<utf8_codec>(*this, _pimpl->get_cnft(), str);
+}
+
+std::u16string
+database::skeleton(const std::u16string &str) const
+{
+  return skeleton_string<utf16_codec>(*this, _pimpl->get_cnft(), str);
+}
+
+std::u32string
+database::skeleton(const std::u32string &str) const
+{
+  return skeleton_string<utf32_codec>(*this, _pimpl->get_cnft(), str);
+}
+
+ucd::restriction_level
+database::restriction_level(const text &txt) const
+{
+  ucd::restriction_level result = ucd::restriction_level::ascii_only;
+
+  UCD_TEXT_DISPATCH(txt, result = text_restriction_level, (*this, txt));
+
+  return result;
+}
+
+unsigned
+database::hidden_properties(codepoint cp) const
+{
+  flag_trie props(*this, _pimpl->get_hidt(), hidden_flags);
+  return props.lookup(cp);
+}
+
+size_t
+database::find_hidden(const text &txt, size_t pos, unsigned mask) const
+{
+  flag_trie props(*this, _pimpl->get_hidt(), hidden_flags);
+  size_t result = txt.length();
+
+  if (pos >= txt.length())
+    return txt.length();
+
+  UCD_TEXT_DISPATCH(txt, result = ::find_hidden,
+                    (props, txt, pos, mask));
+
+  return result;
+}
+
+size_t
+database::strip_hidden(const char *in, size_t len,
+                       char *out, size_t out_len, unsigned mask) const
+{
+  flag_trie props(*this, _pimpl->get_hidt(), hidden_flags);
+  return ::strip_hidden<utf8_codec>(props, in, len, out, out_len, mask);
+}
+
+size_t
+database::strip_hidden(const char16_t *in, size_t len,
+                       char16_t *out, size_t out_len, unsigned mask) const
+{
+  flag_trie props(*this, _pimpl->get_hidt(), hidden_flags);
+  return ::strip_hidden<utf16_codec>(props, in, len, out, out_len, mask);
+}
+
+size_t
+database::strip_hidden(const char32_t *in, size_t len,
+                       char32_t *out, size_t out_len, unsigned mask) const
+{
+  flag_trie props(*this, _pimpl->get_hidt(), hidden_flags);
+  return ::strip_hidden<utf32_codec>(props, in, len, out, out_len, mask);
+}
+
+std::string
+database::strip_hidden(const std::string &str, unsigned mask) const
+{
+  flag_trie props(*this, _pimpl->get_hidt(), hidden_flags);
+  return strip_hidden_string<utf8_codec>(props, str, mask);
+}
+
+std::u16string
+database::strip_hidden(const std::u16string &str, unsigned mask) const
+{
+  flag_trie props(*this, _pimpl->get_hidt(), hidden_flags);
+  return strip_hidden_string<utf16_codec>(props, str, mask);
+}
+
+std::u32string
+database::strip_hidden(const std::u32string &str, unsigned mask) const
+{
+  flag_trie props(*this, _pimpl->get_hidt(), hidden_flags);
+  return strip_hidden_string<utf32_codec>(props, str, mask);
+}
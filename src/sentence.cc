@@ -0,0 +1,355 @@
+#include <libucd/libucd.h>
+#include "ucd-text.h"
+
+using namespace ucd;
+
+const size_t sentence_iterator::npos;
+
+namespace {
+
+  /* The states of the sentence break state machine.  Other than st_sot and
+     st_lookahead, they record what we've seen since the last place where
+     the next character could definitely not end a sentence (ignoring
+     Extend and Format, per SB5).
+
+     In st_lookahead we've seen ATerm Close* Sp* followed by something that
+     means we need to look ahead to decide whether SB8 applies; we may have
+     to look arbitrarily far, but all we need to remember is where the
+     sentence would end if it turns out that it doesn't. */
+  enum {
+    st_sot = 0,
+    st_other,
+    st_cr,
+    st_parasep,
+    st_upper_lower,
+
+    // ATerm Close* Sp*, with or without Upper or Lower before the ATerm
+    st_aterm,
+    st_ul_aterm,
+    st_aterm_close,
+    st_aterm_sp,
+
+    // STerm Close* Sp*
+    st_sterm,
+    st_sterm_close,
+    st_sterm_sp,
+
+    st_lookahead,
+
+    num_states,
+
+    num_classes = 15,
+
+    no_break = 0x80,
+    state_mask = 0x7f
+  };
+
+  inline bool
+  is(unsigned c, SB sb)
+  {
+    return c == unsigned(sb);
+  }
+
+  inline bool
+  is_parasep(unsigned c)
+  {
+    return is(c, SB::SE) || is(c, SB::CR) || is(c, SB::LF);
+  }
+
+  inline bool
+  is_saterm(unsigned c)
+  {
+    return is(c, SB::AT) || is(c, SB::ST);
+  }
+
+  unsigned
+  start_state(unsigned c)
+  {
+    switch (c) {
+    case unsigned(SB::CR): return st_cr;
+    case unsigned(SB::LF):
+    case unsigned(SB::SE): return st_parasep;
+    case unsigned(SB::UP):
+    case unsigned(SB::LO): return st_upper_lower;
+    case unsigned(SB::AT): return st_aterm;
+    case unsigned(SB::ST): return st_sterm;
+    default:               return st_other;
+    }
+  }
+
+  // Rules SB3 to SB998 from UAX #29
+  bool
+  sb_joins(unsigned state, unsigned c, unsigned &next)
+  {
+    if (state == st_sot) {
+      next = start_state(c);
+      return true;
+    }
+
+    if (state == st_cr && is(c, SB::LF)) {
+      next = st_parasep;
+      return true;                                                   // SB3
+    }
+
+    if (state == st_cr || state == st_parasep)
+      return false;                                                  // SB4
+
+    if (is(c, SB::EX) || is(c, SB::FO)) {
+      next = state;
+      return true;                                                   // SB5
+    }
+
+    switch (state) {
+    case st_aterm:
+    case st_ul_aterm:
+      if (is(c, SB::NU)) {
+        next = st_other;
+        return true;                                                 // SB6
+      }
+      if (state == st_ul_aterm && is(c, SB::UP)) {
+        next = st_upper_lower;
+        return true;                                                 // SB7
+      }
+      // Fall through
+    case st_aterm_close:
+    case st_aterm_sp:
+      if (is(c, SB::LO)) {
+        next = st_upper_lower;
+        return true;                                                 // SB8
+      }
+      if (is(c, SB::SC) || is_saterm(c)) {
+        next = start_state(c);
+        return true;                                                 // SB8a
+      }
+      if (is(c, SB::CL) && state != st_aterm_sp) {
+        next = st_aterm_close;
+        return true;                                                 // SB9
+      }
+      if (is(c, SB::SP)) {
+        next = st_aterm_sp;
+        return true;                                             // SB9, 10
+      }
+      if (is_parasep(c)) {
+        next = start_state(c);
+        return true;                                             // SB9, 10
+      }
+      if (is(c, SB::LE) || is(c, SB::UP))
+        return false;                                                // SB11
+      next = st_lookahead;
+      return true;                                                   // SB8
+
+    case st_sterm:
+    case st_sterm_close:
+    case st_sterm_sp:
+      if (is(c, SB::SC) || is_saterm(c)) {
+        next = start_state(c);
+        return true;                                                 // SB8a
+      }
+      if (is(c, SB::CL) && state != st_sterm_sp) {
+        next = st_sterm_close;
+        return true;                                                 // SB9
+      }
+      if (is(c, SB::SP)) {
+        next = st_sterm_sp;
+        return true;                                             // SB9, 10
+      }
+      if (is_parasep(c)) {
+        next = start_state(c);
+        return true;                                             // SB9, 10
+      }
+      return false;                                                  // SB11
+
+    case st_lookahead:
+      if (is(c, SB::LO)) {
+        next = st_upper_lower;
+        return true;                                                 // SB8
+      }
+      if (is(c, SB::LE) || is(c, SB::UP) || is_parasep(c) || is_saterm(c))
+        return false;                                                // SB11
+      next = st_lookahead;
+      return true;
+
+    case st_upper_lower:
+      if (is(c, SB::AT)) {
+        next = st_ul_aterm;
+        return true;
+      }
+      break;
+    }
+
+    next = start_state(c);
+    return true;                                                     // SB998
+  }
+
+  /* The rules compiled into a table indexed by state and the Sentence_Break
+     value of the next code point, as for words (see word.cc). */
+  struct sb_table {
+    uint8_t entries[num_states][num_classes];
+    uint8_t ascii[0x80];
+
+    sb_table() {
+      for (unsigned state = 0; state < num_states; ++state) {
+        for (unsigned c = 0; c < num_classes; ++c) {
+          unsigned next = st_other;
+          bool joined = sb_joins(state, c, next);
+          entries[state][c] = joined ? (next | no_break) : 0;
+        }
+      }
+
+      for (unsigned cp = 0; cp < 0x80; ++cp) {
+        SB sb = SB::XX;
+
+        if (cp >= 'A' && cp <= 'Z')
+          sb = SB::UP;
+        else if (cp >= 'a' && cp <= 'z')
+          sb = SB::LO;
+        else if (cp >= '0' && cp <= '9')
+          sb = SB::NU;
+        else {
+          switch (cp) {
+          case '\t':
+          case 0x0b:
+          case 0x0c:
+          case ' ':  sb = SB::SP; break;
+          case '\n': sb = SB::LF; break;
+          case '\r': sb = SB::CR; break;
+          case '!':
+          case '?':  sb = SB::ST; break;
+          case '.':  sb = SB::AT; break;
+          case '"':
+          case '\'':
+          case '(':
+          case ')':
+          case '[':
+          case ']':
+          case '{':
+          case '}':  sb = SB::CL; break;
+          case ',':
+          case '-':
+          case ':':  sb = SB::SC; break;
+          }
+        }
+
+        ascii[cp] = uint8_t(sb);
+      }
+    }
+  };
+
+  const sb_table &
+  get_sb_table()
+  {
+    static const sb_table table;
+    return table;
+  }
+
+  inline unsigned
+  sb_class(const database &db, const sb_table &table, codepoint cp)
+  {
+    if (cp < 0x80)
+      return table.ascii[cp];
+
+    unsigned c = unsigned(db.sentence_break(cp));
+    return c < num_classes ? c : unsigned(SB::XX);
+  }
+
+}
+
+sentence_iterator::sentence_iterator(const database &db)
+  : _db(db), _state(st_sot), _accept(0), _pending_len(0),
+    _current_start(0), _current(0)
+{
+}
+
+sentence_iterator::sentence_iterator(const database &db, const text &txt)
+  : sentence_iterator(db)
+{
+  feed(txt, true);
+}
+
+void
+sentence_iterator::emit(size_t end)
+{
+  _pending[_pending_len++] = end;
+}
+
+void
+sentence_iterator::push(unsigned cls, size_t begin, size_t end)
+{
+  const sb_table &table = get_sb_table();
+  unsigned entry = table.entries[_state][cls];
+
+  if (!(entry & no_break)) {
+    /* If SB8 didn't apply, the sentence ends where the lookahead started;
+       everything we skipped over since then is ordinary text (it can't
+       contain anything that would give it a different state). */
+    if (_state == st_lookahead) {
+      emit(_accept);
+      _state = st_other;
+      entry = table.entries[_state][cls];
+    }
+
+    if (!(entry & no_break)) {
+      emit(begin);
+      _state = st_sot;
+      entry = table.entries[st_sot][cls];
+    }
+  }
+
+  _state = entry & state_mask;
+
+  if (_state != st_lookahead)
+    _accept = end;
+}
+
+void
+sentence_iterator::finish()
+{
+  size_t end = _input.end();
+
+  if (_state == st_sot)
+    return;
+
+  if (_state == st_lookahead) {
+    emit(_accept);
+    if (_accept < end)
+      emit(end);
+  } else {
+    emit(end);
+  }
+
+  _state = st_sot;
+}
+
+template <class Codec>
+void
+sentence_iterator::scan()
+{
+  const sb_table &table = get_sb_table();
+  codepoint cp;
+  size_t begin, end;
+
+  while (!_pending_len && read_codepoint<Codec>(_input, cp, begin, end))
+    push(sb_class(_db, table, cp), begin, end);
+}
+
+size_t
+sentence_iterator::next()
+{
+  while (!_pending_len) {
+    if (_input.has_input()) {
+      UCD_TEXT_DISPATCH(_input.chunk, scan, ());
+    } else {
+      if (_input.final)
+        finish();
+      if (!_pending_len)
+        return npos;
+    }
+  }
+
+  _current_start = _current;
+  _current = _pending[0];
+  _pending[0] = _pending[1];
+  --_pending_len;
+
+  return _current;
+}
@@ -0,0 +1,199 @@
+#include <libucd/libucd.h>
+#include "ucd-text.h"
+
+using namespace ucd;
+
+const size_t syllable_iterator::npos;
+
+namespace {
+
+  // The classes the syllable grammar works with
+  enum {
+    c_other,          // Anything else
+    c_mark,           // Other, but a combining mark of some sort
+    c_base,           // Consonants, independent vowels, placeholders &c.
+    c_repha,          // Consonant_Preceding_Repha, Consonant_Prefixed
+    c_halant,         // Virama, Invisible_Stacker, Number_Joiner
+    c_nukta,
+    c_medial,         // Consonant_Medial, Consonant_Subjoined
+    c_vowel,          // Vowel_Dependent, Vowel
+    c_modifier,       // Bindu, Visarga, tone marks, final consonants &c.
+    c_killer,         // Pure_Killer, Consonant_Killer
+    c_zwj,
+    c_zwnj,
+
+    num_classes
+  };
+
+  const uint8_t insc_classes[] = {
+    c_other,          // Other
+    c_base,           // Avagraha
+    c_modifier,       // Bindu
+    c_base,           // Brahmi_Joining_Number
+    c_modifier,       // Cantillation_Mark
+    c_base,           // Consonant
+    c_base,           // Consonant_Dead
+    c_modifier,       // Consonant_Final
+    c_base,           // Consonant_Head_Letter
+    c_medial,         // Consonant_Medial
+    c_base,           // Consonant_Placeholder
+    c_repha,          // Consonant_Preceding_Repha
+    c_medial,         // Consonant_Subjoined
+    c_modifier,       // Consonant_Succeeding_Repha
+    c_modifier,       // Gemination_Mark
+    c_halant,         // Invisible_Stacker
+    c_zwj,            // Joiner
+    c_base,           // Modifying_Letter
+    c_zwnj,           // Non_Joiner
+    c_nukta,          // Nukta
+    c_base,           // Number
+    c_halant,         // Number_Joiner
+    c_killer,         // Pure_Killer
+    c_modifier,       // Register_Shifter
+    c_base,           // Tone_Letter
+    c_modifier,       // Tone_Mark
+    c_halant,         // Virama
+    c_modifier,       // Visarga
+    c_vowel,          // Vowel
+    c_vowel,          // Vowel_Dependent
+    c_base,           // Vowel_Independent
+    c_repha,          // Consonant_Prefixed
+    c_base,           // Consonant_With_Stacker
+    c_killer,         // Consonant_Killer
+    c_modifier        // Syllable_Modifier
+  };
+
+  enum {
+    s_end,            // There's a boundary before this code point
+    s_start,
+    s_repha,
+    s_base,
+    s_halant,
+    s_explicit,       // After a halant and ZWNJ, i.e. an explicit halant
+    s_medial,
+    s_vowel,
+    s_modifier,
+    s_killed,
+
+    num_states
+  };
+
+  /* The grammar, compiled by hand into a table indexed by state and the
+     class of the next code point (in the order above).  In the start state,
+     a mark that would normally follow a base behaves as if the base were
+     there. */
+  const uint8_t transitions[num_states][num_classes] = {
+    // s_end
+    { s_end,      s_end,      s_end,      s_end,      s_end,      s_end,
+      s_end,      s_end,      s_end,      s_end,      s_end,      s_end },
+
+    // s_start
+    { s_end,      s_end,      s_base,     s_repha,    s_halant,   s_base,
+      s_medial,   s_vowel,    s_modifier, s_killed,   s_end,      s_end },
+
+    // s_repha
+    { s_end,      s_repha,    s_base,     s_end,      s_end,      s_repha,
+      s_end,      s_end,      s_end,      s_end,      s_repha,    s_end },
+
+    // s_base
+    { s_end,      s_modifier, s_end,      s_end,      s_halant,   s_base,
+      s_medial,   s_vowel,    s_modifier, s_killed,   s_base,     s_base },
+
+    // s_halant
+    { s_end,      s_modifier, s_base,     s_end,      s_end,      s_halant,
+      s_medial,   s_end,      s_modifier, s_end,      s_halant,   s_explicit },
+
+    // s_explicit
+    { s_end,      s_modifier, s_end,      s_end,      s_end,      s_end,
+      s_end,      s_end,      s_end,      s_end,      s_end,      s_end },
+
+    // s_medial
+    { s_end,      s_modifier, s_end,      s_end,      s_halant,   s_medial,
+      s_medial,   s_vowel,    s_modifier, s_killed,   s_medial,   s_medial },
+
+    // s_vowel
+    { s_end,      s_vowel,    s_end,      s_end,      s_end,      s_vowel,
+      s_end,      s_vowel,    s_modifier, s_end,      s_vowel,    s_vowel },
+
+    // s_modifier
+    { s_end,      s_modifier, s_end,      s_end,      s_end,      s_modifier,
+      s_end,      s_end,      s_modifier, s_end,      s_modifier, s_modifier },
+
+    // s_killed
+    { s_end,      s_modifier, s_end,      s_end,      s_end,      s_end,
+      s_end,      s_end,      s_modifier, s_end,      s_end,      s_end }
+  };
+
+  inline unsigned
+  syllable_class(const database &db, codepoint cp)
+  {
+    // Nothing in ASCII is Indic, or a mark
+    if (cp < 0x80)
+      return c_other;
+
+    unsigned insc = unsigned(db.indic_syllabic_category(cp));
+
+    if (insc >= sizeof(insc_classes))
+      return c_other;
+
+    unsigned c = insc_classes[insc];
+
+    if (c == c_other) {
+      GCB gcb = db.grapheme_cluster_break(cp);
+
+      if (gcb == GCB::EX || gcb == GCB::SM || gcb == GCB::ZWJ)
+        return c_mark;
+    }
+
+    return c;
+  }
+
+  template <class Codec>
+  size_t
+  next_syllable_boundary(const database &db, const text &txt, size_t pos)
+  {
+    typedef typename Codec::code_unit code_unit;
+
+    const code_unit *begin = text_begin<Codec>(txt);
+    const code_unit *end = text_end<Codec>(txt);
+    const code_unit *ptr = begin + pos;
+    const code_unit *next = ptr;
+    codepoint cp = Codec::decode(next, end);
+    unsigned state = transitions[s_start][syllable_class(db, cp)];
+
+    // Anything that doesn't start a syllable is a grapheme cluster
+    if (state == s_end) {
+      grapheme_iterator graphemes(db, txt);
+      graphemes.reset(pos);
+      return graphemes.next();
+    }
+
+    ptr = next;
+
+    while (ptr < end) {
+      next = ptr;
+      cp = Codec::decode(next, end);
+      state = transitions[state][syllable_class(db, cp)];
+
+      if (state == s_end)
+        break;
+
+      ptr = next;
+    }
+
+    return ptr - begin;
+  }
+
+}
+
+size_t
+syllable_iterator::next()
+{
+  if (_pos >= _text.length())
+    return npos;
+
+  UCD_TEXT_DISPATCH(_text, _pos = next_syllable_boundary,
+                    (_db, _text, _pos));
+
+  return _pos;
+}
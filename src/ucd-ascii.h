@@ -0,0 +1,482 @@
+/*
+ * ucd-ascii.h - Fast paths for runs of ASCII text
+ * libucd
+ *
+ * Copyright (c) 2015 Alastair Houghton
+ *
+ */
+
+#ifndef UCD_ASCII_H_
+#define UCD_ASCII_H_
+
+#include <cstddef>
+#include <cstring>
+#include <inttypes.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/* Most text is mostly ASCII, and none of the interesting properties vary
+   much within it, so the string-level APIs skip over it a block at a time.
+   We use SSE2 where we have it, and otherwise fall back to processing eight
+   bytes at a time in a uint64_t. */
+
+static const uint64_t ascii_ones = 0x0101010101010101ull;
+static const uint64_t ascii_high_bits = 0x8080808080808080ull;
+
+static inline uint64_t
+ascii_load64(const char *ptr)
+{
+  uint64_t w;
+  memcpy(&w, ptr, sizeof(w));
+  return w;
+}
+
+static inline void
+ascii_store64(char *ptr, uint64_t w)
+{
+  memcpy(ptr, &w, sizeof(w));
+}
+
+/* Returns the number of code units at the start of the buffer that are
+   ASCII */
+static inline size_t
+ascii_span(const char *ptr, size_t len)
+{
+  size_t n = 0;
+
+#ifdef __SSE2__
+  while (len - n >= 16) {
+    __m128i v = _mm_loadu_si128((const __m128i *)(ptr + n));
+    if (_mm_movemask_epi8(v))
+      break;
+    n += 16;
+  }
+#endif
+
+  while (len - n >= 8) {
+    if (ascii_load64(ptr + n) & ascii_high_bits)
+      break;
+    n += 8;
+  }
+
+  while (n < len && !(ptr[n] & 0x80))
+    ++n;
+
+  return n;
+}
+
+static inline size_t
+ascii_span(const char16_t *ptr, size_t len)
+{
+  size_t n = 0;
+  while (n < len && ptr[n] < 0x80)
+    ++n;
+  return n;
+}
+
+static inline size_t
+ascii_span(const char32_t *ptr, size_t len)
+{
+  size_t n = 0;
+  while (n < len && ptr[n] < 0x80)
+    ++n;
+  return n;
+}
+
+/* Returns the number of code units at the start of the buffer that are
+   printable ASCII (i.e. ' ' to '~'), each of which takes up one column on
+   a terminal */
+static inline size_t
+ascii_printable_span(const char *ptr, size_t len)
+{
+  size_t n = 0;
+
+#ifdef __SSE2__
+  const __m128i space = _mm_set1_epi8(' ');
+  const __m128i del = _mm_set1_epi8(0x7f);
+
+  // Bytes with the top bit set are negative, so are also less than ' '
+  while (len - n >= 16) {
+    __m128i v = _mm_loadu_si128((const __m128i *)(ptr + n));
+    __m128i bad = _mm_or_si128(_mm_cmplt_epi8(v, space),
+                               _mm_cmpeq_epi8(v, del));
+    if (_mm_movemask_epi8(bad))
+      break;
+    n += 16;
+  }
+#endif
+
+  /* Adding (0x80 - ' ') sets the top bit of each byte that is >= ' ';
+     adding one sets it for DEL.  As above, neither can carry. */
+  while (len - n >= 8) {
+    uint64_t w = ascii_load64(ptr + n);
+    if (w & ascii_high_bits)
+      break;
+    uint64_t ge_space = w + (0x80 - ' ') * ascii_ones;
+    uint64_t is_del = w + ascii_ones;
+    if ((ge_space & ~is_del & ascii_high_bits) != ascii_high_bits)
+      break;
+    n += 8;
+  }
+
+  while (n < len && ptr[n] >= ' ' && ptr[n] < 0x7f)
+    ++n;
+
+  return n;
+}
+
+template <class T>
+static inline size_t
+ascii_printable_span(const T *ptr, size_t len)
+{
+  size_t n = 0;
+  while (n < len && ptr[n] >= ' ' && ptr[n] < 0x7f)
+    ++n;
+  return n;
+}
+
+/* Returns the number of code units at the start of the buffer that are
+   ASCII digits */
+static inline size_t
+ascii_digit_span(const char *ptr, size_t len)
+{
+  size_t n = 0;
+
+#ifdef __SSE2__
+  const __m128i zero = _mm_set1_epi8('0');
+  const __m128i nine = _mm_set1_epi8(9);
+
+  // After subtracting '0', a byte is a digit if it is (unsigned) <= 9
+  while (len - n >= 16) {
+    __m128i v = _mm_sub_epi8(_mm_loadu_si128((const __m128i *)(ptr + n)),
+                             zero);
+    __m128i digit = _mm_cmpeq_epi8(_mm_min_epu8(v, nine), v);
+    if (_mm_movemask_epi8(digit) != 0xffff)
+      break;
+    n += 16;
+  }
+#endif
+
+  /* Adding (0x80 - '0') sets the top bit of each byte that is >= '0';
+     adding (0x7f - '9') sets it for each byte that is > '9'. */
+  while (len - n >= 8) {
+    uint64_t w = ascii_load64(ptr + n);
+    if (w & ascii_high_bits)
+      break;
+    uint64_t ge_0 = w + (0x80 - '0') * ascii_ones;
+    uint64_t gt_9 = w + (0x7f - '9') * ascii_ones;
+    if ((ge_0 & ~gt_9 & ascii_high_bits) != ascii_high_bits)
+      break;
+    n += 8;
+  }
+
+  while (n < len && ptr[n] >= '0' && ptr[n] <= '9')
+    ++n;
+
+  return n;
+}
+
+template <class T>
+static inline size_t
+ascii_digit_span(const T *ptr, size_t len)
+{
+  size_t n = 0;
+  while (n < len && ptr[n] >= '0' && ptr[n] <= '9')
+    ++n;
+  return n;
+}
+
+/* Returns the number of code units at the start of the buffer that are
+   ASCII letters, digits or '_', i.e. that may continue an identifier */
+static inline size_t
+ascii_word_span(const char *ptr, size_t len)
+{
+  size_t n = 0;
+
+#ifdef __SSE2__
+  const __m128i before_a = _mm_set1_epi8('a' - 1);
+  const __m128i after_z = _mm_set1_epi8('z' + 1);
+  const __m128i before_0 = _mm_set1_epi8('0' - 1);
+  const __m128i after_9 = _mm_set1_epi8('9' + 1);
+  const __m128i underscore = _mm_set1_epi8('_');
+  const __m128i bit5 = _mm_set1_epi8(0x20);
+
+  /* Setting bit 5 lowercases letters without making anything else into
+     one; bytes with the top bit set are negative, so never match. */
+  while (len - n >= 16) {
+    __m128i v = _mm_loadu_si128((const __m128i *)(ptr + n));
+    __m128i lv = _mm_or_si128(v, bit5);
+    __m128i letter = _mm_and_si128(_mm_cmpgt_epi8(lv, before_a),
+                                   _mm_cmplt_epi8(lv, after_z));
+    __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(v, before_0),
+                                  _mm_cmplt_epi8(v, after_9));
+    __m128i word = _mm_or_si128(_mm_or_si128(letter, digit),
+                                _mm_cmpeq_epi8(v, underscore));
+    if (_mm_movemask_epi8(word) != 0xffff)
+      break;
+    n += 16;
+  }
+#endif
+
+  /* As elsewhere, adding (0x80 - x) sets the top bit of each byte that is
+     >= x, and adding (0x7f - x) sets it for each byte that is > x; a byte
+     is '_' if XORing it with '_' leaves zero, which adding 0x7f leaves
+     without its top bit. */
+  while (len - n >= 8) {
+    uint64_t w = ascii_load64(ptr + n);
+    if (w & ascii_high_bits)
+      break;
+    uint64_t lw = w | (0x20 * ascii_ones);
+    uint64_t letter = (lw + (0x80 - 'a') * ascii_ones)
+      & ~(lw + (0x7f - 'z') * ascii_ones);
+    uint64_t digit = (w + (0x80 - '0') * ascii_ones)
+      & ~(w + (0x7f - '9') * ascii_ones);
+    uint64_t underscore = ~((w ^ ('_' * ascii_ones)) + 0x7f * ascii_ones);
+    if (((letter | digit | underscore) & ascii_high_bits) != ascii_high_bits)
+      break;
+    n += 8;
+  }
+
+  while (n < len && ((ptr[n] >= 'a' && ptr[n] <= 'z')
+                     || (ptr[n] >= 'A' && ptr[n] <= 'Z')
+                     || (ptr[n] >= '0' && ptr[n] <= '9')
+                     || ptr[n] == '_'))
+    ++n;
+
+  return n;
+}
+
+template <class T>
+static inline size_t
+ascii_word_span(const T *ptr, size_t len)
+{
+  size_t n = 0;
+  while (n < len && ((ptr[n] >= 'a' && ptr[n] <= 'z')
+                     || (ptr[n] >= 'A' && ptr[n] <= 'Z')
+                     || (ptr[n] >= '0' && ptr[n] <= '9')
+                     || ptr[n] == '_'))
+    ++n;
+  return n;
+}
+
+#ifdef __SSE2__
+static inline __m128i
+ascii_tolower_epi8(__m128i v)
+{
+  const __m128i before_A = _mm_set1_epi8('A' - 1);
+  const __m128i after_Z = _mm_set1_epi8('Z' + 1);
+  const __m128i bit5 = _mm_set1_epi8(0x20);
+  __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(v, before_A),
+                                _mm_cmplt_epi8(v, after_Z));
+  return _mm_or_si128(v, _mm_and_si128(upper, bit5));
+}
+#endif
+
+/* Adding (0x80 - 'A') sets the top bit of each byte that is >= 'A'; adding
+   (0x7f - 'Z') sets it for each byte that is > 'Z'.  Neither can carry into
+   the next byte, because the input is ASCII. */
+static inline uint64_t
+ascii_tolower64(uint64_t w)
+{
+  uint64_t ge_A = w + (0x80 - 'A') * ascii_ones;
+  uint64_t gt_Z = w + (0x7f - 'Z') * ascii_ones;
+  uint64_t upper = ge_A & ~gt_Z & ascii_high_bits;
+  return w | (upper >> 2);
+}
+
+/* Returns the number of code units at the start of the buffer that are
+   ASCII but not uppercase letters, i.e. that no case mapping, folding or
+   normalisation will change */
+static inline size_t
+ascii_lower_span(const char *ptr, size_t len)
+{
+  size_t n = 0;
+
+#ifdef __SSE2__
+  const __m128i before_A = _mm_set1_epi8('A' - 1);
+  const __m128i after_Z = _mm_set1_epi8('Z' + 1);
+
+  while (len - n >= 16) {
+    __m128i v = _mm_loadu_si128((const __m128i *)(ptr + n));
+    __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(v, before_A),
+                                  _mm_cmplt_epi8(v, after_Z));
+    if (_mm_movemask_epi8(_mm_or_si128(v, upper)))
+      break;
+    n += 16;
+  }
+#endif
+
+  while (len - n >= 8) {
+    uint64_t w = ascii_load64(ptr + n);
+    if (w & ascii_high_bits)
+      break;
+    if (ascii_tolower64(w) != w)
+      break;
+    n += 8;
+  }
+
+  while (n < len && !(ptr[n] & 0x80) && !(ptr[n] >= 'A' && ptr[n] <= 'Z'))
+    ++n;
+
+  return n;
+}
+
+template <class T>
+static inline size_t
+ascii_lower_span(const T *ptr, size_t len)
+{
+  size_t n = 0;
+  while (n < len && ptr[n] < 0x80 && !(ptr[n] >= 'A' && ptr[n] <= 'Z'))
+    ++n;
+  return n;
+}
+
+/* These copy len code units of ASCII from in to out, changing the case of
+   the letters; in and out may be the same buffer. */
+static inline void
+ascii_tolower(const char *in, char *out, size_t len)
+{
+  size_t n = 0;
+
+#ifdef __SSE2__
+  for (; len - n >= 16; n += 16) {
+    __m128i v = _mm_loadu_si128((const __m128i *)(in + n));
+    _mm_storeu_si128((__m128i *)(out + n), ascii_tolower_epi8(v));
+  }
+#endif
+
+  for (; len - n >= 8; n += 8)
+    ascii_store64(out + n, ascii_tolower64(ascii_load64(in + n)));
+
+  for (; n < len; ++n) {
+    char ch = in[n];
+    if (ch >= 'A' && ch <= 'Z')
+      ch += 'a' - 'A';
+    out[n] = ch;
+  }
+}
+
+static inline void
+ascii_toupper(const char *in, char *out, size_t len)
+{
+  size_t n = 0;
+
+#ifdef __SSE2__
+  const __m128i before_a = _mm_set1_epi8('a' - 1);
+  const __m128i after_z = _mm_set1_epi8('z' + 1);
+  const __m128i bit5 = _mm_set1_epi8(0x20);
+
+  for (; len - n >= 16; n += 16) {
+    __m128i v = _mm_loadu_si128((const __m128i *)(in + n));
+    __m128i lower = _mm_and_si128(_mm_cmpgt_epi8(v, before_a),
+                                  _mm_cmplt_epi8(v, after_z));
+    v = _mm_andnot_si128(_mm_and_si128(lower, bit5), v);
+    _mm_storeu_si128((__m128i *)(out + n), v);
+  }
+#endif
+
+  for (; len - n >= 8; n += 8) {
+    uint64_t w = ascii_load64(in + n);
+    uint64_t ge_a = w + (0x80 - 'a') * ascii_ones;
+    uint64_t gt_z = w + (0x7f - 'z') * ascii_ones;
+    uint64_t lower = ge_a & ~gt_z & ascii_high_bits;
+    ascii_store64(out + n, w & ~(lower >> 2));
+  }
+
+  for (; n < len; ++n) {
+    char ch = in[n];
+    if (ch >= 'a' && ch <= 'z')
+      ch -= 'a' - 'A';
+    out[n] = ch;
+  }
+}
+
+template <class T>
+static inline void
+ascii_tolower(const T *in, T *out, size_t len)
+{
+  for (size_t n = 0; n < len; ++n) {
+    T ch = in[n];
+    if (ch >= 'A' && ch <= 'Z')
+      ch += 'a' - 'A';
+    out[n] = ch;
+  }
+}
+
+template <class T>
+static inline void
+ascii_toupper(const T *in, T *out, size_t len)
+{
+  for (size_t n = 0; n < len; ++n) {
+    T ch = in[n];
+    if (ch >= 'a' && ch <= 'z')
+      ch -= 'a' - 'A';
+    out[n] = ch;
+  }
+}
+
+/* Returns the number of code units at the start of a and b that are ASCII
+   and that match once case folded */
+static inline size_t
+ascii_casefold_match(const char *a, const char *b, size_t len)
+{
+  size_t n = 0;
+
+#ifdef __SSE2__
+  for (; len - n >= 16; n += 16) {
+    __m128i va = _mm_loadu_si128((const __m128i *)(a + n));
+    __m128i vb = _mm_loadu_si128((const __m128i *)(b + n));
+    if (_mm_movemask_epi8(_mm_or_si128(va, vb)))
+      break;
+    __m128i eq = _mm_cmpeq_epi8(ascii_tolower_epi8(va),
+                                ascii_tolower_epi8(vb));
+    if (_mm_movemask_epi8(eq) != 0xffff)
+      break;
+  }
+#endif
+
+  for (; len - n >= 8; n += 8) {
+    uint64_t wa = ascii_load64(a + n), wb = ascii_load64(b + n);
+    if ((wa | wb) & ascii_high_bits)
+      break;
+    if (ascii_tolower64(wa) != ascii_tolower64(wb))
+      break;
+  }
+
+  for (; n < len; ++n) {
+    char ca = a[n], cb = b[n];
+    if ((ca | cb) & 0x80)
+      break;
+    if (ca >= 'A' && ca <= 'Z')
+      ca += 'a' - 'A';
+    if (cb >= 'A' && cb <= 'Z')
+      cb += 'a' - 'A';
+    if (ca != cb)
+      break;
+  }
+
+  return n;
+}
+
+template <class T>
+static inline size_t
+ascii_casefold_match(const T *a, const T *b, size_t len)
+{
+  size_t n;
+  for (n = 0; n < len; ++n) {
+    T ca = a[n], cb = b[n];
+    if (ca >= 0x80 || cb >= 0x80)
+      break;
+    if (ca >= 'A' && ca <= 'Z')
+      ca += 'a' - 'A';
+    if (cb >= 'A' && cb <= 'Z')
+      cb += 'a' - 'A';
+    if (ca != cb)
+      break;
+  }
+  return n;
+}
+
+#endif /* UCD_ASCII_H_ */
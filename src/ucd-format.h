@@ -95,6 +95,28 @@ enum {
   UCD_insc = 'insc',    /* Indic Syllabic Category table   */
   UCD_iscn = 'isc$',    /* Indic Syllabic Cat name table   */
   UCD_prmc = 'prmc',    /* Primary Composite table         */
+  UCD_CASt = 'CAS#',    /* Uppercase Mapping trie          */
+  UCD_cast = 'cas#',    /* Lowercase Mapping trie          */
+  UCD_Cast = 'Cas#',    /* Titlecase Mapping trie          */
+  UCD_csft = 'csf#',    /* Case Folding trie               */
+  UCD_cclo = 'cclo',    /* Case Closure table              */
+  UCD_gcbt = 'gcb#',    /* Grapheme Cluster Break trie     */
+  UCD_wbkt = 'wbk#',    /* Word Break trie                 */
+  UCD_sbkt = 'sbk#',    /* Sentence Break trie             */
+  UCD_lbkt = 'lbk#',    /* Line Break trie                 */
+  UCD_widt = 'wid#',    /* Display width trie              */
+  UCD_rtlt = 'rtl#',    /* Bidi pre-scan trie              */
+  UCD_jntt = 'jnt#',    /* Joining Type trie               */
+  UCD_dig0 = 'dig0',    /* Decimal digit zeroes table      */
+  UCD_numt = 'num#',    /* Numeric value trie              */
+  UCD_rsix = 'rsix',    /* Radical-stroke index            */
+  UCD_aget = 'age#',    /* Age trie                        */
+  UCD_emjt = 'emj#',    /* Emoji property trie             */
+  UCD_emsq = 'emsq',    /* Emoji sequence table            */
+  UCD_cnft = 'cnf#',    /* Confusables trie                */
+  UCD_idnt = 'idn#',    /* Identifier property trie        */
+  UCD_hidt = 'hid#',    /* Hidden character trie           */
+  UCD_scst = 'scs#',    /* Script set trie                 */
 };
 
 /* There are a large number of tables ending with a '?' that are not defined
@@ -102,6 +124,14 @@ enum {
 
 /* Tables ending in '$' contain name data for the associated values */
 
+/* Tables ending in '#' are tries (see struct ucd_trie, below) */
+
+/* Most of the newer tables, including all of the tries, only exist to make
+   things faster.  Older database files don't have them, so their getters in
+   database::impl return nullptr, and the code that uses them falls back to
+   the tables it used before; flag_trie (in ucd-trie.h) does this for tries
+   of binary property flags. */
+
 /* .. ...$ .................................................................. */
 
 /* In each case, there are num_fwd + num_rev entries; the first set is sorted by
@@ -405,6 +435,15 @@ struct ucd_numb {
   struct ucd_numb_entry entries[0];
 };
 
+/* .. dig0 .................................................................. */
+
+/* The code points of the zero digits of the runs of ten Numeric_Type=Decimal
+   characters, in order. */
+struct ucd_dig0 {
+  uint32_t num_entries;
+  uint32_t entries[0];
+};
+
 /* .. bidi .................................................................. */
 
 typedef enum {
@@ -548,6 +587,11 @@ struct ucd_age {
 #define UCD_AGE_MAJOR(version) ((version) >> 16)
 #define UCD_AGE_MINOR(version) ((version) & 0xffff)
 
+/* The age trie holds an 8-bit value for each code point, which is zero if
+   it is unassigned and otherwise one more than the index of its Age in the
+   age table's versions[] array.  The versions are sorted, so a larger
+   value means a newer character. */
+
 /* .. scpt .................................................................. */
 
 struct ucd_scpt_ext_entry {
@@ -614,6 +658,11 @@ struct ucd_join {
   struct ucd_join_entry entries[0];
 };
 
+/* .. jnt# .................................................................. */
+
+/* The joining type trie holds a 4-bit ucd_join_type_t for every code point,
+   so that shaping code needn't search the join table. */
+
 /* .. jon$ .................................................................. */
 
 /* The jon$ table contains *two* name tables, the first for join type, and
@@ -662,6 +711,28 @@ struct ucd_rads {
   struct ucd_rads_range ranges[0];
 };
 
+/* .. rsix .................................................................. */
+
+/* The radical-stroke index maps each Unicode_Radical_Stroke value to the
+   code points that have it.  The entries are sorted by radical, simplified
+   flag and residual strokes; each gives the position and length of a run of
+   code points, in code point order, in the array at cps_offset (from the
+   start of the table). */
+struct ucd_rsix_entry {
+  uint8_t  radical;
+  uint8_t  simplified;
+  int8_t   strokes;
+  uint8_t  reserved;
+  uint32_t first;
+  uint32_t count;
+};
+
+struct ucd_rsix {
+  uint32_t              num_entries;
+  uint32_t              cps_offset;
+  struct ucd_rsix_entry entries[0];
+};
+
 /* .. inmc/insc  ............................................................ */
 
 struct ucd_inc {
@@ -685,6 +756,194 @@ struct ucd_prmc {
   struct ucd_prmc_entry entries[0];     // Stored in sorted order
 };
 
+/* .. cclo .................................................................. */
+
+/* Simple case folding divides the code points into equivalence classes; this
+   table lists every code point that belongs to a class with more than one
+   member.  offset is the offset from the start of the table to the class,
+   which is a count followed by the members in ascending order. */
+struct ucd_cclo_entry {
+  uint32_t cp;
+  uint32_t offset;
+};
+
+struct ucd_cclo {
+  uint32_t              num_entries;
+  struct ucd_cclo_entry entries[0];     // Stored in sorted order
+};
+
+/* .. Tries ................................................................. */
+
+/* A trie maps every code point to a small unsigned value in two memory
+   accesses.  The code point is split into a block number (cp >> shift) and
+   an offset within the block; index[] gives the number of the block of
+   values that holds the data for each block number (identical blocks are
+   stored only once).
+
+   Values are value_bits wide (1, 2, 4, 8, 16 or 32); values narrower than
+   a byte are packed starting from the least significant bit. */
+struct ucd_trie {
+  uint8_t  value_bits;
+  uint8_t  shift;
+  uint16_t reserved;
+  uint32_t default_value;       // Value for code points above U+10FFFF
+  uint32_t data_offset;         // Offset of the data relative to ucd_trie
+  uint16_t index[0];            // (0x110000 >> shift) entries
+};
+
+/* .. CAS#/cas#/Cas#/csf# ................................................... */
+
+/* The case mapping tries hold a 16-bit value for each code point.  If the
+   bottom bit is clear, the value (as a signed 16-bit integer) is twice the
+   delta to add to the code point to get its mapping.  If it is set, the
+   rest of the value is the index of an exception, for mappings that aren't
+   a single code point within reach of a delta.
+
+   exceptions_offset is the offset from the start of the table to an array
+   of num_exceptions offsets, again from the start of the table, each of
+   which points at an exception.  An exception starts with a word holding
+   the length of the full mapping, plus UCD_CASE_EXCEPTION_HAS_SIMPLE if the
+   next word is the simple mapping; the full mapping follows that.  If there
+   is no explicit simple mapping, the full mapping is also the simple one if
+   it is a single code point, otherwise the simple mapping is the identity. */
+struct ucd_case_trie {
+  uint32_t        num_exceptions;
+  uint32_t        exceptions_offset;
+  struct ucd_trie trie;
+};
+
+#define UCD_CASE_TRIE_IS_DELTA(value)   (!((value) & 1))
+#define UCD_CASE_TRIE_DELTA(value)      ((int32_t)(int16_t)(value) / 2)
+#define UCD_CASE_TRIE_EXCEPTION(value)  ((value) >> 1)
+
+#define UCD_CASE_EXCEPTION_LENGTH(word) ((word) & 0xff)
+#define UCD_CASE_EXCEPTION_HAS_SIMPLE   0x100
+
+/* .. wid# .................................................................. */
+
+/* The display width trie holds a 2-bit value for each code point, derived
+   from East_Asian_Width, General_Category, Default_Ignorable_Code_Point and
+   Emoji_Presentation. */
+enum {
+  UCD_WIDTH_ZERO      = 0,
+  UCD_WIDTH_NARROW    = 1,
+  UCD_WIDTH_WIDE      = 2,
+  UCD_WIDTH_AMBIGUOUS = 3       // Wide in East Asian contexts, else narrow
+};
+
+/* .. rtl# .................................................................. */
+
+/* The bidi pre-scan trie holds a 1-bit value for each code point, which is
+   set for Bidi_Class R, AL and AN, and for the explicit embedding, override
+   and isolate controls.  None of these are below U+0590. */
+
+/* .. num# .................................................................. */
+
+/* The numeric value trie holds a 16-bit value for each code point, which is
+   zero if it has no numeric value, and otherwise one more than the index of
+   its value in the array at values_offset (from the start of the table).
+   Each value is given both as a double and as a fraction in lowest terms,
+   with a positive denominator. */
+struct ucd_numeric_value {
+  double  value;
+  int64_t numerator;
+  int64_t denominator;
+};
+
+struct ucd_numeric_trie {
+  uint32_t        num_values;
+  uint32_t        values_offset;
+  struct ucd_trie trie;
+};
+
+/* .. emj# .................................................................. */
+
+/* The emoji trie holds a 4-bit value for each code point, made up of the
+   flags below. */
+enum {
+  UCD_EMOJI               = 0x01,
+  UCD_EMOJI_PRESENTATION  = 0x02,
+  UCD_EMOJI_MODIFIER      = 0x04,
+  UCD_EMOJI_MODIFIER_BASE = 0x08
+};
+
+/* .. emsq .................................................................. */
+
+/* The emoji sequences from emoji-sequences.txt and emoji-zwj-sequences.txt,
+   as a trie of code points.  Node 0 is the root; each node has the type of
+   the sequence that ends there (an emoji_sequence, or zero if none does),
+   and a run of num_edges edges starting at first_edge in the array at
+   edges_offset (from the start of the table), sorted by code point. */
+struct ucd_emsq_node {
+  uint32_t first_edge;
+  uint16_t num_edges;
+  uint8_t  type;
+  uint8_t  reserved;
+};
+
+struct ucd_emsq_edge {
+  uint32_t cp;
+  uint32_t node;
+};
+
+struct ucd_emsq {
+  uint32_t             num_nodes;
+  uint32_t             edges_offset;
+  struct ucd_emsq_node nodes[0];
+};
+
+/* .. cnf# .................................................................. */
+
+/* The confusables trie holds a 16-bit value for each code point, which is
+   zero if it is its own prototype in confusables.txt, and otherwise one
+   more than an index into the array of offsets at offsets_offset (from the
+   start of the table).  Each offset (also from the start of the table)
+   points at a 32-bit length followed by the code points of the prototype. */
+struct ucd_confusables {
+  uint32_t        num_prototypes;
+  uint32_t        offsets_offset;
+  struct ucd_trie trie;
+};
+
+/* .. idn# .................................................................. */
+
+/* The identifier trie holds an 8-bit value for each code point, made up of
+   the flags below. */
+enum {
+  UCD_IDENT_ID_START            = 0x01,
+  UCD_IDENT_ID_CONTINUE         = 0x02,
+  UCD_IDENT_XID_START           = 0x04,
+  UCD_IDENT_XID_CONTINUE        = 0x08,
+  UCD_IDENT_PATTERN_SYNTAX      = 0x10,
+  UCD_IDENT_PATTERN_WHITE_SPACE = 0x20
+};
+
+/* .. hid# .................................................................. */
+
+/* The hidden character trie holds an 8-bit value for each code point, made
+   up of the flags below, which match the values of Hidden_Property. */
+enum {
+  UCD_HIDDEN_BIDI_CONTROL       = 0x01,
+  UCD_HIDDEN_DEFAULT_IGNORABLE  = 0x02,
+  UCD_HIDDEN_JOIN_CONTROL       = 0x04,
+  UCD_HIDDEN_VARIATION_SELECTOR = 0x08,
+  UCD_HIDDEN_NONCHARACTER       = 0x10,
+  UCD_HIDDEN_UNASSIGNED         = 0x20
+};
+
+/* .. scs# .................................................................. */
+
+/* The script set trie holds a 16-bit value for each code point, which is
+   the index of its Script_Extensions (or, if it has none, its Script) in
+   the list of the distinct sets of scripts at sets_offset (from the start
+   of the table).  Each set is a 32-bit count followed by that many scripts,
+   and set zero is Zzzz, for unassigned code points. */
+struct ucd_script_sets {
+  uint32_t        num_sets;
+  uint32_t        sets_offset;
+  struct ucd_trie trie;
+};
+
 #pragma pack(pop)
 
 #endif /* UCD_FORMAT_H_ */
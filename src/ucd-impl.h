@@ -0,0 +1,193 @@
+/*
+ * ucd-impl.h - The internals of ucd::database, shared between the source
+ *              files that implement it.
+ * libucd
+ *
+ * Copyright (c) 2015 Alastair Houghton
+ *
+ */
+
+#ifndef UCD_IMPL_H_
+#define UCD_IMPL_H_
+
+#include <sys/types.h>
+
+#include <string>
+#include <vector>
+
+#include <libucd/libucd.h>
+#include "ucd-format.h"
+
+namespace ucd {
+
+struct database::impl {
+  int                       fd;
+  off_t                     len;
+  bool                      mapped;
+
+  const struct ucd_header  *pheader;
+  const struct ucd_strings *pstrings;
+  const struct ucd_names   *pnames;
+  const struct ucd_u1nm    *pu1nm;
+  const struct ucd_isoc    *pisoc;
+  const struct ucd_alis    *palis;
+  const struct ucd_jamo    *pjamo;
+  const struct ucd_genc    *pgenc;
+  const struct ucd_numb    *pnumb;
+  const struct ucd_dig0    *pdig0;
+  const struct ucd_numeric_trie *pnumt;
+  const struct ucd_ccc     *pccc;
+  const struct ucd_case    *pCASE, *pcase, *pCase, *pcsef, *pkccf, *pnfkc;
+  const struct ucd_bidi    *pbidi;
+  const struct ucd_deco    *pdeco;
+  const struct ucd_mirr    *pmirr;
+  const struct ucd_brak    *pbrak;
+  const struct ucd_age     *page;
+  const struct ucd_scpt    *pscpt;
+  const struct ucd_qc      *pnfcqc, *pnfkcqc, *pnfdqc, *pnfkdqc;
+  const struct ucd_join    *pjoin;
+  const struct ucd_brk     *plbrk, *pgbrk, *psbrk, *pwbrk;
+  const struct ucd_eaw     *peaw;
+  const struct ucd_rads    *prads;
+  const struct ucd_rsix    *prsix;
+  const struct ucd_inc     *pinmc, *pinsc;
+  const struct ucd_prmc    *pprmc;
+  const struct ucd_cclo    *pcclo;
+  const struct ucd_case_trie *pCASt, *pcast, *pCast, *pcsft;
+  const struct ucd_trie    *pgcbt, *pwbkt, *psbkt, *plbkt;
+  const struct ucd_trie    *pwidt;
+  const struct ucd_trie    *prtlt;
+  const struct ucd_trie    *pjntt;
+  const struct ucd_trie    *paget;
+  const struct ucd_trie    *pemjt;
+  const struct ucd_emsq    *pemsq;
+  const struct ucd_confusables *pcnft;
+  const struct ucd_trie    *pidnt;
+  const struct ucd_trie    *phidt;
+  const struct ucd_script_sets *pscst;
+
+  const struct ucd_n32     *pscpn;
+  const struct ucd_n16     *pjamn;
+  const struct ucd_n16     *pgcn;
+  const struct ucd_n8      *pcccn;
+  const struct ucd_n8      *pnumn;
+  const struct ucd_n8      *pbdin;
+  const struct ucd_n8      *pdecn;
+  const struct ucd_n8      *pjtn, *pjgn;
+  const struct ucd_n8      *plbkn, *pgbkn, *psbkn, *pwbkn;
+  const struct ucd_n8      *peawn;
+  const struct ucd_n8      *pimcn, *piscn;
+
+#define BINPROP(n,m,t) const struct ucd_binprop *pbinprop_ ## m;
+#include "ucd-binprops.h"
+
+  std::vector<class block> blocks;
+  std::vector<script_set>  script_sets;
+
+  ~impl();
+
+  const void *get_table(uint32_t table_id) const;
+  const char *get_strptr_unsafe(ucd_string_id_t sid, size_t &max_len);
+  const char *get_strptr(ucd_string_id_t sid, size_t &len);
+  std::string get_string(ucd_string_id_t sid);
+  const struct ucd_names *get_names();
+  const struct ucd_u1nm *get_u1nm();
+  const struct ucd_isoc *get_isoc();
+  const struct ucd_alis *get_alis();
+  const struct ucd_jamo *get_jamo();
+  const struct ucd_genc *get_genc();
+  const struct ucd_numb *get_numb();
+  const struct ucd_dig0 *get_dig0();
+  const struct ucd_numeric_trie *get_numt();
+  const struct ucd_ccc  *get_ccc();
+  const struct ucd_case *get_CASE();
+  const struct ucd_case  *get_case();
+  const struct ucd_case  *get_Case();
+  const struct ucd_case *get_csef();
+  const struct ucd_case *get_kccf();
+  const struct ucd_case *get_nfkc();
+  const struct ucd_bidi *get_bidi();
+  const struct ucd_deco *get_deco();
+  const struct ucd_mirr *get_mirr();
+  const struct ucd_brak *get_brak();
+  const struct ucd_age *get_age();
+  const struct ucd_scpt *get_scpt();
+  const struct ucd_qc *get_nfcqc();
+  const struct ucd_qc *get_nfkcqc();
+  const struct ucd_qc *get_nfdqc();
+  const struct ucd_qc *get_nfkdqc();
+  const struct ucd_join *get_join();
+  const struct ucd_brk *get_lbrk();
+  const struct ucd_brk *get_gbrk();
+  const struct ucd_brk *get_sbrk();
+  const struct ucd_brk *get_wbrk();
+  const struct ucd_eaw *get_eaw();
+  const struct ucd_rads *get_rads();
+  const struct ucd_rsix *get_rsix();
+  const struct ucd_inc *get_inmc();
+  const struct ucd_inc *get_insc();
+  const struct ucd_prmc *get_prmc();
+  const struct ucd_cclo *get_cclo();
+  const struct ucd_case_trie *get_CASt();
+  const struct ucd_case_trie *get_cast();
+  const struct ucd_case_trie *get_Cast();
+  const struct ucd_case_trie *get_csft();
+  const struct ucd_trie *get_gcbt();
+  const struct ucd_trie *get_wbkt();
+  const struct ucd_trie *get_sbkt();
+  const struct ucd_trie *get_lbkt();
+  const struct ucd_trie *get_widt();
+  const struct ucd_trie *get_rtlt();
+  const struct ucd_trie *get_jntt();
+  const struct ucd_trie *get_aget();
+  const struct ucd_trie *get_emjt();
+  const struct ucd_emsq *get_emsq();
+  const struct ucd_confusables *get_cnft();
+  const struct ucd_trie *get_idnt();
+  const struct ucd_trie *get_hidt();
+  const struct ucd_script_sets *get_scst();
+
+  const struct ucd_n16 *get_jamn();
+  const struct ucd_n16 *get_gcn();
+  const struct ucd_n8  *get_cccn();
+  const struct ucd_n8  *get_numn();
+  const struct ucd_n8  *get_bdin();
+  const struct ucd_n8  *get_decn();
+  const struct ucd_n8  *get_jtn();
+  const struct ucd_n8  *get_jgn();
+  const struct ucd_n8  *get_lbkn();
+  const struct ucd_n8  *get_gbkn();
+  const struct ucd_n8  *get_sbkn();
+  const struct ucd_n8  *get_wbkn();
+  const struct ucd_n8  *get_eawn();
+  const struct ucd_n8  *get_imcn();
+  const struct ucd_n8  *get_iscn();
+  const struct ucd_n32 *get_scpn();
+
+#undef BINPROP
+#define BINPROP(n,m,t)                                           \
+  const struct ucd_binprop *get_binprop_##m() {                  \
+    if (!pbinprop_ ## m)                                         \
+      pbinprop_ ## m = (const struct ucd_binprop *)get_table(t); \
+    return pbinprop_ ## m;                                       \
+  }
+#include "ucd-binprops.h"
+
+  void init_blocks();
+  void init_script_sets();
+
+  std::string strip(const std::string &s);
+
+  template <class table, class valtype>
+  bool search(const table *ptbl, valtype value, std::string &str);
+  template <class table, class valtype>
+  bool search(const table *ptbl, const std::string &str, valtype &result);
+};
+
+// The first and last code points covered by a range in a case table
+void get_case_range_bounds(const struct ucd_case_range &range,
+                           codepoint &ecp, codepoint &lcp);
+
+}
+
+#endif /* UCD_IMPL_H_ */
@@ -0,0 +1,180 @@
+/*
+ * ucd-normalize.h - Streaming canonical decomposition and composition
+ * libucd
+ *
+ * Copyright (c) 2015 Alastair Houghton
+ *
+ */
+
+#ifndef UCD_NORMALIZE_H_
+#define UCD_NORMALIZE_H_
+
+#include <vector>
+
+#include <libucd/libucd.h>
+
+namespace ucd {
+
+  // No canonical decomposition is longer than four code points
+  enum {
+    max_canonical_decomposition = 4
+  };
+
+  /* Recursively apply the canonical decomposition mappings to cp, passing
+     the results to sink.put(). */
+  template <class Sink>
+  void
+  canonical_decompose(const database &db, codepoint cp, Sink &sink)
+  {
+    if (cp < 0xc0 || db.nfd_quick_check(cp) == maybe::yes) {
+      sink.put(cp);
+      return;
+    }
+
+    codepoint mapped[max_canonical_decomposition];
+    dt dtype;
+    size_t count = db.decomposition_mapping(cp, mapped,
+                                            max_canonical_decomposition,
+                                            dtype);
+
+    if (dtype != Decomposition_Type::Canonical) {
+      sink.put(cp);
+      return;
+    }
+
+    for (size_t n = 0; n < count && n < max_canonical_decomposition; ++n)
+      canonical_decompose(db, mapped[n], sink);
+  }
+
+  /* Accepts fully decomposed code points, puts them into canonical order
+     and, optionally, recomposes them, passing the results to sink.put().
+     Code points are held until we see the next starter; text in
+     Stream-Safe Text Format never needs more than the inline buffer, but
+     we'll cope with longer sequences of non-starters if we have to. */
+  template <class Sink>
+  class canonical_orderer {
+  private:
+    struct entry {
+      codepoint cp;
+      ccc       cclass;
+    };
+
+    enum {
+      inline_size = 32
+    };
+
+    const database     &_db;
+    Sink               &_sink;
+    bool                _compose;
+    entry               _inline[inline_size];
+    std::vector<entry>  _overflow;
+    entry              *_segment;
+    size_t              _count;
+
+  public:
+    canonical_orderer(const database &db, Sink &sink, bool compose)
+      : _db(db), _sink(sink), _compose(compose),
+        _segment(_inline), _count(0) {}
+
+    canonical_orderer(const canonical_orderer &) = delete;
+    canonical_orderer &operator=(const canonical_orderer &) = delete;
+
+    void put(codepoint cp) {
+      ccc cclass = cp < 0x300 ? 0 : _db.canonical_combining_class(cp);
+
+      if (cclass == 0) {
+        // A starter can only compose with a starter immediately before it
+        if (_compose && compose_segment() && _count == 1) {
+          codepoint composite = _db.primary_composite(_segment[0].cp, cp);
+          if (composite) {
+            _segment[0].cp = composite;
+            return;
+          }
+        }
+
+        emit();
+        append(cp, cclass);
+        return;
+      }
+
+      // Insert the non-starter after anything with the same or lower class
+      append(cp, cclass);
+      size_t n = _count - 1;
+      while (n > 0 && _segment[n - 1].cclass > cclass) {
+        _segment[n] = _segment[n - 1];
+        --n;
+      }
+      _segment[n].cp = cp;
+      _segment[n].cclass = cclass;
+    }
+
+    // Emit anything we're holding on to
+    void flush() {
+      if (_compose)
+        compose_segment();
+      emit();
+    }
+
+  private:
+    void emit() {
+      for (size_t n = 0; n < _count; ++n)
+        _sink.put(_segment[n].cp);
+
+      _count = 0;
+      if (_segment != _inline) {
+        _overflow.clear();
+        _segment = _inline;
+      }
+    }
+
+    void append(codepoint cp, ccc cclass) {
+      if (_segment == _inline && _count == inline_size) {
+        _overflow.assign(_inline, _inline + _count);
+        _overflow.reserve(2 * inline_size);
+      }
+
+      if (_segment != _inline || _count == inline_size) {
+        _overflow.push_back(entry { cp, cclass });
+        _segment = _overflow.data();
+      } else {
+        _segment[_count] = entry { cp, cclass };
+      }
+
+      ++_count;
+    }
+
+    /* Compose the non-starters in the segment with its initial starter, if
+       it has one; returns true if the segment starts with a starter. */
+    bool compose_segment() {
+      if (!_count || _segment[0].cclass != 0)
+        return false;
+
+      size_t kept = 1;
+      ccc last_class = 0;
+
+      for (size_t n = 1; n < _count; ++n) {
+        const entry &e = _segment[n];
+
+        // Blocked if something we kept has the same or a higher class
+        if (kept == 1 || last_class < e.cclass) {
+          codepoint composite = _db.primary_composite(_segment[0].cp, e.cp);
+          if (composite) {
+            _segment[0].cp = composite;
+            continue;
+          }
+        }
+
+        last_class = e.cclass;
+        _segment[kept++] = e;
+      }
+
+      if (_segment != _inline)
+        _overflow.resize(kept);
+      _count = kept;
+      return true;
+    }
+  };
+
+}
+
+#endif /* UCD_NORMALIZE_H_ */
@@ -0,0 +1,72 @@
+/*
+ * ucd-output.h - Output buffers for the string-level APIs
+ * libucd
+ *
+ * Copyright (c) 2015 Alastair Houghton
+ *
+ */
+
+#ifndef UCD_OUTPUT_H_
+#define UCD_OUTPUT_H_
+
+#include <cstddef>
+
+#include <libucd/utf.h>
+
+namespace ucd {
+
+  /* Writes encoded code points to a caller supplied buffer, keeping track
+     of the total length of the output so that the caller can find out how
+     much space it needs.  Once something doesn't fit, nothing more is
+     written, so the buffer always holds a prefix of the result. */
+  template <class Codec>
+  class output_buffer {
+  public:
+    typedef typename Codec::code_unit code_unit;
+
+  private:
+    code_unit *_ptr;
+    code_unit *_end;
+    size_t     _length;
+
+  public:
+    output_buffer(code_unit *out, size_t out_len)
+      : _ptr(out), _end(out ? out + out_len : nullptr), _length(0) {}
+
+    size_t length() const { return _length; }
+
+    void put(codepoint cp) {
+      unsigned len = Codec::length(cp);
+      if (_ptr) {
+        if (size_t(_end - _ptr) >= len)
+          _ptr += Codec::encode(cp, _ptr);
+        else
+          _ptr = nullptr;
+      }
+      _length += len;
+    }
+
+    void put(const codepoint *cps, size_t count) {
+      for (size_t n = 0; n < count; ++n)
+        put(cps[n]);
+    }
+
+    /* Returns a pointer to space for len code units, or nullptr if there
+       isn't room for them; either way, the length is updated. */
+    code_unit *reserve(size_t len) {
+      code_unit *result = nullptr;
+      if (_ptr) {
+        if (size_t(_end - _ptr) >= len) {
+          result = _ptr;
+          _ptr += len;
+        } else
+          _ptr = nullptr;
+      }
+      _length += len;
+      return result;
+    }
+  };
+
+}
+
+#endif /* UCD_OUTPUT_H_ */
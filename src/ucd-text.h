@@ -0,0 +1,175 @@
+/*
+ * ucd-text.h - Helpers for working with ucd::text
+ * libucd
+ *
+ * Copyright (c) 2015 Alastair Houghton
+ *
+ */
+
+#ifndef UCD_TEXT_H_
+#define UCD_TEXT_H_
+
+#include <cstddef>
+#include <cinttypes>
+#include <algorithm>
+
+#include <libucd/text.h>
+#include <libucd/utf.h>
+#include <libucd/segmentation.h>
+
+namespace ucd {
+
+  template <class Codec>
+  inline const typename Codec::code_unit *
+  text_begin(const text &txt)
+  {
+    return static_cast<const typename Codec::code_unit *>(txt.data());
+  }
+
+  template <class Codec>
+  inline const typename Codec::code_unit *
+  text_end(const text &txt)
+  {
+    return text_begin<Codec>(txt) + txt.length();
+  }
+
+  // The value of a code unit, without any sign extension
+  inline uint32_t unit_value(char cu) { return (uint8_t)cu; }
+  inline uint32_t unit_value(char16_t cu) { return cu; }
+  inline uint32_t unit_value(char32_t cu) { return cu; }
+
+  /* True if the code point starting at ptr might continue past end, which
+     matters when the text is arriving in chunks. */
+  inline bool
+  is_truncated(const char *ptr, const char *end)
+  {
+    uint8_t b0 = (uint8_t)*ptr;
+    ptrdiff_t need;
+
+    if (b0 >= 0xc2 && b0 <= 0xdf)
+      need = 2;
+    else if (b0 >= 0xe0 && b0 <= 0xef)
+      need = 3;
+    else if (b0 >= 0xf0 && b0 <= 0xf4)
+      need = 4;
+    else
+      return false;
+
+    return end - ptr < need;
+  }
+
+  inline bool
+  is_truncated(const char16_t *ptr, const char16_t *end)
+  {
+    return *ptr >= 0xd800 && *ptr <= 0xdbff && end - ptr < 2;
+  }
+
+  inline bool
+  is_truncated(const char32_t *, const char32_t *)
+  {
+    return false;
+  }
+
+  /* Reads the next code point from chunked text, returning false if we've
+     reached the end of the current chunk.  If the chunk ends part way
+     through a code point (and isn't the final chunk), the code units we
+     have are kept in the carry buffer for next time. */
+  template <class Codec>
+  inline bool
+  read_codepoint(chunked_text &in, codepoint &cp, size_t &begin, size_t &end)
+  {
+    typedef typename Codec::code_unit code_unit;
+
+    const code_unit *first = text_begin<Codec>(in.chunk);
+    const code_unit *last = text_end<Codec>(in.chunk);
+    const code_unit *ptr = first + in.pos;
+
+    if (in.carry_len) {
+      code_unit buf[2 * Codec::max_length];
+      size_t avail = std::min(size_t(last - ptr), size_t(Codec::max_length));
+      unsigned len = 0;
+
+      for (unsigned n = 0; n < in.carry_len; ++n)
+        buf[len++] = code_unit(in.carry[n]);
+      for (size_t n = 0; n < avail; ++n)
+        buf[len++] = ptr[n];
+
+      const code_unit *bptr = buf, *bend = buf + len;
+
+      if (!in.final && ptr + avail == last && is_truncated(bptr, bend)) {
+        for (unsigned n = 0; n < len; ++n)
+          in.carry[n] = unit_value(buf[n]);
+        in.carry_len = len;
+        in.pos = in.chunk.length();
+        return false;
+      }
+
+      cp = Codec::decode(bptr, bend);
+
+      unsigned used = unsigned(bptr - buf);
+
+      begin = in.base - in.carry_len;
+      end = begin + used;
+
+      if (used < in.carry_len) {
+        std::copy(in.carry + used, in.carry + in.carry_len, in.carry);
+        in.carry_len -= used;
+      } else {
+        in.pos += used - in.carry_len;
+        in.carry_len = 0;
+      }
+
+      return true;
+    }
+
+    if (ptr == last)
+      return false;
+
+    begin = in.base + in.pos;
+
+    uint32_t unit = unit_value(*ptr);
+    if (unit < 0x80) {
+      cp = unit;
+      end = begin + 1;
+      ++in.pos;
+      return true;
+    }
+
+    if (!in.final && last - ptr < Codec::max_length
+        && is_truncated(ptr, last)) {
+      while (ptr < last)
+        in.carry[in.carry_len++] = unit_value(*ptr++);
+      in.pos = in.chunk.length();
+      return false;
+    }
+
+    cp = Codec::decode(ptr, last);
+    in.pos = ptr - first;
+    end = in.base + in.pos;
+
+    return true;
+  }
+
+}
+
+/* Expands to a call to the version of fn for the encoding of txt, e.g.
+
+     UCD_TEXT_DISPATCH(txt, return find_boundary, (db, txt, pos));
+
+   calls find_boundary<utf8_codec>(db, txt, pos) for UTF-8 text. */
+#define UCD_TEXT_DISPATCH(txt, fn, args)                                \
+  do {                                                                  \
+    switch ((txt).encoding()) {                                         \
+    case ::ucd::text::encoding_form::utf8:                              \
+      fn<::ucd::utf8_codec> args;                                       \
+      break;                                                            \
+    case ::ucd::text::encoding_form::utf16:                             \
+      fn<::ucd::utf16_codec> args;                                      \
+      break;                                                            \
+    case ::ucd::text::encoding_form::utf32:                             \
+      fn<::ucd::utf32_codec> args;                                      \
+      break;                                                            \
+    }                                                                   \
+  } while (0)
+
+#endif /* UCD_TEXT_H_ */
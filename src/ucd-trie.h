@@ -0,0 +1,143 @@
+/*
+ * ucd-trie.h - Lookups in the tries defined in ucd-format.h
+ * libucd
+ *
+ * Copyright (c) 2015 Alastair Houghton
+ *
+ */
+
+#ifndef UCD_TRIE_H_
+#define UCD_TRIE_H_
+
+#include <libucd/libucd.h>
+#include "ucd-format.h"
+
+static inline uint32_t
+ucd_trie_lookup(const struct ucd_trie *ptrie, uint32_t cp)
+{
+  if (cp > 0x10ffff)
+    return ptrie->default_value;
+
+  uint32_t shift = ptrie->shift;
+  uint32_t ndx = ((uint32_t)ptrie->index[cp >> shift] << shift)
+    | (cp & ((1u << shift) - 1));
+  const uint8_t *data = (const uint8_t *)ptrie + ptrie->data_offset;
+
+  switch (ptrie->value_bits) {
+  case 8:
+    return data[ndx];
+  case 16:
+    return ((const uint16_t *)data)[ndx];
+  case 32:
+    return ((const uint32_t *)data)[ndx];
+  default:
+    {
+      uint32_t bits = ptrie->value_bits;
+      uint32_t bitpos = ndx * bits;
+      return (data[bitpos >> 3] >> (bitpos & 7)) & ((1u << bits) - 1);
+    }
+  }
+}
+
+/* Find the case mapping for cp in a case trie; returns the length of the
+   mapping, having written as much of it as will fit into out. */
+static inline size_t
+ucd_case_trie_mapping(const struct ucd_case_trie *pcase, uint32_t cp,
+                      bool simple, char32_t *out, size_t out_len)
+{
+  uint32_t value = ucd_trie_lookup(&pcase->trie, cp);
+
+  if (UCD_CASE_TRIE_IS_DELTA(value)) {
+    if (out && out_len >= 1)
+      *out = (char32_t)((int32_t)cp + UCD_CASE_TRIE_DELTA(value));
+    return 1;
+  }
+
+  uint32_t ndx = UCD_CASE_TRIE_EXCEPTION(value);
+
+  if (ndx >= pcase->num_exceptions) {
+    if (out && out_len >= 1)
+      *out = cp;
+    return 1;
+  }
+
+  const uint8_t *base = (const uint8_t *)pcase;
+  const uint32_t *offsets = (const uint32_t *)(base
+                                               + pcase->exceptions_offset);
+  const uint32_t *exc = (const uint32_t *)(base + offsets[ndx]);
+  uint32_t word = *exc++;
+  size_t len = UCD_CASE_EXCEPTION_LENGTH(word);
+
+  if (word & UCD_CASE_EXCEPTION_HAS_SIMPLE) {
+    if (simple) {
+      if (out && out_len >= 1)
+        *out = *exc;
+      return 1;
+    }
+    ++exc;
+  } else if (simple && len != 1) {
+    if (out && out_len >= 1)
+      *out = cp;
+    return 1;
+  }
+
+  if (out) {
+    for (size_t n = 0; n < len && n < out_len; ++n)
+      out[n] = exc[n];
+  }
+
+  return len;
+}
+
+namespace ucd {
+
+  // One of the flags in a flag_trie, and how to test for it without the trie
+  struct trie_flag {
+    uint32_t flag;
+    bool   (*test)(const database &db, codepoint cp);
+  };
+
+  // Adapts a database accessor, e.g. &database::xid_start, for trie_flag
+  template <bool (database::*Property)(codepoint) const>
+  bool
+  has_property(const database &db, codepoint cp)
+  {
+    return (db.*Property)(cp);
+  }
+
+  /* A trie holding several binary properties as flags, so that they can be
+     had with a single lookup.  If the database file doesn't have the trie,
+     lookup() tests each of the properties instead. */
+  class flag_trie {
+  private:
+    const database        &_db;
+    const struct ucd_trie *_ptrie;
+    const trie_flag       *_flags;
+    size_t                 _count;
+
+  public:
+    flag_trie(const database &db, const struct ucd_trie *ptrie,
+              const trie_flag *flags, size_t count)
+      : _db(db), _ptrie(ptrie), _flags(flags), _count(count) {}
+
+    template <size_t N>
+    flag_trie(const database &db, const struct ucd_trie *ptrie,
+              const trie_flag (&flags)[N])
+      : flag_trie(db, ptrie, flags, N) {}
+
+    unsigned lookup(codepoint cp) const {
+      if (_ptrie)
+        return ucd_trie_lookup(_ptrie, cp);
+
+      unsigned result = 0;
+      for (size_t n = 0; n < _count; ++n) {
+        if (_flags[n].test(_db, cp))
+          result |= _flags[n].flag;
+      }
+      return result;
+    }
+  };
+
+}
+
+#endif /* UCD_TRIE_H_ */
@@ -0,0 +1,76 @@
+/*
+ * ucd-width.h - Measuring the display width of grapheme clusters
+ * libucd
+ *
+ * Copyright (c) 2015 Alastair Houghton
+ *
+ */
+
+#ifndef UCD_WIDTH_H_
+#define UCD_WIDTH_H_
+
+#include <algorithm>
+
+#include <libucd/libucd.h>
+#include "ucd-text.h"
+
+namespace ucd {
+
+  enum : codepoint {
+    text_presentation_selector = 0xfe0e,
+    emoji_presentation_selector = 0xfe0f
+  };
+
+  // Emoji data is optional; without it, the emoji version is nil
+  inline bool
+  have_emoji_data(const database &db)
+  {
+    return db.emoji_version() != version::nil;
+  }
+
+  /* Measures the grapheme cluster starting at ptr, moving ptr past it.
+     The cluster is as wide as its widest code point, unless it's an emoji
+     followed by a variation selector.  base is set to the first code point
+     in the cluster. */
+  template <class Codec>
+  inline unsigned
+  measure_cluster(const database &db, grapheme_iterator &graphemes,
+                  const typename Codec::code_unit *begin,
+                  const typename Codec::code_unit *&ptr,
+                  bool east_asian, bool have_emoji, codepoint &base)
+  {
+    typedef typename Codec::code_unit code_unit;
+
+    graphemes.reset(ptr - begin);
+    const code_unit *cluster_end = begin + graphemes.next();
+
+    uint32_t unit = unit_value(*ptr);
+    if (unit < 0x80 && ptr + 1 == cluster_end) {
+      base = unit;
+      ++ptr;
+      return unit >= ' ' && unit < 0x7f ? 1 : 0;
+    }
+
+    base = Codec::decode(ptr, cluster_end);
+
+    unsigned width = db.display_width(base, east_asian);
+    codepoint selector = 0;
+
+    while (ptr < cluster_end) {
+      codepoint cp = Codec::decode(ptr, cluster_end);
+      if (cp == text_presentation_selector
+          || cp == emoji_presentation_selector)
+        selector = cp;
+      else
+        width = std::max(width, db.display_width(cp, east_asian));
+    }
+
+    if (selector && have_emoji && db.emoji(base))
+      width = selector == emoji_presentation_selector ? 2 : 1;
+
+    return width;
+  }
+
+}
+
+#endif /* UCD_WIDTH_H_ */
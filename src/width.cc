@@ -0,0 +1,53 @@
+#include <libucd/libucd.h>
+#include "ucd-text.h"
+#include "ucd-width.h"
+#include "ucd-ascii.h"
+
+using namespace ucd;
+
+namespace {
+
+  template <class Codec>
+  size_t
+  text_width(const database &db, const text &txt, bool east_asian)
+  {
+    typedef typename Codec::code_unit code_unit;
+
+    const code_unit *begin = text_begin<Codec>(txt);
+    const code_unit *end = text_end<Codec>(txt);
+    const code_unit *ptr = begin;
+    grapheme_iterator graphemes(db, txt);
+    bool have_emoji = have_emoji_data(db);
+    size_t width = 0;
+
+    while (ptr < end) {
+      /* Printable ASCII characters are a column each, but the last one
+         might start a cluster with whatever comes next. */
+      size_t run = ascii_printable_span(ptr, end - ptr);
+      if (run && ptr + run < end && unit_value(ptr[run]) >= 0x80)
+        --run;
+      width += run;
+      ptr += run;
+
+      if (ptr == end)
+        break;
+
+      codepoint base;
+      width += measure_cluster<Codec>(db, graphemes, begin, ptr,
+                                      east_asian, have_emoji, base);
+    }
+
+    return width;
+  }
+
+}
+
+size_t
+database::display_width(const text &txt, bool east_asian) const
+{
+  size_t width = 0;
+
+  UCD_TEXT_DISPATCH(txt, width = text_width, (*this, txt, east_asian));
+
+  return width;
+}
@@ -0,0 +1,399 @@
+#include <libucd/libucd.h>
+#include "ucd-text.h"
+
+using namespace ucd;
+
+const size_t word_iterator::npos;
+
+namespace {
+
+  /* The states of the word break DFA.  Apart from the lookahead states,
+     each one says what the last code point that wasn't ignored by WB4 was
+     (and so what it might join with).  In the lookahead states we've seen
+     a MidLetter (or similar) and need the next code point to know whether
+     there's a boundary before it.
+
+     zwj_bit is set in addition if the last code point was a ZWJ, for WB3c. */
+  enum {
+    st_sot = 0,
+    st_other,
+    st_cr,
+    st_newline,
+    st_letter,
+    st_hebrew,
+    st_numeric,
+    st_katakana,
+    st_extendnumlet,
+    st_ebase,
+    st_ri_odd,
+    st_ri_even,
+    st_hebrew_sq,
+
+    // Lookahead states
+    st_letter_mid,
+    st_hebrew_dq,
+    st_numeric_mid,
+
+    zwj_bit = 0x10,
+    num_states = 0x20,
+
+    num_classes = 22,
+
+    no_break = 0x80,
+    state_mask = 0x7f
+  };
+
+  inline bool
+  is_lookahead(unsigned state)
+  {
+    state &= ~zwj_bit;
+    return state >= st_letter_mid;
+  }
+
+  inline bool
+  is_word_state(unsigned state)
+  {
+    state &= ~zwj_bit;
+    return state >= st_letter && state <= st_katakana;
+  }
+
+  inline bool
+  is(unsigned c, WB wb)
+  {
+    return c == unsigned(wb);
+  }
+
+  inline bool
+  is_ahletter(unsigned c)
+  {
+    return is(c, WB::LE) || is(c, WB::HL);
+  }
+
+  inline bool
+  is_midnumletq(unsigned c)
+  {
+    return is(c, WB::MB) || is(c, WB::SQ);
+  }
+
+  unsigned
+  start_state(unsigned c)
+  {
+    switch (c) {
+    case unsigned(WB::CR):  return st_cr;
+    case unsigned(WB::LF):
+    case unsigned(WB::NL):  return st_newline;
+    case unsigned(WB::LE):  return st_letter;
+    case unsigned(WB::HL):  return st_hebrew;
+    case unsigned(WB::NU):  return st_numeric;
+    case unsigned(WB::KA):  return st_katakana;
+    case unsigned(WB::EX):  return st_extendnumlet;
+    case unsigned(WB::EB):
+    case unsigned(WB::EBG): return st_ebase;
+    case unsigned(WB::RI):  return st_ri_odd;
+    case unsigned(WB::ZWJ): return st_other | zwj_bit;
+    default:                return st_other;
+    }
+  }
+
+  // Rules WB3 to WB999 from UAX #29
+  bool
+  wb_joins(unsigned state, unsigned c, unsigned &next)
+  {
+    unsigned base = state & ~zwj_bit;
+
+    if (base == st_sot) {
+      next = start_state(c);
+      return true;
+    }
+
+    if (base == st_cr && is(c, WB::LF)) {
+      next = st_newline;
+      return true;                                                   // WB3
+    }
+
+    if (base == st_cr || base == st_newline)
+      return false;                                                  // WB3a
+
+    if (is(c, WB::CR) || is(c, WB::LF) || is(c, WB::NL))
+      return false;                                                  // WB3b
+
+    if ((state & zwj_bit) && (is(c, WB::GAZ) || is(c, WB::EBG))) {
+      if (is_lookahead(base))
+        return false;
+      next = start_state(c);
+      return true;                                                   // WB3c
+    }
+
+    if (is(c, WB::Extend) || is(c, WB::FO) || is(c, WB::ZWJ)) {
+      next = base | (is(c, WB::ZWJ) ? unsigned(zwj_bit) : 0);
+      return true;                                                   // WB4
+    }
+
+    switch (base) {
+    case st_letter:
+    case st_hebrew:
+      if (is_ahletter(c)
+          || is(c, WB::NU)
+          || is(c, WB::EX)) {
+        next = start_state(c);
+        return true;                                      // WB5, 9, 13a
+      }
+      if (base == st_hebrew && is(c, WB::SQ)) {
+        next = st_hebrew_sq;
+        return true;                                                 // WB7a
+      }
+      if (is(c, WB::ML) || is_midnumletq(c)) {
+        next = st_letter_mid;
+        return true;                                                 // WB6
+      }
+      if (base == st_hebrew && is(c, WB::DQ)) {
+        next = st_hebrew_dq;
+        return true;                                                 // WB7b
+      }
+      return false;
+
+    case st_letter_mid:
+    case st_hebrew_sq:
+      if (is_ahletter(c)) {
+        next = start_state(c);
+        return true;                                                 // WB7
+      }
+      return false;
+
+    case st_hebrew_dq:
+      if (is(c, WB::HL)) {
+        next = st_hebrew;
+        return true;                                                 // WB7c
+      }
+      return false;
+
+    case st_numeric:
+      if (is(c, WB::NU) || is_ahletter(c) || is(c, WB::EX)) {
+        next = start_state(c);
+        return true;                                     // WB8, 10, 13a
+      }
+      if (is(c, WB::MN) || is_midnumletq(c)) {
+        next = st_numeric_mid;
+        return true;                                                 // WB12
+      }
+      return false;
+
+    case st_numeric_mid:
+      if (is(c, WB::NU)) {
+        next = st_numeric;
+        return true;                                                 // WB11
+      }
+      return false;
+
+    case st_katakana:
+      if (is(c, WB::KA) || is(c, WB::EX)) {
+        next = start_state(c);
+        return true;                                           // WB13, 13a
+      }
+      return false;
+
+    case st_extendnumlet:
+      if (is_ahletter(c) || is(c, WB::NU) || is(c, WB::KA)
+          || is(c, WB::EX)) {
+        next = start_state(c);
+        return true;                                          // WB13a, 13b
+      }
+      return false;
+
+    case st_ebase:
+      if (is(c, WB::EM)) {
+        next = st_other;
+        return true;                                                 // WB14
+      }
+      return false;
+
+    case st_ri_odd:
+      if (is(c, WB::RI)) {
+        next = st_ri_even;
+        return true;                                             // WB15, 16
+      }
+      return false;
+    }
+
+    return false;                                                    // WB999
+  }
+
+  /* The rules compiled into a table indexed by state and the Word_Break
+     value of the next code point; each entry is the next state, plus
+     no_break if there isn't a boundary before the code point.  We also
+     keep the Word_Break values of the ASCII characters here so that we
+     don't need to ask the database about them. */
+  struct wb_table {
+    uint8_t entries[num_states][num_classes];
+    uint8_t ascii[0x80];
+
+    wb_table() {
+      for (unsigned state = 0; state < num_states; ++state) {
+        for (unsigned c = 0; c < num_classes; ++c) {
+          unsigned next = st_other;
+          bool joined = wb_joins(state, c, next);
+          entries[state][c] = joined ? (next | no_break) : 0;
+        }
+      }
+
+      for (unsigned cp = 0; cp < 0x80; ++cp) {
+        WB wb = WB::XX;
+
+        if ((cp >= 'A' && cp <= 'Z') || (cp >= 'a' && cp <= 'z'))
+          wb = WB::LE;
+        else if (cp >= '0' && cp <= '9')
+          wb = WB::NU;
+        else {
+          switch (cp) {
+          case '\n': wb = WB::LF; break;
+          case '\r': wb = WB::CR; break;
+          case 0x0b:
+          case 0x0c: wb = WB::NL; break;
+          case '"':  wb = WB::DQ; break;
+          case '\'': wb = WB::SQ; break;
+          case '.':  wb = WB::MB; break;
+          case ':':  wb = WB::ML; break;
+          case ',':
+          case ';':  wb = WB::MN; break;
+          case '_':  wb = WB::EX; break;
+          }
+        }
+
+        ascii[cp] = uint8_t(wb);
+      }
+    }
+  };
+
+  const wb_table &
+  get_wb_table()
+  {
+    static const wb_table table;
+    return table;
+  }
+
+  inline unsigned
+  wb_class(const database &db, const wb_table &table, codepoint cp)
+  {
+    if (cp < 0x80)
+      return table.ascii[cp];
+
+    unsigned c = unsigned(db.word_break(cp));
+    return c < num_classes ? c : unsigned(WB::XX);
+  }
+
+}
+
+word_iterator::word_iterator(const database &db, mode m)
+  : _db(db), _mode(m), _state(st_sot), _start(0), _accept(0), _word(false),
+    _pending_len(0), _current{0, 0, false}
+{
+}
+
+word_iterator::word_iterator(const database &db, const text &txt, mode m)
+  : word_iterator(db, m)
+{
+  feed(txt, true);
+}
+
+void
+word_iterator::emit(size_t end)
+{
+  _pending[_pending_len++] = segment{ _start, end, _word };
+  _start = end;
+  _word = false;
+}
+
+void
+word_iterator::push(codepoint cp, unsigned cls, size_t begin, size_t end)
+{
+  const wb_table &table = get_wb_table();
+  unsigned entry = table.entries[_state][cls];
+
+  if (!(entry & no_break)) {
+    /* If the lookahead failed, there's a boundary before the character
+       that started it, and we carry on from there. */
+    if (is_lookahead(_state)) {
+      emit(_accept);
+      _state = st_other | (_state & zwj_bit);
+      entry = table.entries[_state][cls];
+    }
+
+    if (!(entry & no_break)) {
+      emit(begin);
+      _state = st_sot;
+      entry = table.entries[st_sot][cls];
+    }
+  }
+
+  unsigned next = entry & state_mask;
+
+  if (_state == st_sot) {
+    // Ideographs and letters without a Word_Break value are words too
+    _word = is_word_state(next);
+    if (!_word && cp >= 0x80 && (next & ~zwj_bit) == st_other) {
+      gc cat = _db.general_category(cp) & General_Category::Group_Mask;
+      _word = cat == General_Category::L || cat == General_Category::N;
+    }
+  } else if (is_word_state(next))
+    _word = true;
+
+  _state = next;
+
+  if (!is_lookahead(next))
+    _accept = end;
+}
+
+void
+word_iterator::finish()
+{
+  size_t end = _input.end();
+
+  if (_state == st_sot)
+    return;
+
+  if (is_lookahead(_state)) {
+    emit(_accept);
+    if (_accept < end)
+      emit(end);
+  } else {
+    emit(end);
+  }
+
+  _state = st_sot;
+}
+
+template <class Codec>
+void
+word_iterator::scan()
+{
+  const wb_table &table = get_wb_table();
+  codepoint cp;
+  size_t begin, end;
+
+  while (!_pending_len && read_codepoint<Codec>(_input, cp, begin, end))
+    push(cp, wb_class(_db, table, cp), begin, end);
+}
+
+size_t
+word_iterator::next()
+{
+  for (;;) {
+    while (!_pending_len) {
+      if (_input.has_input()) {
+        UCD_TEXT_DISPATCH(_input.chunk, scan, ());
+      } else {
+        if (_input.final)
+          finish();
+        if (!_pending_len)
+          return npos;
+      }
+    }
+
+    _current = _pending[0];
+    _pending[0] = _pending[1];
+    --_pending_len;
+
+    if (_mode == mode::all || _current.word)
+      return _current.end;
+  }
+}
@@ -0,0 +1,227 @@
+#include <libucd/libucd.h>
+#include "ucd-text.h"
+#include "ucd-width.h"
+#include "ucd-ascii.h"
+
+using namespace ucd;
+
+const size_t wrap_iterator::npos;
+
+namespace {
+
+  inline bool
+  is_line_end(codepoint cp)
+  {
+    return ((cp >= 0x0a && cp <= 0x0d) || cp == 0x85
+            || cp == 0x2028 || cp == 0x2029);
+  }
+
+  /* Finds the longest prefix that fits in width columns, and also the
+     longest that fits in soft_width (<= width) columns, in one pass. */
+  template <class Codec>
+  size_t
+  fit(const database &db, const text &txt, size_t width, bool east_asian,
+      size_t &used, size_t soft_width, size_t &soft_len)
+  {
+    typedef typename Codec::code_unit code_unit;
+
+    const code_unit *begin = text_begin<Codec>(txt);
+    const code_unit *end = text_end<Codec>(txt);
+    const code_unit *ptr = begin;
+    grapheme_iterator graphemes(db, txt);
+    bool have_emoji = have_emoji_data(db);
+
+    used = 0;
+    soft_len = 0;
+
+    while (ptr < end) {
+      // As in display_width(), skip printable ASCII a block at a time
+      size_t run = ascii_printable_span(ptr, std::min(size_t(end - ptr),
+                                                      width - used));
+      if (run && ptr + run < end && unit_value(ptr[run]) >= 0x80)
+        --run;
+      if (used < soft_width)
+        soft_len = ptr - begin + std::min(run, soft_width - used);
+      used += run;
+      ptr += run;
+
+      if (ptr == end)
+        break;
+
+      const code_unit *next = ptr;
+      codepoint base;
+      unsigned w = measure_cluster<Codec>(db, graphemes, begin, next,
+                                          east_asian, have_emoji, base);
+
+      if (used + w > width)
+        break;
+
+      used += w;
+      ptr = next;
+
+      if (used <= soft_width)
+        soft_len = ptr - begin;
+    }
+
+    return ptr - begin;
+  }
+
+}
+
+wrap_iterator::wrap_iterator(const database &db, const text &txt,
+                             size_t width, bool east_asian)
+  : _db(db), _text(txt), _max_width(width), _east_asian(east_asian),
+    _have_emoji(have_emoji_data(db)), _graphemes(db, txt),
+    _breaks(db, txt, east_asian), _next_break(0), _pos(0),
+    _line{0, 0, 0, 0}, _break_at(0), _at_break(_line), _current(_line),
+    _current_end(0)
+{
+}
+
+size_t
+wrap_iterator::emit(size_t end, const line &ln)
+{
+  _current = ln;
+  _current_end = end;
+  _line = line{end, 0, end, 0};
+  _break_at = end;
+  return end;
+}
+
+template <class Codec>
+size_t
+wrap_iterator::scan()
+{
+  typedef typename Codec::code_unit code_unit;
+
+  const code_unit *begin = text_begin<Codec>(_text);
+  const code_unit *end = text_end<Codec>(_text);
+  const code_unit *ptr = begin + _pos;
+
+  while (ptr < end) {
+    size_t offset = ptr - begin;
+    const code_unit *next = ptr;
+    codepoint base;
+    unsigned w = measure_cluster<Codec>(_db, _graphemes, begin, next,
+                                        _east_asian, _have_emoji, base);
+
+    // Break opportunities inside a cluster are ignored
+    while (_next_break < offset)
+      _next_break = _breaks.next();
+
+    if (_next_break == offset && offset > _line.start) {
+      if (_breaks.is_mandatory())
+        return emit(offset, _line);
+
+      _break_at = offset;
+      _at_break = _line;
+    }
+
+    // Spaces are allowed to hang off the end of the line
+    bool is_space = base == ' ';
+
+    if (w && !is_space && _line.width + w > _max_width
+        && offset > _line.start) {
+      if (_break_at == _line.start) {
+        // There's nowhere better, so break before this cluster
+        return emit(offset, _line);
+      }
+
+      // Anything after the break moves on to the next line
+      size_t brk = _break_at;
+      line rest = { brk, _line.width - _at_break.width, brk, 0 };
+
+      if (_line.content_end > brk) {
+        rest.content_end = _line.content_end;
+        rest.content_width = _line.content_width - _at_break.width;
+      }
+
+      emit(brk, _at_break);
+      _line = rest;
+      return brk;
+    }
+
+    _line.width += w;
+    if (!is_space && !is_line_end(base)) {
+      _line.content_width = _line.width;
+      _line.content_end = next - begin;
+    }
+
+    ptr = next;
+    _pos = ptr - begin;
+  }
+
+  if (_line.start < _text.length())
+    return emit(_text.length(), _line);
+
+  return npos;
+}
+
+size_t
+wrap_iterator::next()
+{
+  size_t end = npos;
+  UCD_TEXT_DISPATCH(_text, end = scan, ());
+  return end;
+}
+
+size_t
+ucd::fit_to_width(const database &db, const text &txt, size_t width,
+                  bool east_asian, size_t *pwidth)
+{
+  size_t len = 0, used = 0, soft_len;
+
+  UCD_TEXT_DISPATCH(txt, len = fit,
+                    (db, txt, width, east_asian, used, width, soft_len));
+
+  if (pwidth)
+    *pwidth = used;
+
+  return len;
+}
+
+std::string
+ucd::truncate_to_width(const database &db, const std::string &utf8,
+                       size_t width, const std::string &ellipsis,
+                       bool east_asian)
+{
+  size_t ellipsis_width = db.display_width(ellipsis, east_asian);
+  size_t soft_width = ellipsis_width < width ? width - ellipsis_width : 0;
+  size_t used, soft_len;
+  size_t len = fit<utf8_codec>(db, utf8, width, east_asian, used,
+                               soft_width, soft_len);
+
+  if (len == utf8.size())
+    return utf8;
+
+  // If the ellipsis itself doesn't fit, just cut the string short
+  if (ellipsis_width > width)
+    return utf8.substr(0, len);
+
+  std::string result;
+  result.reserve(soft_len + ellipsis.size());
+  result.append(utf8, 0, soft_len);
+  result.append(ellipsis);
+
+  return result;
+}
+
+std::string
+ucd::wrap(const database &db, const std::string &utf8, size_t width,
+          bool east_asian)
+{
+  wrap_iterator it(db, utf8, width, east_asian);
+  std::string result;
+  bool first = true;
+
+  result.reserve(utf8.size());
+
+  while (it.next() != wrap_iterator::npos) {
+    if (!first)
+      result.push_back('\n');
+    first = false;
+    result.append(utf8, it.start(), it.content_end() - it.start());
+  }
+
+  return result;
+}
@@ -25,3 +25,27 @@ TEST_CASE("we can inspect Age properties", "[age]") {
   REQUIRE(db.age(0x0978) == version(7, 0));
   REQUIRE(db.age(0xefffd) == version::nil);
 }
+
+TEST_CASE("we can check text against a Unicode version", "[age-scan]") {
+  database db;
+
+  db.open("ucd/packed/unicode-9.0.0.ucd");
+
+  std::string ascii("Nothing in this string is newer than Unicode 1.1");
+  std::string utf8("Lira \xe2\x82\xba and a face \xf0\x9f\x98\xb4 in UTF-8");
+
+  REQUIRE(db.max_age(ascii) == version(1, 1));
+  REQUIRE(db.max_age(std::string()) == version::nil);
+  REQUIRE(db.max_age(utf8) == version(6, 2));
+  REQUIRE(db.max_age(std::u16string(u"a\u0978\u20ba")) == version(7, 0));
+  REQUIRE(db.max_age(std::u32string(U"\U000efffd")) == version::nil);
+
+  REQUIRE(db.first_newer_than(ascii, version(1, 1)) == ascii.length());
+  REQUIRE(db.first_newer_than(utf8, version(9, 0)) == utf8.length());
+  REQUIRE(db.first_newer_than(utf8, version(6, 1)) == 5);
+  REQUIRE(db.first_newer_than(utf8, version(6, 0)) == 5);
+  REQUIRE(db.first_newer_than(std::u16string(u"ab\U0001f634"),
+                              version(6, 0)) == 2);
+  REQUIRE(db.first_newer_than(std::u32string(U"ab\U000efffd"),
+                              version(9, 0)) == 2);
+}
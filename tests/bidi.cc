@@ -1,5 +1,6 @@
 #include "catch.hpp"
 #include <libucd/libucd.h>
+#include <vector>
 
 using namespace ucd;
 
@@ -79,3 +80,136 @@ TEST_CASE("we can read the Bidi_Paired_Bracket property", "[bidi-brak]") {
   REQUIRE(db.bidi_paired_bracket(0x27ef, type) == char32_t(0x27ee));
   REQUIRE(type == Bidi_Paired_Bracket_Type::Close);
 }
+
+namespace {
+
+  std::vector<unsigned>
+  bidi_levels(const bidi_workspace &ws)
+  {
+    return std::vector<unsigned>(ws.levels(), ws.levels() + ws.size());
+  }
+
+  std::vector<size_t>
+  bidi_order(bidi_workspace &ws, size_t first = 0,
+             size_t last = bidi_workspace::npos)
+  {
+    const size_t *order = ws.reorder(first, last);
+    if (last > ws.size())
+      last = ws.size();
+    return std::vector<size_t>(order, order + (last - first));
+  }
+
+}
+
+TEST_CASE("we can run the bidi algorithm", "[bidi-algorithm]") {
+  database db;
+
+  db.open("ucd/packed/unicode-9.0.0.ucd");
+
+  bidi_workspace ws(db);
+  typedef std::vector<unsigned> levels;
+  typedef std::vector<size_t> order;
+
+  SECTION("simple paragraphs") {
+    ws.resolve(std::string("abc"));
+    REQUIRE(ws.paragraph_level() == 0);
+    REQUIRE(bidi_levels(ws) == levels({0, 0, 0}));
+    REQUIRE(bidi_order(ws) == order({0, 1, 2}));
+
+    ws.resolve(std::u32string(U"\u05d0\u05d1\u05d2"));
+    REQUIRE(ws.paragraph_level() == 1);
+    REQUIRE(bidi_levels(ws) == levels({1, 1, 1}));
+    REQUIRE(bidi_order(ws) == order({2, 1, 0}));
+
+    ws.resolve(std::u32string(U"ab \u05d0\u05d1 cd"));
+    REQUIRE(bidi_levels(ws) == levels({0, 0, 0, 1, 1, 0, 0, 0}));
+    REQUIRE(bidi_order(ws) == order({0, 1, 2, 4, 3, 5, 6, 7}));
+
+    ws.resolve(std::u32string(U"\u05d0\u0301"));
+    REQUIRE(bidi_levels(ws) == levels({1, 1}));
+  }
+
+  SECTION("numbers") {
+    ws.resolve(std::u32string(U"\u05d0 12"));
+    REQUIRE(bidi_levels(ws) == levels({1, 1, 2, 2}));
+    REQUIRE(bidi_order(ws) == order({2, 3, 1, 0}));
+
+    ws.resolve(std::u32string(U"\u062712"));
+    REQUIRE(bidi_levels(ws) == levels({1, 2, 2}));
+    REQUIRE(bidi_order(ws) == order({1, 2, 0}));
+  }
+
+  SECTION("explicit embeddings and isolates") {
+    ws.resolve(std::u32string(U"a\u2067bc\u2069d"));
+    REQUIRE(bidi_levels(ws) == levels({0, 0, 2, 2, 0, 0}));
+
+    ws.resolve(std::u32string(U"\u2068\u05d0\u2069"),
+               bidi_workspace::direction::ltr);
+    REQUIRE(bidi_levels(ws) == levels({0, 1, 0}));
+
+    ws.resolve(std::u32string(U"\u202eabc\u202c"));
+    REQUIRE(bidi_levels(ws) == levels({0, 1, 1, 1, 1}));
+    REQUIRE(bidi_order(ws) == order({0, 3, 2, 1, 4}));
+    REQUIRE(ws.line_levels()[4] == 0);
+  }
+
+  SECTION("bracket pairs") {
+    ws.resolve(std::u32string(U"a(b)\u05d0"), bidi_workspace::direction::rtl);
+    REQUIRE(bidi_levels(ws) == levels({2, 2, 2, 2, 1}));
+    REQUIRE(bidi_order(ws) == order({4, 0, 1, 2, 3}));
+  }
+
+  SECTION("lines") {
+    ws.resolve(std::u32string(U"\u05d0\t\u05d1"),
+               bidi_workspace::direction::ltr);
+    REQUIRE(bidi_levels(ws) == levels({1, 1, 1}));
+    REQUIRE(bidi_order(ws) == order({0, 1, 2}));
+    REQUIRE(ws.line_levels()[1] == 0);
+
+    ws.resolve(std::u32string(U"\u05d0\u05d1 \u05d2\u05d3"),
+               bidi_workspace::direction::ltr);
+    REQUIRE(bidi_order(ws, 0, 3) == order({1, 0, 2}));
+    REQUIRE(bidi_order(ws, 3, 5) == order({4, 3}));
+  }
+
+  SECTION("offsets") {
+    ws.resolve(std::string("a\xd7\x90"));
+    REQUIRE(ws.size() == 2);
+    REQUIRE(ws.offset(1) == 1);
+    REQUIRE(ws.offset(2) == 3);
+    REQUIRE(bidi_levels(ws) == levels({0, 1}));
+  }
+}
+
+TEST_CASE("we can check whether text needs the bidi algorithm", "[needs-bidi]") {
+  database db;
+
+  db.open("ucd/packed/unicode-9.0.0.ucd");
+
+  SECTION("left-to-right text") {
+    REQUIRE(!db.needs_bidi(std::string("")));
+    REQUIRE(!db.needs_bidi(std::string("The quick brown fox jumps over "
+                                       "the lazy dog 1234567890 times.")));
+    REQUIRE(!db.needs_bidi(std::string("na\xc3\xafve caf\xc3\xa9 \xe6\x97\xa5"
+                                       "\xe6\x9c\xac\xe8\xaa\x9e "
+                                       "\xf0\x9f\x98\x80 and more text")));
+    REQUIRE(!db.needs_bidi(std::u16string(u"\u00e9\u0416\u3042 abcdefghij")));
+    REQUIRE(!db.needs_bidi(std::u32string(U"\u00e9\u0416\u3042 abc")));
+  }
+
+  SECTION("right-to-left text") {
+    REQUIRE(db.needs_bidi(std::string("\xd7\x90")));
+    REQUIRE(db.needs_bidi(std::string("The quick brown fox jumps over "
+                                      "the lazy \xd7\x90")));
+    REQUIRE(db.needs_bidi(std::string("The quick brown fox \xd8\xa7")));
+    REQUIRE(db.needs_bidi(std::u16string(u"abcdefghijklmnop\u05d0")));
+    REQUIRE(db.needs_bidi(std::u32string(U"abc\u0627")));
+  }
+
+  SECTION("Arabic numbers and controls") {
+    REQUIRE(db.needs_bidi(std::u32string(U"\u0661")));
+    REQUIRE(db.needs_bidi(std::string("abcdefghijklmnopqrs\xe2\x80\xae")));
+    REQUIRE(db.needs_bidi(std::u16string(u"abc\u2067def")));
+    REQUIRE(!db.needs_bidi(std::u32string(U"abc\u200bdef")));
+  }
+}
@@ -47,3 +47,105 @@ TEST_CASE("check that various binary properties work", "[binprops]") {
   REQUIRE(db.alphabetic('*') == false);
   REQUIRE(db.grapheme_base(0x212a) == true);
 }
+
+template <class String>
+static size_t
+scan(const database &db, const String &str,
+     identifier_syntax syntax = identifier_syntax::xid)
+{
+  return db.scan_identifier(str.data(), str.size(), syntax);
+}
+
+TEST_CASE("we can scan identifiers", "[identifiers]") {
+  database db;
+
+  db.open("ucd/packed/unicode-9.0.0.ucd");
+
+  typedef std::string s;
+  typedef std::u32string u;
+
+  SECTION("ASCII") {
+    REQUIRE(scan(db, s("")) == 0);
+    REQUIRE(scan(db, s("foo_bar42 + 1")) == 9);
+    REQUIRE(scan(db, s("_private")) == 8);
+    REQUIRE(scan(db, s("9lives")) == 0);
+    REQUIRE(scan(db, s("a_rather_long_identifier_indeed(x)")) == 31);
+  }
+
+  SECTION("non-ASCII") {
+    REQUIRE(scan(db, s("caf\xc3\xa9=1")) == 5);
+    REQUIRE(scan(db, s("x\xcc\x81y")) == 4);
+    REQUIRE(scan(db, s("\xcc\x81y")) == 0);
+    REQUIRE(scan(db, s("a\xe2\x86\x90" "b")) == 1);
+    REQUIRE(scan(db, u(U"\u03b1\u00b7\u0660;")) == 3);
+  }
+
+  SECTION("XID and ID") {
+    REQUIRE(scan(db, u(U"a\u309b")) == 1);
+    REQUIRE(scan(db, u(U"a\u309b"), identifier_syntax::id) == 2);
+    REQUIRE(scan(db, u(U"\u309bx")) == 0);
+    REQUIRE(scan(db, u(U"\u309bx"), identifier_syntax::id) == 2);
+  }
+
+  SECTION("white space") {
+    s ws(" \t\r\n\xc2\x85x");
+    u ws32(U"\u200e\u2028 x");
+
+    REQUIRE(db.scan_pattern_white_space(ws.data(), ws.size()) == 6);
+    REQUIRE(db.scan_pattern_white_space(ws32.data(), ws32.size()) == 3);
+  }
+}
+
+TEST_CASE("we can find and strip hidden characters", "[hidden]") {
+  database db;
+
+  db.open("ucd/packed/unicode-9.0.0.ucd");
+
+  SECTION("properties") {
+    REQUIRE(db.hidden_properties('a') == 0);
+    REQUIRE(db.hidden_properties(0x202e)
+            == (Hidden_Property::bidi_control
+                | Hidden_Property::default_ignorable));
+    REQUIRE(db.hidden_properties(0x200d)
+            == (Hidden_Property::join_control
+                | Hidden_Property::default_ignorable));
+    REQUIRE(db.hidden_properties(0xe0100)
+            == (Hidden_Property::variation_selector
+                | Hidden_Property::default_ignorable));
+    REQUIRE(db.hidden_properties(0xfdd0) == (Hidden_Property::noncharacter
+                                             | Hidden_Property::unassigned));
+    REQUIRE(db.hidden_properties(0x0378) == Hidden_Property::unassigned);
+  }
+
+  SECTION("Trojan Source") {
+    std::string src("if (level != \"user\xe2\x80\xae \xe2\x81\xa6// admin"
+                    "\xe2\x81\xa9 \xe2\x81\xa6\") {");
+
+    REQUIRE(db.find_hidden(text(src)) == 18);
+    REQUIRE(db.find_hidden(text(src), 21) == 22);
+    REQUIRE(db.find_hidden(text(src), 0, Hidden_Property::unassigned)
+            == src.size());
+    REQUIRE(db.strip_hidden(src) == "if (level != \"user // admin \") {");
+    REQUIRE(db.strip_hidden(src, Hidden_Property::join_control) == src);
+  }
+
+  SECTION("other encodings") {
+    std::u32string u(U"a\u200db\U000e0100c\u0378");
+
+    REQUIRE(db.find_hidden(text(u)) == 1);
+    REQUIRE(db.strip_hidden(u) == U"abc");
+    REQUIRE(db.strip_hidden(u, Hidden_Property::variation_selector)
+            == U"a\u200dbc\u0378");
+  }
+
+  SECTION("buffers") {
+    std::string s("ab\xe2\x80\x8b" "cdefghij");
+    char buf[4];
+
+    REQUIRE(db.strip_hidden(s.data(), s.size(), buf, sizeof(buf)) == 10);
+    REQUIRE(std::string(buf, 2) == "ab");
+
+    size_t len = db.strip_hidden(s.data(), s.size(), &s[0], s.size());
+    REQUIRE(s.substr(0, len) == "abcdefghij");
+  }
+}
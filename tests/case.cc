@@ -88,6 +88,20 @@ TEST_CASE("we can obtain case mapping data", "[case]") {
   ok = (out2.size() == 3
           && out2[0] == 0x399 && out2[1] == 0x308 && out2[2] == 0x0301);
   REQUIRE(ok);
+
+  // Mappings that are too far away for a delta (U+A7AE <-> U+026A)
+  len = db.uppercase_mapping(0x26a, out, 4);
+  ok = (len == 1 && out[0] == 0xa7ae);
+  REQUIRE(ok);
+
+  len = db.lowercase_mapping(0xa7ae, out, 4);
+  ok = (len == 1 && out[0] == 0x26a);
+  REQUIRE(ok);
+
+  // The length is returned even if the output doesn't fit
+  len = db.uppercase_mapping(0x390, out, 1);
+  ok = (len == 3 && out[0] == 0x399);
+  REQUIRE(ok);
 }
 
 TEST_CASE("we can obtain case folding data", "[casefold]") {
@@ -100,6 +114,9 @@ TEST_CASE("we can obtain case folding data", "[casefold]") {
     REQUIRE(db.simple_case_folding(0xc1) == 0xe1u);
     REQUIRE(db.simple_case_folding(0x1e9e) == 0xdfu);
     REQUIRE(db.simple_case_folding(0x1f9f) == 0x1f97u);
+    REQUIRE(db.simple_case_folding(0xdf) == 0xdfu);
+    REQUIRE(db.simple_case_folding(0x26a) == 0x26au);
+    REQUIRE(db.simple_case_folding(0xa7ae) == 0x26au);
   }
 
   SECTION("full case folding") {
@@ -144,4 +161,154 @@ TEST_CASE("normalisation case folding works", "[nfkc-casefold]") {
     REQUIRE(db.fc_nfkc_closure(0x3250) == cpvector({ 'p', 't', 'e' }));
     REQUIRE(db.fc_nfkc_closure(0x1f146) == cpvector({ 'w' }));
   }
+
+  SECTION("NFKC case folding of strings") {
+    REQUIRE(db.nfkc_casefold(std::string("Hello")) == "hello");
+    REQUIRE(db.nfkc_casefold(std::string("CAFE\xcc\x81")) == "caf\xc3\xa9");
+    REQUIRE(db.nfkc_casefold(std::string("\xe2\x84\xab")) == "\xc3\xa5");
+    REQUIRE(db.nfkc_casefold(std::string("\xef\xac\x81le\xc2\xadname"))
+            == "filename");
+    REQUIRE(db.nfkc_casefold(std::string("\xe2\x85\xab")) == "xii");
+    REQUIRE(db.nfkc_casefold(std::string("d\xcc\x81\xcc\xa3"))
+            == "\xe1\xb8\x8d\xcc\x81");
+    REQUIRE(db.nfkc_casefold(std::u16string(u"\u212b")) == u"\u00e5");
+    REQUIRE(db.nfkc_casefold(std::u32string(U"\u212b")) == U"\u00e5");
+
+    REQUIRE(db.is_nfkc_casefolded("caf\xc3\xa9", 5));
+    REQUIRE(!db.is_nfkc_casefolded("Cafe", 4));
+    REQUIRE(!db.is_nfkc_casefolded("\xe2\x84\xab", 3));
+
+    // Ill-formed input becomes U+FFFD, whichever overload you use
+    REQUIRE(db.nfkc_casefold(std::string("a\xff")) == "a\xef\xbf\xbd");
+    REQUIRE(db.nfkc_casefold(std::string("\xf0\x90\x80"))
+            == "\xef\xbf\xbd");
+    REQUIRE(db.nfkc_casefold(std::u16string(u"x") + char16_t(0xd800))
+            == u"x\ufffd");
+    REQUIRE(db.nfkc_casefold(std::u32string(1, char32_t(0x110000)))
+            == U"\ufffd");
+    REQUIRE(db.nfkc_casefold(std::string("\xef\xbf\xbd")) == "\xef\xbf\xbd");
+    REQUIRE(!db.is_nfkc_casefolded("\xff", 1));
+    REQUIRE(db.is_nfkc_casefolded("\xef\xbf\xbd", 3));
+  }
+}
+
+TEST_CASE("we can change the case of strings", "[case-string]") {
+  database db;
+
+  db.open("ucd/packed/unicode-9.0.0.ucd");
+
+  SECTION("uppercase") {
+    REQUIRE(db.to_uppercase(std::string("Hello, World!")) == "HELLO, WORLD!");
+    REQUIRE(db.to_uppercase(std::string(u8"straße")) == u8"STRASSE");
+    REQUIRE(db.to_uppercase(std::string(u8"ǆemal")) == u8"ǄEMAL");
+    REQUIRE(db.to_uppercase(std::u16string(u"straße")) == u"STRASSE");
+    REQUIRE(db.to_uppercase(std::u32string(U"ﬃ")) == U"FFI");
+  }
+
+  SECTION("lowercase and final sigma") {
+    REQUIRE(db.to_lowercase(std::string("Hello, World!")) == "hello, world!");
+    REQUIRE(db.to_lowercase(std::string(u8"ΟΔΟΣ")) == u8"οδος");
+    REQUIRE(db.to_lowercase(std::string(u8"ΟΔΟΣ ΟΔΟΣ.")) == u8"οδος οδος.");
+    REQUIRE(db.to_lowercase(std::string(u8"ΑΣΑ")) == u8"ασα");
+    REQUIRE(db.to_lowercase(std::string(u8"Σ")) == u8"σ");
+    REQUIRE(db.to_lowercase(std::string(u8"İ")) == "i\xcc\x87");
+    REQUIRE(db.to_lowercase(std::u16string(u"ΟΔΟΣ")) == u"οδος");
+  }
+
+  SECTION("titlecase") {
+    REQUIRE(db.to_titlecase(std::string("hello wORLD")) == "Hello World");
+    REQUIRE(db.to_titlecase(std::string("can't stop")) == "Can't Stop");
+    REQUIRE(db.to_titlecase(std::string(u8"ǆemal")) == u8"ǅemal");
+    REQUIRE(db.to_titlecase(std::string(u8"ﬃ")) == u8"Ffi");
+  }
+
+  SECTION("language specific rules") {
+    REQUIRE(db.to_uppercase(std::string("istanbul"), "tr") == u8"İSTANBUL");
+    REQUIRE(db.to_lowercase(std::string("ISPARTA"), "tr") == u8"ısparta");
+    REQUIRE(db.to_lowercase(std::string("I\xcc\x87"), "tr") == "i");
+    REQUIRE(db.to_lowercase(std::string(u8"İ"), "az") == "i");
+    REQUIRE(db.to_lowercase(std::string("\xc3\x8c"), "lt")
+            == "i\xcc\x87\xcc\x80");
+    REQUIRE(db.to_lowercase(std::string("J\xcc\x81"), "lt")
+            == "j\xcc\x87\xcc\x81");
+    REQUIRE(db.to_uppercase(std::string("i\xcc\x87"), "lt") == "I");
+  }
+
+  SECTION("buffer sizing") {
+    char buf[4];
+    REQUIRE(db.to_uppercase(u8"ß", 2, nullptr, 0) == 2);
+    REQUIRE(db.to_uppercase(u8"ßß", 4, buf, 3) == 4);
+    REQUIRE(std::string(buf, 2) == "SS");
+  }
+}
+
+TEST_CASE("we can case fold strings", "[casefold-string]") {
+  database db;
+
+  db.open("ucd/packed/unicode-9.0.0.ucd");
+
+  SECTION("folding") {
+    REQUIRE(db.fold_case(std::string("Hello, World!")) == "hello, world!");
+    REQUIRE(db.fold_case(std::string(u8"Straße")) == "strasse");
+    REQUIRE(db.fold_case(std::string(u8"ΟΔΟΣ")) == u8"οδοσ");
+    REQUIRE(db.fold_case(std::u16string(u"ᾟ")) == u"ἧι");
+    REQUIRE(db.fold_case(std::u32string(U"ẞ")) == U"ss");
+  }
+
+  SECTION("comparison") {
+    REQUIRE(db.casefold_compare(std::string("hello"),
+                                std::string("HELLO")) == 0);
+    REQUIRE(db.casefold_compare(std::string(u8"STRASSE"),
+                                std::string(u8"straße")) == 0);
+    REQUIRE(db.casefold_compare(std::string(u8"ΟΔΟΣ"),
+                                std::string(u8"οδος")) == 0);
+    REQUIRE(db.casefold_compare(std::string("abc"), std::string("ABD")) < 0);
+    REQUIRE(db.casefold_compare(std::string("ABCD"), std::string("abc")) > 0);
+    REQUIRE(db.casefold_compare(std::string("s"), std::string(u8"ß")) < 0);
+    REQUIRE(db.casefold_compare(std::u16string(u"Straße"),
+                                std::u16string(u"STRASSE")) == 0);
+  }
+
+  SECTION("hashing") {
+    REQUIRE(db.casefold_hash(std::string("Hello"))
+            == db.casefold_hash(std::string("hELLO")));
+    REQUIRE(db.casefold_hash(std::string(u8"Straße"))
+            == db.casefold_hash(std::string("STRASSE")));
+    REQUIRE(db.casefold_hash(std::u16string(u"Straße"))
+            == db.casefold_hash(std::string("strasse")));
+    REQUIRE(db.casefold_hash(std::u32string(U"Straße"))
+            == db.casefold_hash(std::string("strasse")));
+    REQUIRE(db.casefold_hash(std::string("a"))
+            != db.casefold_hash(std::string("b")));
+  }
+}
+
+TEST_CASE("we can find case closures", "[case-closure]") {
+  database db;
+
+  db.open("ucd/packed/unicode-9.0.0.ucd");
+
+  SECTION("single code points") {
+    REQUIRE(db.case_closure('k') == cpvector({ 'K', 'k', 0x212a }));
+    REQUIRE(db.case_closure(0x212a) == cpvector({ 'K', 'k', 0x212a }));
+    REQUIRE(db.case_closure('S') == cpvector({ 'S', 's', 0x17f }));
+    REQUIRE(db.case_closure(0xdf) == cpvector({ 0xdf, 0x1e9e }));
+    REQUIRE(db.case_closure('1') == cpvector({ '1' }));
+  }
+
+  SECTION("ranges") {
+    cpranges ranges = { { 'a', 'c' } };
+    db.case_closure(ranges);
+    REQUIRE(ranges.size() == 2);
+    REQUIRE(ranges[0].first == codepoint('A'));
+    REQUIRE(ranges[0].last == codepoint('C'));
+    REQUIRE(ranges[1].first == codepoint('a'));
+    REQUIRE(ranges[1].last == codepoint('c'));
+
+    ranges = { { 'A', 'Z' }, { 'a', 'z' } };
+    db.case_closure(ranges);
+    REQUIRE(ranges.size() == 4);
+    REQUIRE(ranges[2].first == codepoint(0x17f));
+    REQUIRE(ranges[3].first == codepoint(0x212a));
+  }
 }
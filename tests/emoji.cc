@@ -17,3 +17,70 @@ TEST_CASE("check that emoji properties work", "[emoji]") {
   REQUIRE(db.emoji_modifier(0x1f3fc) == true);
   REQUIRE(db.emoji_modifier_base(0x261d) == true);
 }
+
+TEST_CASE("we can find emoji sequences", "[emoji-sequences]") {
+  database db;
+
+  db.open("ucd/packed/unicode-9.0.0.ucd");
+
+  SECTION("single emoji") {
+    std::u32string str(U"hi \U0001f600, \u263a and \u263a\ufe0f");
+    emoji_iterator it(db, str);
+
+    REQUIRE(it.next() == 4);
+    REQUIRE(it.start() == 3);
+    REQUIRE(it.type() == emoji_sequence::basic);
+
+    // U+263A defaults to text presentation
+    REQUIRE(it.next() == 14);
+    REQUIRE(it.start() == 12);
+    REQUIRE(it.type() == emoji_sequence::basic);
+    REQUIRE(it.next() == emoji_iterator::npos);
+  }
+
+  SECTION("sequences") {
+    emoji_match m;
+
+    REQUIRE(db.find_emoji(std::u32string(U"a #\ufe0f\u20e3"), 0, m));
+    REQUIRE(m.start == 2);
+    REQUIRE(m.end == 5);
+    REQUIRE(m.type == emoji_sequence::keycap);
+    REQUIRE(m.rgi);
+
+    REQUIRE(db.find_emoji(std::u32string(U"\U0001f1ec\U0001f1e7"), 0, m));
+    REQUIRE(m.end == 2);
+    REQUIRE(m.type == emoji_sequence::flag);
+
+    REQUIRE(db.find_emoji(std::u32string(U"\u261d\U0001f3fb"), 0, m));
+    REQUIRE(m.end == 2);
+    REQUIRE(m.type == emoji_sequence::modifier);
+    REQUIRE(m.rgi);
+
+    REQUIRE(db.find_emoji(std::u32string(U"\U0001f468\u200d\U0001f469"
+                                         U"\u200d\U0001f467\u200d"
+                                         U"\U0001f466"), 0, m));
+    REQUIRE(m.end == 7);
+    REQUIRE(m.type == emoji_sequence::zwj);
+    REQUIRE(m.rgi);
+
+    REQUIRE(db.find_emoji(std::u32string(U"\U0001f3f4\U000e0067\U000e0062"
+                                         U"\U000e0073\U000e0063\U000e0074"
+                                         U"\U000e007f"), 0, m));
+    REQUIRE(m.end == 7);
+    REQUIRE(m.type == emoji_sequence::tag);
+
+    REQUIRE(!db.find_emoji(std::string("No emoji in 123 # here"), 0, m));
+  }
+
+  SECTION("counting emoji in UTF-8") {
+    std::string msg("Good luck \xf0\x9f\x91\x8d\xf0\x9f\x8f\xbd "
+                    "\xf0\x9f\x87\xac\xf0\x9f\x87\xa7!");
+    emoji_iterator it(db, msg);
+    unsigned count = 0;
+
+    while (it.next() != emoji_iterator::npos)
+      ++count;
+
+    REQUIRE(count == 2);
+  }
+}
@@ -1,5 +1,6 @@
 #include "catch.hpp"
 #include <libucd/libucd.h>
+#include <vector>
 
 using namespace ucd;
 
@@ -31,3 +32,69 @@ TEST_CASE("we can get Indic category values", "[indic]") {
             == Indic_Syllabic_Category::Brahmi_Joining_Number);
   }
 }
+
+namespace {
+
+  std::vector<size_t>
+  syllables(const database &db, const text &txt)
+  {
+    std::vector<size_t> result;
+    syllable_iterator it(db, txt);
+    size_t pos;
+
+    while ((pos = it.next()) != syllable_iterator::npos)
+      result.push_back(pos);
+
+    return result;
+  }
+
+}
+
+TEST_CASE("we can split Indic text into syllables", "[indic-syllables]") {
+  database db;
+
+  db.open("ucd/packed/unicode-9.0.0.ucd");
+
+  typedef std::vector<size_t> boundaries;
+
+  SECTION("Devanagari") {
+    // KA, then SSA + VIRAMA + KA + VOWEL SIGN I
+    REQUIRE(syllables(db, std::u32string(U"\u0915\u0937\u094d\u0915\u093f"))
+            == boundaries({1, 5}));
+
+    // HI, NDI
+    REQUIRE(syllables(db, std::u32string(U"\u0939\u093f"
+                                         U"\u0928\u094d\u0926\u0940"))
+            == boundaries({2, 6}));
+
+    // KA + NUKTA + VOWEL SIGN AA + CANDRABINDU, then KA
+    REQUIRE(syllables(db, std::u32string(U"\u0915\u093c\u093e\u0901\u0915"))
+            == boundaries({4, 5}));
+
+    // An explicit virama, with ZWNJ, ends the syllable
+    REQUIRE(syllables(db, std::u32string(U"\u0915\u094d\u200c\u0937"))
+            == boundaries({3, 4}));
+
+    // A half form, with ZWJ, doesn't
+    REQUIRE(syllables(db, std::u32string(U"\u0915\u094d\u200d\u0937"))
+            == boundaries({4}));
+  }
+
+  SECTION("other scripts") {
+    REQUIRE(syllables(db, std::string("ab")) == boundaries({1, 2}));
+    REQUIRE(syllables(db, std::u32string(U"e\u0301\u0915"))
+            == boundaries({2, 3}));
+    REQUIRE(syllables(db, std::u32string(U"\u0915a\u0301"))
+            == boundaries({1, 3}));
+  }
+
+  SECTION("broken syllables") {
+    // A vowel sign with nothing to attach to
+    REQUIRE(syllables(db, std::u32string(U"\u093f\u0915"))
+            == boundaries({1, 2}));
+
+    // A virama can't follow a vowel sign
+    REQUIRE(syllables(db, std::u32string(U"\u0915\u093f\u094d"))
+            == boundaries({2, 3}));
+  }
+}
@@ -1,5 +1,6 @@
 #include "catch.hpp"
 #include <libucd/libucd.h>
+#include <vector>
 
 using namespace ucd;
 
@@ -31,3 +32,49 @@ TEST_CASE("we can get joining related values", "[joining]") {
   REQUIRE(db.joining_type(0xa872, group) == Joining_Type::Left_Joining);
   REQUIRE(group == Joining_Group::No_Joining_Group);
 }
+
+namespace {
+
+  std::vector<joining_form>
+  forms_of(const database &db, const std::u32string &str)
+  {
+    std::vector<joining_form> result(str.size());
+    joining_forms(db, (const codepoint *)str.data(), str.size(),
+                  result.data());
+    return result;
+  }
+
+}
+
+TEST_CASE("we can work out cursive joining forms", "[joining-forms]") {
+  database db;
+
+  db.open("ucd/packed/unicode-9.0.0.ucd");
+
+  typedef std::vector<joining_form> forms;
+  const joining_form none = joining_form::none;
+  const joining_form isol = joining_form::isolated;
+  const joining_form init = joining_form::initial;
+  const joining_form medi = joining_form::medial;
+  const joining_form fina = joining_form::final;
+
+  SECTION("dual and right joining letters") {
+    REQUIRE(forms_of(db, U"\u0628\u064a\u062a") == forms({init, medi, fina}));
+    REQUIRE(forms_of(db, U"\u062f\u0627\u0631") == forms({isol, isol, isol}));
+    REQUIRE(forms_of(db, U"\u0628\u062f\u0628") == forms({init, fina, isol}));
+    REQUIRE(forms_of(db, U"\u0628") == forms({isol}));
+  }
+
+  SECTION("transparent and non-joining characters") {
+    REQUIRE(forms_of(db, U"\u0628\u064e\u0628") == forms({init, none, fina}));
+    REQUIRE(forms_of(db, U"\u0628a\u0628") == forms({isol, none, isol}));
+    REQUIRE(forms_of(db, U"\u064e\u0628") == forms({none, isol}));
+  }
+
+  SECTION("join causing characters") {
+    REQUIRE(forms_of(db, U"\u0628\u200d") == forms({init, none}));
+    REQUIRE(forms_of(db, U"\u200d\u0628") == forms({none, fina}));
+    REQUIRE(forms_of(db, U"\u0628\u200c\u0628") == forms({isol, none, isol}));
+    REQUIRE(forms_of(db, U"\u0628\u0640\u0628") == forms({init, none, fina}));
+  }
+}
@@ -0,0 +1,81 @@
+#include "catch.hpp"
+#include <libucd/libucd.h>
+#include <vector>
+
+using namespace ucd;
+
+namespace {
+
+  // Returns the breaks, with mandatory breaks negated
+  std::vector<long>
+  line_breaks(const database &db, const text &txt, bool east_asian = false)
+  {
+    line_break_iterator it(db, txt, east_asian);
+    std::vector<long> result;
+    size_t pos;
+
+    while ((pos = it.next()) != line_break_iterator::npos)
+      result.push_back(it.is_mandatory() ? -long(pos) : long(pos));
+
+    return result;
+  }
+
+}
+
+TEST_CASE("we can find line break opportunities", "[linebreak]") {
+  database db;
+
+  db.open("ucd/packed/unicode-9.0.0.ucd");
+
+  typedef std::vector<long> breaks;
+
+  SECTION("spaces and hard breaks") {
+    REQUIRE(line_breaks(db, std::string("")) == breaks());
+    REQUIRE(line_breaks(db, std::string("Hello world")) == breaks({6, 11}));
+    REQUIRE(line_breaks(db, std::string("a  b")) == breaks({3, 4}));
+    REQUIRE(line_breaks(db, std::string("a\nb")) == breaks({-2, 3}));
+    REQUIRE(line_breaks(db, std::string("a\r\nb")) == breaks({-3, 4}));
+    REQUIRE(line_breaks(db, std::string("a\n")) == breaks({-2}));
+    REQUIRE(line_breaks(db, std::u16string(u"ab cd")) == breaks({3, 5}));
+  }
+
+  SECTION("punctuation and numbers") {
+    REQUIRE(line_breaks(db, std::string("foo-bar")) == breaks({4, 7}));
+    REQUIRE(line_breaks(db, std::string("$100 (approx.)")) == breaks({5, 14}));
+    REQUIRE(line_breaks(db, std::string("3.14")) == breaks({4}));
+    REQUIRE(line_breaks(db, std::string("\"a\" b")) == breaks({4, 5}));
+  }
+
+  SECTION("glue and zero width characters") {
+    REQUIRE(line_breaks(db, std::string("a\xe2\x81\xa0" "b")) == breaks({5}));
+    REQUIRE(line_breaks(db, std::string("a\xc2\xa0" "b")) == breaks({4}));
+    REQUIRE(line_breaks(db, std::string("a\xe2\x80\x8b" "b"))
+            == breaks({4, 5}));
+  }
+
+  SECTION("combining marks") {
+    REQUIRE(line_breaks(db, std::string("a\xcc\x81 b")) == breaks({4, 5}));
+    REQUIRE(line_breaks(db, std::u32string(U"\u05d0-\u05d1"))
+            == breaks({3}));
+  }
+
+  SECTION("ideographs and emoji") {
+    REQUIRE(line_breaks(db, std::u32string(U"\u4e00\u4e01\u3001\u4e02"))
+            == breaks({1, 3, 4}));
+    REQUIRE(line_breaks(db, std::u32string(U"\u4e00\u200d\u4e01"))
+            == breaks({3}));
+    REQUIRE(line_breaks(db, std::u32string(U"\U0001f44d\U0001f3fb"))
+            == breaks({2}));
+    REQUIRE(line_breaks(db, std::u32string(U"\U0001f1e6\U0001f1e7"
+                                           U"\U0001f1e8\U0001f1e9"))
+            == breaks({2, 4}));
+  }
+
+  SECTION("fallbacks") {
+    REQUIRE(line_breaks(db, std::u32string(U"\u2460\u2460")) == breaks({2}));
+    REQUIRE(line_breaks(db, std::u32string(U"\u2460\u2460"), true)
+            == breaks({1, 2}));
+    REQUIRE(line_breaks(db, std::u32string(U"\u0e01\u0e31\u0e02"))
+            == breaks({3}));
+  }
+}
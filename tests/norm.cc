@@ -26,3 +26,30 @@ TEST_CASE("we can examine NFC_Quick_Check et al", "[quick-check]") {
   REQUIRE(db.nfkd_quick_check(0xaa) == maybe::no);
   REQUIRE(db.nfkd_quick_check(0x1f131) == maybe::no);
 }
+
+TEST_CASE("we can compute confusable skeletons", "[skeleton]") {
+  database db;
+
+  db.open("ucd/packed/unicode-9.0.0.ucd");
+
+  SECTION("strings") {
+    std::string paypal = db.skeleton(std::string("paypal"));
+
+    REQUIRE(db.skeleton(std::string("p\xd0\xb0yp\xd0\xb0l")) == paypal);
+    REQUIRE(db.skeleton(std::string("paypa1")) == paypal);
+    REQUIRE(db.skeleton(std::string("paypal.")) != paypal);
+    REQUIRE(db.skeleton(std::string("rn")) == db.skeleton(std::string("m")));
+    REQUIRE(db.skeleton(std::u16string(u"\u212b"))
+            == db.skeleton(std::u16string(u"A\u030a")));
+    REQUIRE(db.skeleton(std::u32string(U"\u03bf\u0440"))
+            == db.skeleton(std::u32string(U"op")));
+  }
+
+  SECTION("buffers") {
+    char buf[2];
+    std::string mmm = db.skeleton(std::string("mmm"));
+
+    REQUIRE(db.skeleton("mmm", 3, buf, sizeof(buf)) == mmm.size());
+    REQUIRE(std::string(buf, sizeof(buf)) == mmm.substr(0, sizeof(buf)));
+  }
+}
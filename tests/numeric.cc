@@ -9,6 +9,7 @@ TEST_CASE("the numeric type works", "[numeric]") {
   REQUIRE(int(numeric(1, 10, 0)) == 1);
   REQUIRE(int(numeric(-1, 10, 0)) == -1);
   REQUIRE(double(numeric(3, 16, -1)) == 3.0 / 16.0);
+  REQUIRE(double(numeric(1, 10, 8)) == 1.0e8);
   REQUIRE(double(numeric(1, 10, 12)) == 1.0e12);
   REQUIRE(NaN.to_string() == "NaN");
   REQUIRE(infinity.to_string() == "infinity");
@@ -19,6 +20,12 @@ TEST_CASE("the numeric type works", "[numeric]") {
   REQUIRE((-numeric(3, 16, -1)).to_string() == "-3/16");
   REQUIRE(-infinity != infinity);
   REQUIRE(-(-infinity) == infinity);
+  REQUIRE(NaN.to_rational().isnan());
+  REQUIRE(numeric(6, 16, -1).to_rational() == rational(3, 8));
+  REQUIRE(numeric(-1, 2, -1).to_rational() == rational(-1, 2));
+  REQUIRE(numeric(1, 10, 8).to_rational() == rational(100000000));
+  REQUIRE(numeric(1, 10, 12).to_rational() == rational(1000000000000ll));
+  REQUIRE(double(rational(1, 4)) == 0.25);
 }
 
 TEST_CASE("we can look up numeric types and values", "[numb]") {
@@ -38,3 +45,71 @@ TEST_CASE("we can look up numeric types and values", "[numb]") {
   REQUIRE(int(db.numeric_value(0x842c)) == 10000);
   REQUIRE(db.numeric_value(0x5146).to_string() == "1000000000000");
 }
+
+TEST_CASE("we can get precomputed numeric values", "[numeric-values]") {
+  database db;
+
+  db.open("ucd/packed/unicode-9.0.0.ucd");
+
+  REQUIRE(std::isnan(db.numeric_value_double('a')));
+  REQUIRE(db.numeric_value_double('3') == 3.0);
+  REQUIRE(db.numeric_value_double(0xbc) == 0.25);
+  REQUIRE(db.numeric_value_double(0x2153) == 1.0 / 3.0);
+  REQUIRE(db.numeric_value_double(0x0f33) == -0.5);
+  REQUIRE(db.numeric_value_double(0x5104) == 1.0e8);
+  REQUIRE(db.numeric_value_double(0x5146) == 1.0e12);
+
+  REQUIRE(db.numeric_value_rational('a').isnan());
+  REQUIRE(db.numeric_value_rational('3') == rational(3));
+  REQUIRE(db.numeric_value_rational(0xbc) == rational(1, 4));
+  REQUIRE(db.numeric_value_rational(0x0f33) == rational(-1, 2));
+  REQUIRE(db.numeric_value_rational(0x842c) == rational(10000));
+  REQUIRE(db.numeric_value_rational(0x5104) == rational(100000000));
+  REQUIRE(db.numeric_value_rational(0x5146) == rational(1000000000000ll));
+}
+
+TEST_CASE("we can read decimal digits in any script", "[digits]") {
+  database db;
+
+  db.open("ucd/packed/unicode-9.0.0.ucd");
+
+  SECTION("digit values") {
+    codepoint zero;
+
+    REQUIRE(db.digit_value('7') == 7);
+    REQUIRE(db.digit_value('a') == -1);
+    REQUIRE(db.digit_value(0x0966) == 0);
+    REQUIRE(db.digit_value(0x096f, zero) == 9);
+    REQUIRE(zero == codepoint(0x0966));
+    REQUIRE(db.digit_value(0xff13) == 3);
+    REQUIRE(db.digit_value(0x1d7ce) == 0);
+
+    // Numeric_Type=Digit and Numeric aren't decimal digits
+    REQUIRE(db.digit_value(0xb9) == -1);
+    REQUIRE(db.digit_value(0xbc) == -1);
+  }
+
+  SECTION("parsing") {
+    long long value;
+
+    REQUIRE(db.parse_decimal(std::string("12345"), value));
+    REQUIRE(value == 12345);
+    REQUIRE(db.parse_decimal(std::string("-0000000000000000000042"), value));
+    REQUIRE(value == -42);
+    REQUIRE(db.parse_decimal(std::string("9223372036854775807"), value));
+    REQUIRE(value == 9223372036854775807ll);
+    REQUIRE(db.parse_decimal(std::string("-9223372036854775808"), value));
+    REQUIRE(value == -9223372036854775807ll - 1);
+    REQUIRE(db.parse_decimal(std::u32string(U"\u0967\u0968\u0969"), value));
+    REQUIRE(value == 123);
+    REQUIRE(db.parse_decimal(std::u16string(u"+\uff14\uff12"), value));
+    REQUIRE(value == 42);
+
+    REQUIRE(!db.parse_decimal(std::string(""), value));
+    REQUIRE(!db.parse_decimal(std::string("-"), value));
+    REQUIRE(!db.parse_decimal(std::string("12a"), value));
+    REQUIRE(!db.parse_decimal(std::string("9223372036854775808"), value));
+    REQUIRE(!db.parse_decimal(std::u32string(U"1\u0968"), value));
+    REQUIRE(!db.parse_decimal(std::u32string(U"\u0967\u09e8"), value));
+  }
+}
@@ -1,5 +1,7 @@
 #include "catch.hpp"
 #include <libucd/libucd.h>
+#include <algorithm>
+#include <vector>
 
 using namespace ucd;
 
@@ -20,3 +22,55 @@ TEST_CASE("we can get Unicode_Radical_Stroke values", "[rads]") {
   REQUIRE(db.unicode_radical_stroke(0x8002)
           == stroke_count(125, stroke_count::traditional, -2));
 }
+
+TEST_CASE("we can find characters by radical and stroke count", "[rsix]") {
+  database db;
+
+  db.open("ucd/packed/unicode-9.0.0.ucd");
+
+  SECTION("the inverted index") {
+    stroke_count rs(36, stroke_count::traditional, 2);
+    std::vector<codepoint> cps = db.characters_with_radical_stroke(rs);
+
+    REQUIRE(std::find(cps.begin(), cps.end(), 0x3688) != cps.end());
+    REQUIRE(std::is_sorted(cps.begin(), cps.end()));
+    for (codepoint cp : cps)
+      REQUIRE(db.unicode_radical_stroke(cp) == rs);
+
+    const codepoint *pcps;
+    REQUIRE(db.characters_with_radical_stroke(rs, pcps) == cps.size());
+    REQUIRE(std::equal(cps.begin(), cps.end(), pcps));
+
+    rs = stroke_count(120, stroke_count::simplified, 3);
+    cps = db.characters_with_radical_stroke(rs);
+    REQUIRE(std::find(cps.begin(), cps.end(), 0x4336) != cps.end());
+
+    rs = stroke_count(61, stroke_count::traditional, -1);
+    cps = db.characters_with_radical_stroke(rs);
+    REQUIRE(std::find(cps.begin(), cps.end(), 0x225a9) != cps.end());
+
+    REQUIRE(db.characters_with_radical_stroke(stroke_count::none).empty());
+  }
+
+  SECTION("sort keys") {
+    // Radical first, then simplified, then residual strokes
+    REQUIRE(db.radical_stroke_sort_key(0x3688)
+            < db.radical_stroke_sort_key(0x225a9));
+    REQUIRE(db.radical_stroke_sort_key(0x225a9)
+            < db.radical_stroke_sort_key(0x5fc3));
+    REQUIRE(db.radical_stroke_sort_key(0x7cf8)
+            < db.radical_stroke_sort_key(0x4336));
+    REQUIRE(db.radical_stroke_sort_key(0x4336)
+            < db.radical_stroke_sort_key(0x8c60));
+
+    // Then code point
+    REQUIRE(db.radical_stroke_sort_key(0x3688)
+            < db.radical_stroke_sort_key(0x5916));
+
+    // Non-Han characters come last
+    REQUIRE(db.radical_stroke_sort_key(0x8c60)
+            < db.radical_stroke_sort_key('A'));
+    REQUIRE(db.radical_stroke_sort_key('A')
+            < db.radical_stroke_sort_key('B'));
+  }
+}
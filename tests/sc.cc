@@ -1,5 +1,6 @@
 #include "catch.hpp"
 #include <libucd/libucd.h>
+#include <vector>
 
 using namespace ucd;
 
@@ -105,4 +106,161 @@ TEST_CASE("we can get Script_Extensions information", "[sext]") {
         && result[14] == Script::Telu
         && result[15] == Script::Tirh);
   REQUIRE(ok);
+
+  const sc *scripts;
+
+  REQUIRE(db.script_extensions('A', scripts) == 0);
+  REQUIRE(db.script_extensions(0x303c, scripts) == 3);
+  ok = (scripts[0] == Script::Hani
+        && scripts[1] == Script::Hira
+        && scripts[2] == Script::Kana);
+  REQUIRE(ok);
+}
+
+TEST_CASE("we can use script sets", "[script-set]") {
+  database db;
+
+  db.open("ucd/packed/unicode-9.0.0.ucd");
+
+  REQUIRE(script_set::index(Script::Adlm) == 0);
+  REQUIRE(script_set::script(script_set::index(Script::Latn)) == Script::Latn);
+  REQUIRE(script_set::index('Four') == script_set::npos);
+  REQUIRE(script_set::index(Script::Latn) == Script_Index::Latn);
+
+  // Every script in script_list.h has an index, and they're all different
+  const sc all[] = {
+#define UCD_SCRIPT(code) Script::code,
+#include <libucd/script_list.h>
+  };
+  bool ok = true;
+  for (unsigned n = 0; n < Script_Index::count; ++n) {
+    if (script_set::index(all[n]) != n || script_set::script(n) != all[n])
+      ok = false;
+  }
+  REQUIRE(ok);
+
+  script_set latin(Script::Latin), greek(Script::Greek);
+  REQUIRE(latin.contains(Script::Latin));
+  REQUIRE(!latin.contains(Script::Greek));
+  REQUIRE(latin.size() == 1);
+  REQUIRE((latin & greek).empty());
+  REQUIRE((latin | greek).size() == 2);
+  REQUIRE((latin | greek).first() == Script::Greek);
+
+  script_set other;
+  REQUIRE(!other.insert('Four'));
+  REQUIRE(other.empty());
+
+  script_set danda = db.script_extension_set(0x964);
+  REQUIRE(danda.size() == 16);
+  REQUIRE(danda.contains(Script::Deva));
+  REQUIRE(danda.contains(Script::Beng));
+  REQUIRE(!danda.contains(Script::Latn));
+  REQUIRE((danda & db.script_extension_set(0x0915))
+          == script_set(Script::Deva));
+
+  // Without Script_Extensions, we get the Script
+  REQUIRE(db.script_extension_set('A') == latin);
+  REQUIRE(db.script_extension_set('1') == script_set(Script::Common));
+  REQUIRE(db.script_extension_set(0x10ffff) == script_set(Script::Unknown));
+}
+
+namespace {
+
+  struct script_run {
+    size_t end;
+    sc     script;
+
+    bool operator==(const script_run &other) const {
+      return end == other.end && script == other.script;
+    }
+  };
+
+  std::vector<script_run>
+  script_runs(const database &db, const text &txt)
+  {
+    std::vector<script_run> result;
+    script_iterator it(db, txt);
+    size_t end;
+
+    while ((end = it.next()) != script_iterator::npos)
+      result.push_back({ end, it.script() });
+
+    return result;
+  }
+
+}
+
+TEST_CASE("we can split text into script runs", "[script-runs]") {
+  database db;
+
+  db.open("ucd/packed/unicode-9.0.0.ucd");
+
+  typedef std::vector<script_run> runs;
+
+  SECTION("simple runs") {
+    REQUIRE(script_runs(db, std::string("")) == runs());
+    REQUIRE(script_runs(db, std::string("Hello, world"))
+            == runs({{ 12, Script::Latin }}));
+    REQUIRE(script_runs(db, std::string("1, 2, 3"))
+            == runs({{ 7, Script::Common }}));
+    REQUIRE(script_runs(db, std::u32string(U"abc \u03b1\u03b2\u03b3"))
+            == runs({{ 4, Script::Latin }, { 7, Script::Greek }}));
+  }
+
+  SECTION("Common and Inherited characters") {
+    REQUIRE(script_runs(db, std::u32string(U"e\u0301 \u03b1\u0301"))
+            == runs({{ 3, Script::Latin }, { 5, Script::Greek }}));
+    REQUIRE(script_runs(db, std::u32string(U"12 \u03b1"))
+            == runs({{ 4, Script::Greek }}));
+  }
+
+  SECTION("Script_Extensions") {
+    REQUIRE(script_runs(db, std::u32string(U"\u0915\u0964"))
+            == runs({{ 2, Script::Devanagari }}));
+    REQUIRE(script_runs(db, std::u32string(U"\u0995\u0964"))
+            == runs({{ 2, Script::Bengali }}));
+    REQUIRE(script_runs(db, std::u32string(U"\u303c\u30a2"))
+            == runs({{ 2, Script::Katakana }}));
+    REQUIRE(script_runs(db, std::u32string(U"\u0915\u303c"))
+            == runs({{ 1, Script::Devanagari }, { 2, Script::Han }}));
+  }
+
+  SECTION("brackets") {
+    REQUIRE(script_runs(db, std::u32string(U"\u03b1\u03b2 (abc) \u03b3"))
+            == runs({{ 4, Script::Greek }, { 7, Script::Latin },
+                     { 10, Script::Greek }}));
+    REQUIRE(script_runs(db, std::u32string(U"(\u03b1) abc"))
+            == runs({{ 4, Script::Greek }, { 7, Script::Latin }}));
+  }
+}
+
+TEST_CASE("we can find the restriction level of text", "[restriction]") {
+  database db;
+
+  db.open("ucd/packed/unicode-9.0.0.ucd");
+
+  std::string s;
+  std::u32string u;
+
+  REQUIRE(db.restriction_level(text(s = ""))
+          == restriction_level::ascii_only);
+  REQUIRE(db.restriction_level(text(s = "john.doe-42"))
+          == restriction_level::ascii_only);
+  REQUIRE(db.restriction_level(text(s = "caf\xc3\xa9"))
+          == restriction_level::single_script);
+  REQUIRE(db.restriction_level(text(u = U"\u03b1\u03b2\u03b3 123"))
+          == restriction_level::single_script);
+  REQUIRE(db.restriction_level(text(u = U"\u65e5\u672c\u3072\u30ab\u30fc"))
+          == restriction_level::single_script);
+  REQUIRE(db.restriction_level(text(u = U"abc\u65e5\u3072"))
+          == restriction_level::highly_restrictive);
+  REQUIRE(db.restriction_level(text(u = U"abc\uac00\u65e5"))
+          == restriction_level::highly_restrictive);
+  REQUIRE(db.restriction_level(text(u = U"abc\u0627\u0628"))
+          == restriction_level::moderately_restrictive);
+  REQUIRE(db.restriction_level(text(u = U"p\u0430yp\u0430l"))
+          == restriction_level::minimally_restrictive);
+  REQUIRE(db.restriction_level(text(u = U"\u3072\uac00"))
+          == restriction_level::minimally_restrictive);
 }
@@ -0,0 +1,270 @@
+#include "catch.hpp"
+#include <libucd/libucd.h>
+#include <algorithm>
+#include <vector>
+
+using namespace ucd;
+
+namespace {
+
+  std::vector<size_t>
+  graphemes(const database &db, const text &txt)
+  {
+    grapheme_iterator it(db, txt);
+    std::vector<size_t> result;
+    size_t pos;
+
+    while ((pos = it.next()) != grapheme_iterator::npos)
+      result.push_back(pos);
+
+    return result;
+  }
+
+}
+
+TEST_CASE("we can find grapheme cluster boundaries", "[grapheme]") {
+  database db;
+
+  db.open("ucd/packed/unicode-9.0.0.ucd");
+
+  typedef std::vector<size_t> breaks;
+
+  SECTION("ASCII") {
+    REQUIRE(graphemes(db, std::string("")) == breaks());
+    REQUIRE(graphemes(db, std::string("abc")) == breaks({1, 2, 3}));
+    REQUIRE(graphemes(db, std::string("a\r\nb\n\r")) == breaks({1, 3, 4, 5, 6}));
+  }
+
+  SECTION("combining marks") {
+    REQUIRE(graphemes(db, std::string("e\xcc\x81x")) == breaks({3, 4}));
+    REQUIRE(graphemes(db, std::u16string(u"e\u0323\u0301x")) == breaks({3, 4}));
+    REQUIRE(graphemes(db, std::string("\n\xcc\x81")) == breaks({1, 3}));
+    REQUIRE(graphemes(db, std::u32string(U"\u0915\u093f")) == breaks({2}));
+  }
+
+  SECTION("Hangul syllables") {
+    REQUIRE(graphemes(db, std::u32string(U"\uac01\u11a8\u1100"))
+            == breaks({2, 3}));
+    REQUIRE(graphemes(db, std::u32string(U"\uac00\u11a8\u1100\u1161"))
+            == breaks({2, 4}));
+  }
+
+  SECTION("regional indicators") {
+    REQUIRE(graphemes(db, std::u32string(U"\U0001f1ec\U0001f1e7\U0001f1eb"
+                                         U"\U0001f1f7\U0001f1e9"))
+            == breaks({2, 4, 5}));
+    REQUIRE(graphemes(db, std::u16string(u"\U0001f1ec\U0001f1e7\U0001f1eb"))
+            == breaks({4, 6}));
+  }
+
+  SECTION("emoji modifiers and ZWJ sequences") {
+    REQUIRE(graphemes(db, std::u32string(U"\U0001f466\U0001f3fb\U0001f3fb"))
+            == breaks({2, 3}));
+    REQUIRE(graphemes(db, std::u32string(U"\U0001f44d\u0301\U0001f3fd!"))
+            == breaks({3, 4}));
+    REQUIRE(graphemes(db, std::u32string(U"\U0001f469\u200d\u2764\ufe0f"
+                                         U"\u200d\U0001f468"))
+            == breaks({6}));
+  }
+
+  SECTION("resuming") {
+    std::string str("ab\xcc\x81" "c");
+    grapheme_iterator it(db, str);
+
+    it.reset(1);
+    REQUIRE(it.next() == 4);
+    REQUIRE(it.position() == 4);
+    REQUIRE(it.next() == 5);
+    REQUIRE(it.next() == grapheme_iterator::npos);
+  }
+}
+
+namespace {
+
+  std::vector<size_t>
+  words(const database &db, const text &txt,
+        word_iterator::mode m = word_iterator::mode::all)
+  {
+    word_iterator it(db, txt, m);
+    std::vector<size_t> result;
+    size_t pos;
+
+    while ((pos = it.next()) != word_iterator::npos)
+      result.push_back(pos);
+
+    return result;
+  }
+
+  std::vector<size_t>
+  words_chunked(const database &db, const std::string &str, size_t chunk)
+  {
+    word_iterator it(db);
+    std::vector<size_t> result;
+    size_t pos, offset = 0;
+
+    do {
+      size_t len = std::min(chunk, str.size() - offset);
+
+      it.feed(text(str.data() + offset, len), offset + len == str.size());
+      offset += len;
+
+      while ((pos = it.next()) != word_iterator::npos)
+        result.push_back(pos);
+    } while (offset < str.size());
+
+    return result;
+  }
+
+}
+
+TEST_CASE("we can find word boundaries", "[word]") {
+  database db;
+
+  db.open("ucd/packed/unicode-9.0.0.ucd");
+
+  typedef std::vector<size_t> breaks;
+
+  SECTION("simple text") {
+    REQUIRE(words(db, std::string("")) == breaks());
+    REQUIRE(words(db, std::string("The (\"quick\") fox can't jump 32.3 feet."))
+            == breaks({3, 4, 5, 6, 11, 12, 13, 14, 17, 18, 23, 24, 28,
+                       29, 33, 34, 38, 39}));
+    REQUIRE(words(db, std::string("a\r\n\nb")) == breaks({1, 3, 4, 5}));
+    REQUIRE(words(db, std::string("foo_bar1 __")) == breaks({8, 9, 11}));
+  }
+
+  SECTION("lookahead") {
+    REQUIRE(words(db, std::string("a'")) == breaks({1, 2}));
+    REQUIRE(words(db, std::string("a' b")) == breaks({1, 2, 3, 4}));
+    REQUIRE(words(db, std::string("e.g.")) == breaks({3, 4}));
+    REQUIRE(words(db, std::string("3,4.5")) == breaks({5}));
+    REQUIRE(words(db, std::string("3,,4")) == breaks({1, 2, 3, 4}));
+    REQUIRE(words(db, std::string("a\xcc\x81'\xcc\x81" "b")) == breaks({7}));
+    REQUIRE(words(db, std::string("a\xcc\x81'\xcc\x81 ")) == breaks({3, 6, 7}));
+    REQUIRE(words(db, std::u32string(U"\u05d0'\u05d1\"\u05d2\"x"))
+            == breaks({5, 6, 7}));
+  }
+
+  SECTION("emoji and regional indicators") {
+    REQUIRE(words(db, std::u32string(U"\U0001f1ec\U0001f1e7\U0001f1eb"))
+            == breaks({2, 3}));
+    REQUIRE(words(db, std::u32string(U"\U0001f44d\U0001f3fd!"))
+            == breaks({2, 3}));
+    REQUIRE(words(db, std::u32string(U"!\u200d\u2764?")) == breaks({3, 4}));
+  }
+
+  SECTION("katakana and ideographs") {
+    REQUIRE(words(db, std::u32string(U"\u30a2\u30a4_\u4e00\u4e01"))
+            == breaks({3, 4, 5}));
+  }
+
+  SECTION("words only") {
+    std::u32string str(U"Hello, \u4e16\u754c! 3.14");
+    word_iterator it(db, str, word_iterator::mode::words_only);
+
+    REQUIRE(it.next() == 5);
+    REQUIRE(it.start() == 0);
+    REQUIRE(it.is_word());
+    REQUIRE(it.next() == 8);
+    REQUIRE(it.start() == 7);
+    REQUIRE(it.next() == 9);
+    REQUIRE(it.start() == 8);
+    REQUIRE(it.next() == 15);
+    REQUIRE(it.start() == 11);
+    REQUIRE(it.next() == word_iterator::npos);
+  }
+
+  SECTION("chunked input") {
+    std::string str("The (\"quick\") fox can't jump 32.3 feet, "
+                    "\xc3\xa9t\xc3\xa9 a\xcc\x81'\xcc\x81" "b \xe2\x80");
+
+    breaks expected = words(db, str);
+
+    for (size_t chunk = 1; chunk < 8; ++chunk)
+      REQUIRE(words_chunked(db, str, chunk) == expected);
+  }
+}
+
+namespace {
+
+  std::vector<size_t>
+  sentences(const database &db, const text &txt)
+  {
+    sentence_iterator it(db, txt);
+    std::vector<size_t> result;
+    size_t pos;
+
+    while ((pos = it.next()) != sentence_iterator::npos)
+      result.push_back(pos);
+
+    return result;
+  }
+
+  std::vector<size_t>
+  sentences_chunked(const database &db, const std::string &str, size_t chunk)
+  {
+    sentence_iterator it(db);
+    std::vector<size_t> result;
+    size_t pos, offset = 0;
+
+    do {
+      size_t len = std::min(chunk, str.size() - offset);
+
+      it.feed(text(str.data() + offset, len), offset + len == str.size());
+      offset += len;
+
+      while ((pos = it.next()) != sentence_iterator::npos)
+        result.push_back(pos);
+    } while (offset < str.size());
+
+    return result;
+  }
+
+}
+
+TEST_CASE("we can find sentence boundaries", "[sentence]") {
+  database db;
+
+  db.open("ucd/packed/unicode-9.0.0.ucd");
+
+  typedef std::vector<size_t> breaks;
+
+  SECTION("simple text") {
+    REQUIRE(sentences(db, std::string("")) == breaks());
+    REQUIRE(sentences(db, std::string("Hello. How are you? Fine!"))
+            == breaks({7, 20, 25}));
+    REQUIRE(sentences(db, std::string("One\r\nTwo\nThree"))
+            == breaks({5, 9, 14}));
+    REQUIRE(sentences(db, std::string("He said \"Stop.\" Then left."))
+            == breaks({16, 26}));
+  }
+
+  SECTION("abbreviations and numbers") {
+    REQUIRE(sentences(db, std::string("Pi is 3.14 or so.")) == breaks({17}));
+    REQUIRE(sentences(db, std::string("See U.S.A. for details."))
+            == breaks({23}));
+    REQUIRE(sentences(db, std::string("etc., and so on.")) == breaks({16}));
+    REQUIRE(sentences(db, std::string("Wow?! Really.")) == breaks({6, 13}));
+  }
+
+  SECTION("SB8 lookahead") {
+    REQUIRE(sentences(db, std::string("Mr. (\"smith\") is here."))
+            == breaks({22}));
+    REQUIRE(sentences(db, std::string("e.g. 42 people")) == breaks({14}));
+    REQUIRE(sentences(db, std::string("End. 42 People")) == breaks({5, 14}));
+    REQUIRE(sentences(db, std::string("End. (42")) == breaks({5, 8}));
+    REQUIRE(sentences(db, std::u16string(u"Ende. \u00bb42 \u00fcber"))
+            == breaks({14}));
+  }
+
+  SECTION("chunked input") {
+    std::string str("Mr. Smith went to Washington. He said \"hi.\" (Then "
+                    "a pause...) and 3.14 \xc3\xa9t\xc3\xa9! "
+                    + std::string(1000, ' ') + "x");
+
+    breaks expected = sentences(db, str);
+
+    for (size_t chunk = 1; chunk < 8; ++chunk)
+      REQUIRE(sentences_chunked(db, str, chunk) == expected);
+  }
+}
@@ -0,0 +1,60 @@
+#include "catch.hpp"
+#include <libucd/libucd.h>
+
+using namespace ucd;
+
+TEST_CASE("we can find the display width of a code point", "[width]") {
+  database db;
+
+  db.open("ucd/packed/unicode-9.0.0.ucd");
+
+  REQUIRE(db.display_width('A') == 1);
+  REQUIRE(db.display_width('\t') == 0);
+  REQUIRE(db.display_width(0x0301) == 0);
+  REQUIRE(db.display_width(0x200b) == 0);
+  REQUIRE(db.display_width(0x4e00) == 2);
+  REQUIRE(db.display_width(0x1100) == 2);
+  REQUIRE(db.display_width(0x1161) == 0);
+  REQUIRE(db.display_width(0x1f44d) == 2);
+  REQUIRE(db.display_width(0x2460) == 1);
+  REQUIRE(db.display_width(0x2460, true) == 2);
+}
+
+TEST_CASE("we can find the display width of a string", "[width]") {
+  database db;
+
+  db.open("ucd/packed/unicode-9.0.0.ucd");
+
+  SECTION("ASCII") {
+    REQUIRE(db.display_width(std::string("")) == 0);
+    REQUIRE(db.display_width(std::string("Hello, world")) == 12);
+    REQUIRE(db.display_width(std::string("a\tb\r\n")) == 2);
+    REQUIRE(db.display_width(std::string("The quick brown fox jumps over "
+                                         "the lazy dog")) == 43);
+  }
+
+  SECTION("combining marks and Hangul") {
+    REQUIRE(db.display_width(std::string("e\xcc\x81")) == 1);
+    REQUIRE(db.display_width(std::string("cafe\xcc\x81 au lait")) == 12);
+    REQUIRE(db.display_width(std::u32string(U"\u1100\u1161\u11a8")) == 2);
+  }
+
+  SECTION("wide characters") {
+    REQUIRE(db.display_width(std::string("abc\xe4\xb8\x80" "def")) == 8);
+    REQUIRE(db.display_width(std::u16string(u"ab\u4e00\u4e01")) == 6);
+    REQUIRE(db.display_width(std::u32string(U"\u2460\u2460")) == 2);
+    REQUIRE(db.display_width(std::u32string(U"\u2460\u2460"), true) == 4);
+  }
+
+  SECTION("emoji") {
+    REQUIRE(db.display_width(std::u32string(U"\U0001f44d\U0001f3fb")) == 2);
+    REQUIRE(db.display_width(std::u32string(U"\U0001f1e6\U0001f1e7"
+                                            U"\U0001f1e8")) == 4);
+    REQUIRE(db.display_width(std::u32string(U"\U0001f44d\u200d\u2764"))
+            == 2);
+    REQUIRE(db.display_width(std::u32string(U"#\ufe0f\u20e3")) == 2);
+    REQUIRE(db.display_width(std::u32string(U"\u2764")) == 1);
+    REQUIRE(db.display_width(std::u32string(U"\u2764\ufe0f")) == 2);
+    REQUIRE(db.display_width(std::u32string(U"\U0001f44d\ufe0e")) == 1);
+  }
+}
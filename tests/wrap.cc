@@ -0,0 +1,71 @@
+#include "catch.hpp"
+#include <libucd/libucd.h>
+
+using namespace ucd;
+
+TEST_CASE("we can wrap text to a given width", "[wrap]") {
+  database db;
+
+  db.open("ucd/packed/unicode-9.0.0.ucd");
+
+  SECTION("at spaces") {
+    REQUIRE(wrap(db, "The quick brown fox jumps over the lazy dog", 10)
+            == "The quick\nbrown fox\njumps over\nthe lazy\ndog");
+    REQUIRE(wrap(db, "short", 10) == "short");
+    REQUIRE(wrap(db, "", 10) == "");
+  }
+
+  SECTION("at hard line breaks") {
+    REQUIRE(wrap(db, "a b\n\nc", 10) == "a b\n\nc");
+    REQUIRE(wrap(db, "a b\r\nc d", 10) == "a b\nc d");
+  }
+
+  SECTION("inside words that are too long") {
+    REQUIRE(wrap(db, "abcdefghij", 4) == "abcd\nefgh\nij");
+    REQUIRE(wrap(db, "ab abcdefgh", 4) == "ab\nabcd\nefgh");
+  }
+
+  SECTION("without splitting clusters") {
+    REQUIRE(wrap(db, u8"e\u0301e\u0301e\u0301", 2)
+            == u8"e\u0301e\u0301\ne\u0301");
+    REQUIRE(wrap(db, u8"\u4e00\u4e01\u4e02\u4e03\u4e04", 4)
+            == u8"\u4e00\u4e01\n\u4e02\u4e03\n\u4e04");
+  }
+
+  SECTION("with the iterator") {
+    std::string s("foo bar");
+    wrap_iterator it(db, s, 5);
+
+    REQUIRE(it.next() == 4);
+    REQUIRE(it.start() == 0);
+    REQUIRE(it.content_end() == 3);
+    REQUIRE(it.width() == 3);
+    REQUIRE(it.next() == 7);
+    REQUIRE(it.start() == 4);
+    REQUIRE(it.content_end() == 7);
+    REQUIRE(it.next() == wrap_iterator::npos);
+  }
+}
+
+TEST_CASE("we can truncate text to a given width", "[wrap]") {
+  database db;
+
+  db.open("ucd/packed/unicode-9.0.0.ucd");
+
+  size_t width;
+
+  REQUIRE(fit_to_width(db, std::string(u8"abc\u4e00"), 4, false, &width)
+          == 3);
+  REQUIRE(width == 3);
+  REQUIRE(fit_to_width(db, std::string(u8"abc\u4e00"), 5) == 6);
+
+  REQUIRE(truncate_to_width(db, "Hello", 8) == "Hello");
+  REQUIRE(truncate_to_width(db, "Hello, world", 8)
+          == u8"Hello, \u2026");
+  REQUIRE(truncate_to_width(db, "Hello, world", 8, "...") == "Hello...");
+  REQUIRE(truncate_to_width(db, u8"\u4e00\u4e01\u4e02", 4)
+          == u8"\u4e00\u2026");
+  REQUIRE(truncate_to_width(db, u8"e\u0301e\u0301e\u0301", 2)
+          == u8"e\u0301\u2026");
+  REQUIRE(truncate_to_width(db, "abc", 0) == "");
+}
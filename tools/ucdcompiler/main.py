@@ -17,9 +17,11 @@ import os.path
 import struct
 import re
 import operator
+import fractions
 
 from .rangeset import RangeSet
 from .sparsearray import SparseArray
+from .trie import Trie
 
 def fourcc(s):
     return struct.unpack(b'!I', s.encode('ascii'))[0]
@@ -79,6 +81,28 @@ UCD_insc = fourcc('insc')
 UCD_imcn = fourcc('imc$')
 UCD_iscn = fourcc('isc$')
 UCD_prmc = fourcc('prmc')
+UCD_CASt = fourcc('CAS#')
+UCD_cast = fourcc('cas#')
+UCD_Cast = fourcc('Cas#')
+UCD_csft = fourcc('csf#')
+UCD_cclo = fourcc('cclo')
+UCD_gcbt = fourcc('gcb#')
+UCD_wbkt = fourcc('wbk#')
+UCD_sbkt = fourcc('sbk#')
+UCD_lbkt = fourcc('lbk#')
+UCD_widt = fourcc('wid#')
+UCD_rtlt = fourcc('rtl#')
+UCD_jntt = fourcc('jnt#')
+UCD_dig0 = fourcc('dig0')
+UCD_numt = fourcc('num#')
+UCD_rsix = fourcc('rsix')
+UCD_aget = fourcc('age#')
+UCD_emjt = fourcc('emj#')
+UCD_emsq = fourcc('emsq')
+UCD_cnft = fourcc('cnf#')
+UCD_idnt = fourcc('idn#')
+UCD_hidt = fourcc('hid#')
+UCD_scst = fourcc('scs#')
 
 binprop_tables = [
     # Proplist
@@ -162,6 +186,35 @@ optional_binprops = set(['Emoji',
                          'Emoji_Modifier_Base',
                          'Prepended_Concatenation_Mark'])
 
+UCD_EMOJI                  = 0x01
+UCD_EMOJI_PRESENTATION     = 0x02
+UCD_EMOJI_MODIFIER         = 0x04
+UCD_EMOJI_MODIFIER_BASE    = 0x08
+
+UCD_IDENT_ID_START            = 0x01
+UCD_IDENT_ID_CONTINUE         = 0x02
+UCD_IDENT_XID_START           = 0x04
+UCD_IDENT_XID_CONTINUE        = 0x08
+UCD_IDENT_PATTERN_SYNTAX      = 0x10
+UCD_IDENT_PATTERN_WHITE_SPACE = 0x20
+
+UCD_HIDDEN_BIDI_CONTROL       = 0x01
+UCD_HIDDEN_DEFAULT_IGNORABLE  = 0x02
+UCD_HIDDEN_JOIN_CONTROL       = 0x04
+UCD_HIDDEN_VARIATION_SELECTOR = 0x08
+UCD_HIDDEN_NONCHARACTER       = 0x10
+UCD_HIDDEN_UNASSIGNED         = 0x20
+
+emoji_sequence_types = {
+    'Basic_Emoji': 1,
+    'Emoji_Combining_Sequence': 2,
+    'Emoji_Keycap_Sequence': 2,
+    'Emoji_Modifier_Sequence': 3,
+    'Emoji_Flag_Sequence': 4,
+    'Emoji_ZWJ_Sequence': 5,
+    'Emoji_Tag_Sequence': 6
+    }
+
 UCD_ALIS_KIND_CORRECTION   = 0x01
 UCD_ALIS_KIND_CONTROL      = 0x02
 UCD_ALIS_KIND_ALTERNATE    = 0x04
@@ -188,6 +241,8 @@ UCD_CASE_RANGE_SF_PACKED   = 0x0c000000
 UCD_CASE_RANGE_SF_EXTERNAL = 0x0d000000
 UCD_CASE_RANGE_EMPTY       = 0x0e000000
 
+UCD_CASE_EXCEPTION_HAS_SIMPLE = 0x100
+
 UCD_CCC_RANGE_TYPEMASK = 0xff000000
 UCD_CCC_RANGE_RUN      = 0x00000000
 UCD_CCC_RANGE_INLINE   = 0x01000000
@@ -927,6 +982,60 @@ def gen_case_table(mapping, debug=False):
 
     return b''.join(fixed_ranges + data)
 
+def gen_case_trie(mapping):
+    """Generate a case mapping trie from a sparse array.  Each value is
+    either twice the delta from the code point to its mapping, or, with the
+    bottom bit set, the index of an exception holding the mapping."""
+    trie = Trie(16)
+    exceptions = []
+    exception_index = {}
+    for cp,mapped in mapping.items():
+        simple = None
+        full = mapped
+        if isinstance(mapped, tuple):
+            simple, full = mapped
+        if isinstance(full, (int, long)):
+            full = [full]
+        if simple is not None and len(full) == 1 and full[0] == simple:
+            simple = None
+
+        if simple is None and len(full) == 1:
+            delta = full[0] - cp
+            if delta >= -16384 and delta < 16384:
+                trie[cp] = (delta * 2) & 0xffff
+                continue
+
+        if len(full) > 0xff:
+            raise ValueError('case mapping for U+%04X is too long' % cp)
+
+        key = (simple, tuple(full))
+        ndx = exception_index.get(key, None)
+        if ndx is None:
+            ndx = len(exceptions)
+            if ndx >= 0x8000:
+                raise ValueError('too many case mapping exceptions')
+            exception_index[key] = ndx
+            if simple is None:
+                exceptions.append([len(full)] + full)
+            else:
+                exceptions.append([len(full) | UCD_CASE_EXCEPTION_HAS_SIMPLE,
+                                   simple] + full)
+        trie[cp] = (ndx << 1) | 1
+
+    trie_tab = trie.as_table()
+    exceptions_offset = 8 + len(trie_tab)
+    offsets = []
+    data = []
+    data_offset = exceptions_offset + 4 * len(exceptions)
+    for exc in exceptions:
+        offsets.append(data_offset + 4 * len(data))
+        data.extend(exc)
+
+    return b''.join([struct.pack(b'=II', len(exceptions), exceptions_offset),
+                     trie_tab,
+                     struct.pack(b'=%dI' % len(offsets), *offsets),
+                     struct.pack(b'=%dI' % len(data), *data)])
+
 def gen_ccc_table(mapping):
     """Generate the Canonical Combining Class table from a sparse array."""
     ranges = []
@@ -1100,6 +1209,128 @@ def gen_numb_table(numeric):
 
     return b''.join([struct.pack(b'=I', len(entries))] + entries)
 
+def gen_dig0_table(numeric):
+    """Generate the dig0 table, which lists the zero digit of each run of
+    ten Numeric_Type=Decimal digits, so that the value of a digit is just
+    its distance from the zero before it."""
+    zeroes = [cp for cp, v in numeric.items()
+              if v[0] == UCD_NUMERIC_TYPE_DECIMAL and v[1] == '0']
+
+    return b''.join([struct.pack(b'=I', len(zeroes))]
+                    + [struct.pack(b'=I', cp) for cp in zeroes])
+
+def gen_numeric_trie(numeric):
+    """Generate the numeric value trie, which maps each code point with a
+    numeric value to an entry holding that value as a double and as a
+    fraction in lowest terms, so that the library never has to compute
+    them at run time.  Entry 0 means no value."""
+    trie = Trie(16)
+    values = []
+    value_index = {}
+    for cp, v in numeric.items():
+        value = fractions.Fraction(v[1])
+        ndx = value_index.get(value, None)
+        if ndx is None:
+            ndx = len(values) + 1
+            if ndx >= 0x10000:
+                raise ValueError('too many distinct numeric values')
+            value_index[value] = ndx
+            values.append(value)
+        trie[cp] = ndx
+
+    trie_tab = trie.as_table()
+    return b''.join([struct.pack(b'=II', len(values), 8 + len(trie_tab)),
+                     trie_tab]
+                    + [struct.pack(b'=dqq', float(v),
+                                   v.numerator, v.denominator)
+                       for v in values])
+
+def gen_emoji_trie(binprops):
+    """Generate the 4-bit emoji trie, which holds the Emoji,
+    Emoji_Presentation, Emoji_Modifier and Emoji_Modifier_Base properties
+    for each code point, so they can be had with a single lookup."""
+    trie = Trie(4)
+    for prop, bit in (('Emoji', UCD_EMOJI),
+                      ('Emoji_Presentation', UCD_EMOJI_PRESENTATION),
+                      ('Emoji_Modifier', UCD_EMOJI_MODIFIER),
+                      ('Emoji_Modifier_Base', UCD_EMOJI_MODIFIER_BASE)):
+        if prop in binprops:
+            for cp, v in binprops[prop].items():
+                trie[cp] = trie[cp] | bit
+    return trie.as_table()
+
+def gen_ident_trie(binprops):
+    """Generate the 8-bit identifier trie, which holds ID_Start,
+    ID_Continue, their NFKC-closed counterparts XID_Start and XID_Continue,
+    Pattern_Syntax and Pattern_White_Space for each code point, so that
+    lexers need only one lookup per code point."""
+    trie = Trie(8)
+    for prop, bit in (('ID_Start', UCD_IDENT_ID_START),
+                      ('ID_Continue', UCD_IDENT_ID_CONTINUE),
+                      ('XID_Start', UCD_IDENT_XID_START),
+                      ('XID_Continue', UCD_IDENT_XID_CONTINUE),
+                      ('Pattern_Syntax', UCD_IDENT_PATTERN_SYNTAX),
+                      ('Pattern_White_Space', UCD_IDENT_PATTERN_WHITE_SPACE)):
+        for cp, v in binprops[prop].items():
+            trie[cp] = trie[cp] | bit
+    return trie.as_table()
+
+def gen_hidden_trie(catranges, binprops):
+    """Generate the 8-bit hidden character trie, which holds Bidi_Control,
+    Default_Ignorable_Code_Point, Join_Control, Variation_Selector and
+    Noncharacter_Code_Point, and whether the code point is unassigned, so
+    that text can be checked for all of them with one lookup."""
+    trie = Trie(8)
+
+    for n, (first, category) in enumerate(catranges[:-1]):
+        if category == 'Cn':
+            trie.set_range(first, catranges[n + 1][0] - 1,
+                           UCD_HIDDEN_UNASSIGNED)
+
+    # The last range runs to the end of the code space
+    trie.set_range(catranges[-1][0], 0x10ffff, UCD_HIDDEN_UNASSIGNED)
+
+    for prop, bit in (('Bidi_Control', UCD_HIDDEN_BIDI_CONTROL),
+                      ('Default_Ignorable_Code_Point',
+                       UCD_HIDDEN_DEFAULT_IGNORABLE),
+                      ('Join_Control', UCD_HIDDEN_JOIN_CONTROL),
+                      ('Variation_Selector', UCD_HIDDEN_VARIATION_SELECTOR),
+                      ('Noncharacter_Code_Point', UCD_HIDDEN_NONCHARACTER)):
+        for cp, v in binprops[prop].items():
+            trie[cp] = trie[cp] | bit
+    return trie.as_table()
+
+def gen_emoji_sequence_table(sequences):
+    """Generate the emoji sequence table, which holds the sequences from
+    emoji-sequences.txt and emoji-zwj-sequences.txt as a trie of code
+    points, i.e. an automaton that recognises them.  Each node gives the
+    type of the sequence that ends there (or zero) and a run of edges,
+    sorted by code point, each of which gives the next node."""
+    nodes = [[{}, 0]]
+    for cps, stype in sequences:
+        node = 0
+        for cp in cps:
+            edges = nodes[node][0]
+            next_node = edges.get(cp, None)
+            if next_node is None:
+                next_node = len(nodes)
+                edges[cp] = next_node
+                nodes.append([{}, 0])
+            node = next_node
+        nodes[node][1] = stype
+
+    node_entries = []
+    edge_entries = []
+    for edges, stype in nodes:
+        node_entries.append(struct.pack(b'=IHBB', len(edge_entries),
+                                        len(edges), stype, 0))
+        for cp in sorted(edges.keys()):
+            edge_entries.append(struct.pack(b'=II', cp, edges[cp]))
+
+    return b''.join([struct.pack(b'=II', len(nodes), 8 + 8 * len(nodes))]
+                    + node_entries
+                    + edge_entries)
+
 def gen_bidi_table(bidiclass):
     "Generate the bidi table, which holds information for the Bidi algorithm."
     entries = [(0, 'L')]
@@ -1189,6 +1420,39 @@ def gen_prmc_table(primc):
 
     return b''.join([struct.pack(b'=I', len(prmc_entries))] + prmc_entries)
 
+def gen_cclo_table(foldcase):
+    """Generate the case closure table, which inverts the simple case
+    folding mapping."""
+    classes = {}
+    for cp,mapped in foldcase.items():
+        if isinstance(mapped, tuple):
+            simple = mapped[0]
+        elif isinstance(mapped, list):
+            # Only a full folding, so the simple folding is the identity
+            continue
+        else:
+            simple = mapped
+        if simple == cp:
+            continue
+        classes.setdefault(simple, set([simple])).add(cp)
+
+    entries = []
+    data = []
+    for fold in sorted(classes):
+        members = sorted(classes[fold])
+        offset = len(data)
+        data.append(len(members))
+        data.extend(members)
+        for cp in members:
+            entries.append((cp, offset))
+    entries.sort()
+
+    data_offset = 4 + 8 * len(entries)
+    return b''.join([struct.pack(b'=I', len(entries))]
+                    + [struct.pack(b'=II', cp, data_offset + 4 * offset)
+                       for cp, offset in entries]
+                    + [struct.pack(b'=%dI' % len(data), *data)])
+
 def gen_mirr_table(bidimirr, bidimglyph):
     entries = []
     for cp,f in bidimirr.items():
@@ -1242,6 +1506,51 @@ def gen_age_table(versions, ages):
                     + [struct.pack(b'=I', len(entries))]
                     + entries)
 
+def gen_age_trie(versions, ages):
+    """Generate the age trie, which maps each code point to one more than
+    the index of its Age in the (sorted) list of versions in the age table,
+    or zero if it is unassigned, so that comparing ages is comparing
+    numbers."""
+    versions = sorted(versions)
+    vers_ndx = dict((vers, ndx + 1) for ndx, vers in enumerate(versions))
+    trie = Trie(8)
+    for cp, vers in ages.items():
+        trie[cp] = vers_ndx[vers]
+    return trie.as_table()
+
+def gen_confusables_trie(confusables):
+    """Generate the confusables trie, which maps each code point that has
+    an entry in confusables.txt to one more than the index of its prototype
+    in an array of offsets, or zero if it is its own prototype.  Each offset
+    (from the start of the table) points at a 32-bit length followed by the
+    code points of the prototype.  Identical prototypes are shared."""
+    trie = Trie(16)
+    prototypes = []
+    proto_ndx = {}
+    for cp, target in sorted(confusables.items()):
+        target = tuple(target)
+        ndx = proto_ndx.get(target, None)
+        if ndx is None:
+            prototypes.append(target)
+            ndx = len(prototypes)
+            proto_ndx[target] = ndx
+        trie[cp] = ndx
+    trie_tab = trie.as_table()
+
+    offsets_offset = 8 + len(trie_tab)
+    data_offset = offsets_offset + 4 * len(prototypes)
+    offsets = []
+    data = []
+    for target in prototypes:
+        offsets.append(data_offset + 4 * len(data))
+        data.append(len(target))
+        data.extend(target)
+
+    return b''.join([struct.pack(b'=II', len(prototypes), offsets_offset),
+                     trie_tab]
+                    + [struct.pack(b'=I', ofs) for ofs in offsets]
+                    + [struct.pack(b'=I', cp) for cp in data])
+
 def gen_script_table(scripts, scriptexts):
     entries = []
     prev_cp = -1
@@ -1255,7 +1564,9 @@ def gen_script_table(scripts, scriptexts):
             prev_script = script
         prev_cp = cp
 
-    # Add the sentinel
+    # Close the last run, then add the sentinel
+    if prev_cp < 0x10ffff:
+        entries.append(struct.pack(b'=II', (prev_cp + 1), fourcc('Zzzz')))
     entries.append(struct.pack(b'=II', 0x00110000, fourcc('Zzzz')))
 
     extentries = []
@@ -1277,7 +1588,9 @@ def gen_script_table(scripts, scriptexts):
             prev_scripts = scripts
         prev_cp = cp
 
-    # Add the sentinel
+    # Close the last run, then add the sentinel
+    if prev_cp < 0x10ffff:
+        extentries.append(struct.pack(b'=II', (prev_cp + 1), 0))
     extentries.append(struct.pack(b'=II', 0x00110000, 0))
 
     # Fix-up the data offsets
@@ -1294,6 +1607,40 @@ def gen_script_table(scripts, scriptexts):
                     + fixed_entries
                     + extdata)
 
+def gen_script_set_trie(scripts, scriptexts):
+    """Generate the script set trie, which maps each code point to the index
+    of its Script_Extensions (or, if it has none, its Script) in a list of
+    the distinct sets of scripts, so that the library need only turn each
+    set into a bitmap once.  The list starts at sets_offset (from the start
+    of the table); each set is a 32-bit count followed by that many scripts.
+    Set zero is Zzzz, which is what unassigned code points get."""
+    sets = [('Zzzz',)]
+    set_ndx = { ('Zzzz',): 0 }
+
+    def ndx_of(key):
+        ndx = set_ndx.get(key, None)
+        if ndx is None:
+            ndx = len(sets)
+            sets.append(key)
+            set_ndx[key] = ndx
+        return ndx
+
+    trie = Trie(16)
+    for cp, script in scripts.items():
+        trie[cp] = ndx_of((script,))
+    for cp, exts in scriptexts.items():
+        trie[cp] = ndx_of(tuple(exts))
+    trie_tab = trie.as_table()
+
+    data = []
+    for key in sets:
+        data.append(len(key))
+        data.extend([fourcc(s) for s in key])
+
+    return b''.join([struct.pack(b'=II', len(sets), 8 + len(trie_tab)),
+                     trie_tab]
+                    + [struct.pack(b'=I', v) for v in data])
+
 def gen_value_name_table(valtype, forward, reverse):
     """Generate a value name table."""
     fmt = b'=' + valtype + b'I'
@@ -1350,6 +1697,22 @@ def gen_join_table(joining):
     return b''.join([struct.pack(b'=I', len(joining)),
                      data])
 
+def gen_joining_trie(catranges, joining):
+    """Generate a 4-bit trie holding the Joining_Type of every code point,
+    including the ones ArabicShaping.txt leaves out, which are Transparent
+    if they're Mn, Me or Cf and Non_Joining otherwise."""
+    trie = Trie(4, UCD_JOIN_TYPE_NON_JOINING)
+
+    for n, (first, category) in enumerate(catranges[:-1]):
+        if category in ('Mn', 'Me', 'Cf'):
+            trie.set_range(first, catranges[n + 1][0] - 1,
+                           UCD_JOIN_TYPE_TRANSPARENT)
+
+    for cp, jtype, jgroup in joining:
+        trie[cp] = jtype
+
+    return trie.as_table()
+
 def gen_category_table(breaking):
     entries = []
     prev_brk = None
@@ -1369,6 +1732,14 @@ def gen_category_table(breaking):
     return b''.join([struct.pack(b'=I', len(entries))]
                     + entries)
 
+def gen_break_trie(breaking):
+    """Generate an 8-bit trie from a sparse array of break property values,
+    for the segmentation iterators."""
+    trie = Trie(8)
+    for cp, brk in breaking.items():
+        trie[cp] = brk
+    return trie.as_table()
+
 def gen_eaw_table(eawidth):
     entries = []
     prev_eaw = None
@@ -1388,6 +1759,51 @@ def gen_eaw_table(eawidth):
     return b''.join([struct.pack(b'=I', len(entries))]
                     + entries)
 
+def gen_width_trie(catranges, eawidth, binprops):
+    """Generate the 2-bit display width trie.  Each code point is zero
+    width (0), narrow (1), wide (2) or ambiguous (3); ambiguous characters
+    are narrow unless the caller asks for East Asian widths."""
+    trie = Trie(2, 1)
+
+    # East_Asian_Width, plus Emoji_Presentation characters, which are
+    # displayed as wide whatever their East_Asian_Width says
+    for cp, eaw in eawidth.items():
+        if eaw == eaw_map['W'] or eaw == eaw_map['F']:
+            trie[cp] = 2
+        elif eaw == eaw_map['A']:
+            trie[cp] = 3
+
+    if 'Emoji_Presentation' in binprops:
+        for cp, v in binprops['Emoji_Presentation'].items():
+            trie[cp] = 2
+
+    # Marks, format and control characters, and line and paragraph
+    # separators take up no space
+    for n, (first, category) in enumerate(catranges[:-1]):
+        if category in ('Mn', 'Me', 'Cf', 'Cc', 'Zl', 'Zp'):
+            trie.set_range(first, catranges[n + 1][0] - 1, 0)
+
+    for cp, v in binprops['Default_Ignorable_Code_Point'].items():
+        trie[cp] = 0
+
+    # Hangul medial vowels and final consonants join the preceding
+    # initial consonant, which is wide
+    trie.set_range(0x1160, 0x11ff, 0)
+    trie.set_range(0xd7b0, 0xd7ff, 0)
+
+    return trie.as_table()
+
+def gen_rtl_trie(bidiclass):
+    """Generate a 1-bit trie marking the code points whose presence means
+    text needs the Bidi algorithm: strong right-to-left characters, Arabic
+    numbers and the explicit embedding, override and isolate controls."""
+    trie = Trie(1)
+    for cp, c in bidiclass.items():
+        if c in ('R', 'AL', 'AN', 'LRE', 'RLE', 'LRO', 'RLO', 'PDF',
+                 'LRI', 'RLI', 'FSI', 'PDI'):
+            trie[cp] = 1
+    return trie.as_table()
+
 def gen_rs_table(radstroke):
     """Generate the Unicode Radical Stroke data."""
     def flag(s):
@@ -1411,6 +1827,27 @@ def gen_rs_table(radstroke):
                     + ranges
                     + entries)
 
+def gen_rsix_table(radstroke):
+    """Generate the radical-stroke index, which lists the code points with
+    each Unicode_Radical_Stroke value.  The entries are sorted by radical,
+    then simplified flag, then residual strokes, and each points at a run
+    of code points in code point order."""
+    groups = {}
+    for cp, rs in radstroke.items():
+        groups.setdefault(rs, []).append(cp)
+
+    entries = []
+    cps = []
+    for rs in sorted(groups.keys()):
+        radical, simp, add = rs
+        entries.append(struct.pack(b'=BBbBII', radical, int(simp), add, 0,
+                                   len(cps), len(groups[rs])))
+        cps.extend(sorted(groups[rs]))
+
+    return b''.join([struct.pack(b'=II', len(entries), 8 + 12 * len(entries))]
+                    + entries
+                    + [struct.pack(b'=%dI' % len(cps), *cps)])
+
 class SimpleRange (object):
     def __init__(self, first=0, last=0):
         self.first = first
@@ -2337,11 +2774,64 @@ def build_data(version, ucd_path, emoji_version, emoji_path, output_path):
                 radstroke[cp] = (base, simp, add)
 
     # If we have Emoji data, parse that also
+    emoji_sequences = []
     if emoji_path:
         with open(os.path.join(emoji_path, 'emoji-data.txt'), 'r') as emdata:
             do_binprops(emdata)
+
+        # The sequence files are newer than emoji-data.txt
+        for fname in ('emoji-sequences.txt', 'emoji-zwj-sequences.txt'):
+            seqpath = os.path.join(emoji_path, fname)
+            if not os.path.exists(seqpath):
+                continue
+
+            with open(seqpath, 'r') as seqdata:
+                for line in seqdata:
+                    line = line.decode('utf-8')
+                    line = line.split('#', 1)[0].strip()
+                    if not line:
+                        continue
+
+                    fields = [f.strip() for f in line.split(';')]
+
+                    if len(fields) < 2:
+                        continue
+
+                    stype = emoji_sequence_types.get(fields[1], None)
+                    if stype is None:
+                        continue
+
+                    m = range_re.match(fields[0])
+                    if m:
+                        rstart = int(m.group(1), 16)
+                        rend = int(m.group(2), 16)
+                        for cp in range(rstart, rend + 1):
+                            emoji_sequences.append(([cp], stype))
+                    else:
+                        cps = [int(cp, 16) for cp in fields[0].split()]
+                        emoji_sequences.append((cps, stype))
     else:
         emoji_version=(0,0)
+
+    # confusables.txt is part of the UTS #39 security data rather than the
+    # UCD proper, so it's optional
+    confusables = {}
+    cnfpath = os.path.join(ucd_path, 'confusables.txt')
+    if os.path.exists(cnfpath):
+        with open(cnfpath, 'r') as cnfdata:
+            for line in cnfdata:
+                line = line.decode('utf-8').lstrip(u'\ufeff')
+                line = line.split('#', 1)[0].strip()
+                if not line:
+                    continue
+
+                fields = [f.strip() for f in line.split(';')]
+
+                if len(fields) < 2:
+                    continue
+
+                cp = int(fields[0], 16)
+                confusables[cp] = [int(t, 16) for t in fields[1].split()]
     
     # Generate primary composites
     primc = SparseArray()
@@ -2402,12 +2892,19 @@ def build_data(version, ucd_path, emoji_version, emoji_path, output_path):
     ucase_tab = gen_case_table(ucase)
     lcase_tab = gen_case_table(lcase)
     tcase_tab = gen_case_table(tcase)
+    ucase_trie = gen_case_trie(ucase)
+    lcase_trie = gen_case_trie(lcase)
+    tcase_trie = gen_case_trie(tcase)
 
     csef_tab = gen_case_table(foldcase)
+    csef_trie = gen_case_trie(foldcase)
+    cclo_tab = gen_cclo_table(foldcase)
     nfkc_cf_tab = gen_case_table(nfkc_fc)
     nfkc_clo_tab = gen_case_table(nfkc_closure)
     
     numb_tab = gen_numb_table(numeric)
+    dig0_tab = gen_dig0_table(numeric)
+    numt_tab = gen_numeric_trie(numeric)
     
     ccc_tab = gen_ccc_table(ccc)
     strings_tab = strings.as_table()
@@ -2417,7 +2914,9 @@ def build_data(version, ucd_path, emoji_version, emoji_path, output_path):
     mirr_tab = gen_mirr_table(bidimirr, bidimglyph)
     brak_tab = gen_brak_table(brakdata)
     age_tab = gen_age_table(versions, ages)
+    aget_tab = gen_age_trie(versions, ages)
     scpt_tab = gen_script_table(scripts, scriptexts)
+    scst_tab = gen_script_set_trie(scripts, scriptexts)
     
     cqc_tab = gen_qc_table(cqc)
     kcqc_tab = gen_qc_table(kcqc)
@@ -2425,13 +2924,26 @@ def build_data(version, ucd_path, emoji_version, emoji_path, output_path):
     kdqc_tab = gen_qc_table(kdqc)
 
     join_tab = gen_join_table(joining)
+    jntt_tab = gen_joining_trie(catranges, joining)
     lbrk_tab = gen_category_table(linebreak)
+    lbkt_tab = gen_break_trie(linebreak)
     gbrk_tab = gen_category_table(gcbreak)
+    gcbt_tab = gen_break_trie(gcbreak)
     sbrk_tab = gen_category_table(sbreak)
+    sbkt_tab = gen_break_trie(sbreak)
     wbrk_tab = gen_category_table(wbreak)
+    wbkt_tab = gen_break_trie(wbreak)
 
     eaw_tab = gen_eaw_table(eawidth)
+    widt_tab = gen_width_trie(catranges, eawidth, binprops)
+    rtlt_tab = gen_rtl_trie(bidiclass)
+    emjt_tab = gen_emoji_trie(binprops)
+    emsq_tab = gen_emoji_sequence_table(emoji_sequences)
+    cnft_tab = gen_confusables_trie(confusables)
+    idnt_tab = gen_ident_trie(binprops)
+    hidt_tab = gen_hidden_trie(catranges, binprops)
     rads_tab = gen_rs_table(radstroke)
+    rsix_tab = gen_rsix_table(radstroke)
 
     inmc_tab = gen_category_table(inmcat)
     insc_tab = gen_category_table(inscat)
@@ -2490,6 +3002,28 @@ def build_data(version, ucd_path, emoji_version, emoji_path, output_path):
         (UCD_insc, len(insc_tab)),
         (UCD_iscn, len(iscn_tab)),
         (UCD_prmc, len(prmc_tab)),
+        (UCD_CASt, len(ucase_trie)),
+        (UCD_cast, len(lcase_trie)),
+        (UCD_Cast, len(tcase_trie)),
+        (UCD_csft, len(csef_trie)),
+        (UCD_cclo, len(cclo_tab)),
+        (UCD_gcbt, len(gcbt_tab)),
+        (UCD_wbkt, len(wbkt_tab)),
+        (UCD_sbkt, len(sbkt_tab)),
+        (UCD_lbkt, len(lbkt_tab)),
+        (UCD_widt, len(widt_tab)),
+        (UCD_rtlt, len(rtlt_tab)),
+        (UCD_jntt, len(jntt_tab)),
+        (UCD_dig0, len(dig0_tab)),
+        (UCD_numt, len(numt_tab)),
+        (UCD_rsix, len(rsix_tab)),
+        (UCD_aget, len(aget_tab)),
+        (UCD_emjt, len(emjt_tab)),
+        (UCD_emsq, len(emsq_tab)),
+        (UCD_cnft, len(cnft_tab)),
+        (UCD_idnt, len(idnt_tab)),
+        (UCD_hidt, len(hidt_tab)),
+        (UCD_scst, len(scst_tab)),
         ]
 
     extra_tables = []
@@ -2639,6 +3173,58 @@ def build_data(version, ucd_path, emoji_version, emoji_path, output_path):
         # Primary Composition table
         out.write(prmc_tab)
 
+        # Write the case tries
+        out.write(ucase_trie)
+        out.write(lcase_trie)
+        out.write(tcase_trie)
+        out.write(csef_trie)
+
+        # Write the case closure table
+        out.write(cclo_tab)
+
+        # Write the break property tries
+        out.write(gcbt_tab)
+        out.write(wbkt_tab)
+        out.write(sbkt_tab)
+        out.write(lbkt_tab)
+
+        # Write the display width trie
+        out.write(widt_tab)
+
+        # Write the bidi pre-scan trie
+        out.write(rtlt_tab)
+
+        # Write the joining type trie
+        out.write(jntt_tab)
+
+        # Write the decimal digit zeroes
+        out.write(dig0_tab)
+
+        # Write the numeric value trie
+        out.write(numt_tab)
+
+        # Write the radical-stroke index
+        out.write(rsix_tab)
+
+        # Write the age trie
+        out.write(aget_tab)
+
+        # Write the emoji trie and sequence table
+        out.write(emjt_tab)
+        out.write(emsq_tab)
+
+        # Write the confusables trie
+        out.write(cnft_tab)
+
+        # Write the identifier trie
+        out.write(idnt_tab)
+
+        # Write the hidden character trie
+        out.write(hidt_tab)
+
+        # Write the script set trie
+        out.write(scst_tab)
+
         # Write the binary property tables
         for tbl in extra_tables:
             out.write(tbl)
@@ -0,0 +1,84 @@
+import struct
+
+class Trie (object):
+    """Maps every code point to an unsigned value of a fixed width, and
+    generates the two-stage ucd_trie tables described in src/ucd-format.h."""
+
+    MAX_CP = 0x110000
+
+    def __init__(self, value_bits, default=0):
+        if value_bits not in (1, 2, 4, 8, 16, 32):
+            raise ValueError('bad trie value width %d' % value_bits)
+        self.value_bits = value_bits
+        self.default = default
+        self.values = [default] * self.MAX_CP
+
+    def __getitem__(self, cp):
+        return self.values[cp]
+
+    def __setitem__(self, cp, value):
+        if value < 0 or value >= (1 << self.value_bits):
+            raise ValueError('value %r for U+%04X does not fit in %d bits'
+                             % (value, cp, self.value_bits))
+        self.values[cp] = value
+
+    def set_range(self, first, last, value):
+        for cp in range(first, last + 1):
+            self[cp] = value
+
+    def _blocks(self, shift):
+        size = 1 << shift
+        blocks = {}
+        index = []
+        data = []
+        for base in range(0, self.MAX_CP, size):
+            block = tuple(self.values[base:base + size])
+            ndx = blocks.get(block, None)
+            if ndx is None:
+                ndx = len(blocks)
+                blocks[block] = ndx
+                data.extend(block)
+            index.append(ndx)
+        return (index, data)
+
+    def _pack_data(self, data):
+        bits = self.value_bits
+        if bits == 8:
+            return struct.pack(b'=%dB' % len(data), *data)
+        elif bits == 16:
+            return struct.pack(b'=%dH' % len(data), *data)
+        elif bits == 32:
+            return struct.pack(b'=%dI' % len(data), *data)
+
+        packed = bytearray((len(data) * bits + 7) // 8)
+        for n, v in enumerate(data):
+            bitpos = n * bits
+            packed[bitpos >> 3] |= v << (bitpos & 7)
+        return bytes(packed)
+
+    def as_table(self):
+        best = None
+        for shift in range(5, 9):
+            index, data = self._blocks(shift)
+            if len(index) and max(index) > 0xffff:
+                continue
+            size = 2 * len(index) + (len(data) * self.value_bits + 7) // 8
+            if best is None or size < best[0]:
+                best = (size, shift, index, data)
+
+        size, shift, index, data = best
+
+        # Keep the data aligned relative to the start of the trie
+        data_offset = 12 + 2 * len(index)
+        pad = (-data_offset) & 3
+        data_offset += pad
+
+        packed = self._pack_data(data)
+        tail_pad = (-len(packed)) & 3
+
+        return b''.join([struct.pack(b'=BBHII', self.value_bits, shift, 0,
+                                     self.default, data_offset),
+                         struct.pack(b'=%dH' % len(index), *index),
+                         b'\0' * pad,
+                         packed,
+                         b'\0' * tail_pad])